@@ -0,0 +1,171 @@
+#include "AirportIndex.h"
+#include "../CEXCDSBridge.h"
+#include "../Diagnostics/Metrics.h"
+#include "../Diagnostics/Profiler.h"
+
+bool AirportActivity::operator==(const AirportActivity& other) const
+{
+	return departure == other.departure
+		&& arrival == other.arrival
+		&& departureRunways == other.departureRunways
+		&& arrivalRunways == other.arrivalRunways;
+}
+
+AirportIndex* AirportIndex::GetInstance()
+{
+	static AirportIndex index;
+	return &index;
+}
+
+void AirportIndex::EnsureLoaded()
+{
+	EuroScopePlugIn::CController me = CEXCDSBridge::GetInstance()->ControllerMyself();
+	std::string sectorFile = me.IsValid() ? me.GetSectorFileName() : "";
+
+	// Nothing to read until EuroScope has a sector file
+	if (sectorFile.empty()) return;
+
+	{
+		std::lock_guard<std::mutex> guard(_lock);
+		if (sectorFile == _sectorFile) return;
+		_sectorFile = sectorFile;
+	}
+
+	Rebuild();
+}
+
+void AirportIndex::Rebuild()
+{
+	PROFILE_ZONE("AirportIndex.Rebuild");
+	static MetricCounter& rebuilds = Metrics::GetInstance()->Counter("airports.rebuilds");
+	rebuilds.Increment();
+
+	CEXCDSBridge* bridgeInstance = CEXCDSBridge::GetInstance();
+	std::unordered_map<std::string, AirportActivity> active;
+
+	for (EuroScopePlugIn::CSectorElement airport = bridgeInstance->SectorFileElementSelectFirst(EuroScopePlugIn::SECTOR_ELEMENT_AIRPORT);
+		airport.IsValid();
+		airport = bridgeInstance->SectorFileElementSelectNext(airport, EuroScopePlugIn::SECTOR_ELEMENT_AIRPORT))
+	{
+		// Check if the element is used as a departure (true) or arrival (false)
+		bool departure = airport.IsElementActive(true);
+		bool arrival = airport.IsElementActive(false);
+		if (!departure && !arrival) continue;
+
+		AirportActivity& activity = active[airport.GetAirportName()];
+		activity.departure = departure;
+		activity.arrival = arrival;
+	}
+
+	for (EuroScopePlugIn::CSectorElement runway = bridgeInstance->SectorFileElementSelectFirst(EuroScopePlugIn::SECTOR_ELEMENT_RUNWAY);
+		runway.IsValid();
+		runway = bridgeInstance->SectorFileElementSelectNext(runway, EuroScopePlugIn::SECTOR_ELEMENT_RUNWAY))
+	{
+		// A runway element holds both of its ends
+		for (int end = 0; end < 2; end++)
+		{
+			bool departure = runway.IsElementActive(true, end);
+			bool arrival = runway.IsElementActive(false, end);
+			if (!departure && !arrival) continue;
+
+			AirportActivity& activity = active[runway.GetAirportName()];
+			if (departure)
+				activity.departureRunways.insert(runway.GetRunwayName(end));
+			if (arrival)
+				activity.arrivalRunways.insert(runway.GetRunwayName(end));
+		}
+	}
+
+	sio::message::ptr changed = sio::array_message::create();
+	sio::message::ptr inactive = sio::array_message::create();
+
+	{
+		std::lock_guard<std::mutex> guard(_lock);
+
+		for (const auto& airport : active)
+		{
+			auto previous = _active.find(airport.first);
+			if (previous == _active.end() || previous->second != airport.second)
+				changed->get_vector().push_back(ToMessage(airport.first, airport.second));
+		}
+
+		for (const auto& airport : _active)
+		{
+			if (active.find(airport.first) == active.end())
+				inactive->get_vector().push_back(sio::string_message::create(airport.first));
+		}
+
+		_active.swap(active);
+	}
+
+	if (changed->get_vector().empty() && inactive->get_vector().empty()) return;
+
+	sio::message::ptr delta = sio::object_message::create();
+	delta->get_map()["active"] = changed;
+	delta->get_map()["inactive"] = inactive;
+
+	CEXCDSBridge::Emit("AIRPORT_ACTIVITY_DELTA", delta);
+}
+
+bool AirportIndex::IsActive(const std::string& airport, bool departure)
+{
+	std::lock_guard<std::mutex> guard(_lock);
+
+	auto activity = _active.find(airport);
+	if (activity == _active.end()) return false;
+
+	return departure ? activity->second.departure : activity->second.arrival;
+}
+
+bool AirportIndex::IsRunwayActive(const std::string& airport, const std::string& runway, bool departure)
+{
+	std::lock_guard<std::mutex> guard(_lock);
+
+	auto activity = _active.find(airport);
+	if (activity == _active.end()) return false;
+
+	const std::set<std::string>& runways = departure ? activity->second.departureRunways : activity->second.arrivalRunways;
+	return runways.count(runway) != 0;
+}
+
+std::vector<std::string> AirportIndex::GetActiveRunways(const std::string& airport, bool departure)
+{
+	std::lock_guard<std::mutex> guard(_lock);
+
+	auto activity = _active.find(airport);
+	if (activity == _active.end()) return std::vector<std::string>();
+
+	const std::set<std::string>& runways = departure ? activity->second.departureRunways : activity->second.arrivalRunways;
+	return std::vector<std::string>(runways.begin(), runways.end());
+}
+
+sio::message::ptr AirportIndex::ToMessage()
+{
+	sio::message::ptr airports = sio::array_message::create();
+
+	std::lock_guard<std::mutex> guard(_lock);
+	for (const auto& airport : _active)
+		airports->get_vector().push_back(ToMessage(airport.first, airport.second));
+
+	return airports;
+}
+
+sio::message::ptr AirportIndex::ToMessage(const std::string& airport, const AirportActivity& activity)
+{
+	sio::message::ptr msg = sio::object_message::create();
+	sio::message::ptr departureRunways = sio::array_message::create();
+	sio::message::ptr arrivalRunways = sio::array_message::create();
+
+	for (const std::string& runway : activity.departureRunways)
+		departureRunways->get_vector().push_back(sio::string_message::create(runway));
+	for (const std::string& runway : activity.arrivalRunways)
+		arrivalRunways->get_vector().push_back(sio::string_message::create(runway));
+
+	msg->get_map()["airport"] = sio::string_message::create(airport);
+	msg->get_map()["departure"] = sio::bool_message::create(activity.departure);
+	msg->get_map()["arrival"] = sio::bool_message::create(activity.arrival);
+	msg->get_map()["departureRunways"] = departureRunways;
+	msg->get_map()["arrivalRunways"] = arrivalRunways;
+
+	return msg;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <sio_client.h>
+
+struct AirportActivity
+{
+    bool departure = false;
+    bool arrival = false;
+    std::set<std::string> departureRunways;
+    std::set<std::string> arrivalRunways;
+
+    bool operator==(const AirportActivity& other) const;
+    bool operator!=(const AirportActivity& other) const { return !(*this == other); }
+};
+
+/**
+* Which airports and runways are active, read from the sector file once and again only when the controller changes
+* runway activity. Lookups do not touch the sector file.
+*
+* Each rebuild sends what changed to EXCDS as AIRPORT_ACTIVITY_DELTA:
+*   { "active": [{ "airport", "departure", "arrival", "departureRunways": [...], "arrivalRunways": [...] }],
+*     "inactive": ["airport", ...] }
+* "active" only holds airports whose activity changed. The whole index is sent on request.
+*/
+class AirportIndex
+{
+public:
+    static AirportIndex* GetInstance();
+
+    /**
+    * Rebuilds the index the first time a sector file is known, and again when the controller changes it. Must be
+    * called on the EuroScope thread.
+    */
+    void EnsureLoaded();
+
+    /**
+    * Walks the sector file's airports and runways. Must be called on the EuroScope thread.
+    */
+    void Rebuild();
+
+    bool IsActive(const std::string& airport, bool departure);
+    bool IsRunwayActive(const std::string& airport, const std::string& runway, bool departure);
+    std::vector<std::string> GetActiveRunways(const std::string& airport, bool departure);
+
+    /**
+    * Every active airport, in the same form as the delta's "active".
+    */
+    sio::message::ptr ToMessage();
+private:
+    std::mutex _lock;
+    std::string _sectorFile;
+
+    // Only airports with something active are kept
+    std::unordered_map<std::string, AirportActivity> _active;
+
+    static sio::message::ptr ToMessage(const std::string& airport, const AirportActivity& activity);
+};
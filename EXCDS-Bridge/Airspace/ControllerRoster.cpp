@@ -0,0 +1,143 @@
+#include "ControllerRoster.h"
+#include "../CEXCDSBridge.h"
+#include "../Diagnostics/Metrics.h"
+
+ControllerRoster* ControllerRoster::GetInstance()
+{
+	static ControllerRoster roster;
+	return &roster;
+}
+
+void ControllerRoster::Update(EuroScopePlugIn::CController controller)
+{
+	std::string callsign = controller.GetCallsign();
+	if (callsign.empty()) return;
+
+	if (!controller.IsController() || controller.GetFacility() == 0)
+	{
+		Remove(callsign);
+		return;
+	}
+
+	RosterEntry entry;
+	entry.callsign = callsign;
+	entry.cjs = controller.GetPositionId();
+	entry.frequency = controller.GetPrimaryFrequency();
+	entry.facility = controller.GetFacility();
+
+	const char* change;
+
+	{
+		std::lock_guard<std::mutex> guard(_lock);
+
+		auto existing = _controllers.find(callsign);
+		if (existing == _controllers.end())
+			change = "JOIN";
+		else if (existing->second.cjs != entry.cjs || existing->second.frequency != entry.frequency || existing->second.facility != entry.facility)
+			change = "UPDATE";
+		else
+			return;
+
+		if (existing != _controllers.end())
+			UnindexPositionId(existing->second);
+
+		_controllers[callsign] = entry;
+
+		if (!entry.cjs.empty())
+			_byPositionId[entry.cjs] = callsign;
+	}
+
+	EmitDelta(change, entry);
+}
+
+void ControllerRoster::Remove(const std::string& callsign)
+{
+	RosterEntry entry;
+
+	{
+		std::lock_guard<std::mutex> guard(_lock);
+
+		auto existing = _controllers.find(callsign);
+		if (existing == _controllers.end()) return;
+
+		entry = existing->second;
+		UnindexPositionId(entry);
+		_controllers.erase(existing);
+	}
+
+	EmitDelta("LEAVE", entry);
+}
+
+bool ControllerRoster::Find(const std::string& callsign, RosterEntry& entry)
+{
+	std::lock_guard<std::mutex> guard(_lock);
+
+	auto existing = _controllers.find(callsign);
+	if (existing == _controllers.end()) return false;
+
+	entry = existing->second;
+	return true;
+}
+
+bool ControllerRoster::FindByPositionId(const std::string& positionId, RosterEntry& entry)
+{
+	std::lock_guard<std::mutex> guard(_lock);
+
+	auto callsign = _byPositionId.find(positionId);
+	if (callsign == _byPositionId.end()) return false;
+
+	auto existing = _controllers.find(callsign->second);
+	if (existing == _controllers.end()) return false;
+
+	entry = existing->second;
+	return true;
+}
+
+sio::message::ptr ControllerRoster::ToMessage()
+{
+	sio::message::ptr controllers = sio::array_message::create();
+
+	std::lock_guard<std::mutex> guard(_lock);
+	for (const auto& controller : _controllers)
+		controllers->get_vector().push_back(ToMessage(controller.second));
+
+	return controllers;
+}
+
+size_t ControllerRoster::GetSize()
+{
+	std::lock_guard<std::mutex> guard(_lock);
+	return _controllers.size();
+}
+
+/**
+* Must be called with the lock held. Leaves the position ID alone if another controller has taken it since.
+*/
+void ControllerRoster::UnindexPositionId(const RosterEntry& entry)
+{
+	auto indexed = _byPositionId.find(entry.cjs);
+	if (indexed != _byPositionId.end() && indexed->second == entry.callsign)
+		_byPositionId.erase(indexed);
+}
+
+sio::message::ptr ControllerRoster::ToMessage(const RosterEntry& entry)
+{
+	sio::message::ptr msg = sio::object_message::create();
+
+	msg->get_map()["callsign"] = sio::string_message::create(entry.callsign);
+	msg->get_map()["cjs"] = sio::string_message::create(entry.cjs);
+	msg->get_map()["frequency"] = sio::double_message::create(entry.frequency);
+	msg->get_map()["facility"] = sio::int_message::create(entry.facility);
+
+	return msg;
+}
+
+void ControllerRoster::EmitDelta(const char* change, const RosterEntry& entry)
+{
+	Metrics::GetInstance()->Counter(std::string("roster.") + change).Increment();
+
+	sio::message::ptr delta = ToMessage(entry);
+	delta->get_map()["change"] = sio::string_message::create(change);
+
+	CEXCDSBridge::Emit("CONTROLLER_DELTA", delta);
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <sio_client.h>
+
+#include "EuroScopePlugIn.h"
+
+struct RosterEntry
+{
+    std::string callsign;
+    std::string cjs;
+    double frequency = 0;
+    int facility = 0;
+};
+
+/**
+* The controllers EuroScope can see, kept up to date from the controller callbacks rather than walked every timer.
+*
+* Each change is sent to EXCDS as a CONTROLLER_DELTA as it happens:
+*   { "change": "JOIN" | "UPDATE" | "LEAVE", "callsign", "cjs", "frequency", "facility" }
+* UPDATE is only sent when the position, frequency or facility changed. The whole roster is sent on request.
+*
+* The roster is also looked up by callsign and position ID, so building a radar target or flight plan message does
+* not have to search EuroScope's controller list. It holds copies of the controller data, never EuroScope handles.
+*/
+class ControllerRoster
+{
+public:
+    static ControllerRoster* GetInstance();
+
+    /**
+    * Called from OnControllerPositionUpdate. Observers and ATIS are not controllers, and leave the roster if they were.
+    */
+    void Update(EuroScopePlugIn::CController controller);
+    void Remove(const std::string& callsign);
+
+    bool Find(const std::string& callsign, RosterEntry& entry);
+    bool FindByPositionId(const std::string& positionId, RosterEntry& entry);
+
+    /**
+    * Every controller on the roster, as an array in callsign order.
+    */
+    sio::message::ptr ToMessage();
+
+    size_t GetSize();
+private:
+    std::mutex _lock;
+    std::map<std::string, RosterEntry> _controllers;
+
+    // Position ID to callsign. Should two controllers share a position ID, the last one to update has it
+    std::unordered_map<std::string, std::string> _byPositionId;
+
+    void UnindexPositionId(const RosterEntry& entry);
+
+    static sio::message::ptr ToMessage(const RosterEntry& entry);
+    static void EmitDelta(const char* change, const RosterEntry& entry);
+};
@@ -0,0 +1,280 @@
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <Windows.h>
+
+#include "FixIndex.h"
+#include "../ApiHelper.h"
+#include "../CEXCDSBridge.h"
+#include "../Diagnostics/Metrics.h"
+#include "../Diagnostics/Profiler.h"
+
+static const char FIX_CACHE_MAGIC[8] = { 'E', 'X', 'C', 'D', 'S', 'F', 'I', 'X' };
+static const uint32_t FIX_CACHE_VERSION = 2;
+static const char* FIX_CACHE_FILE = "EXCDS-Bridge-fixes.bin";
+
+struct FixCacheHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t count;
+
+    // A sector file edited in place keeps its name, so its size and last write time tell the versions apart
+    uint64_t sectorFileSize;
+    uint64_t sectorFileWriteTime;
+    char sectorFile[MAX_PATH];
+};
+
+static const int INDEXED_ELEMENTS[] = {
+	EuroScopePlugIn::SECTOR_ELEMENT_FIX,
+	EuroScopePlugIn::SECTOR_ELEMENT_VOR,
+	EuroScopePlugIn::SECTOR_ELEMENT_NDB,
+	EuroScopePlugIn::SECTOR_ELEMENT_AIRPORT,
+};
+
+FixIndex* FixIndex::GetInstance()
+{
+	static FixIndex index;
+	return &index;
+}
+
+FixIndex::~FixIndex()
+{
+	Unmap();
+}
+
+void FixIndex::EnsureLoaded()
+{
+	EuroScopePlugIn::CController me = CEXCDSBridge::GetInstance()->ControllerMyself();
+	std::string sectorFile = me.IsValid() ? me.GetSectorFileName() : "";
+
+	// Nothing to load until EuroScope has a sector file
+	if (sectorFile.empty() || sectorFile.size() >= MAX_PATH) return;
+
+	std::lock_guard<std::mutex> guard(_lock);
+	if (sectorFile == _sectorFile) return;
+
+	PROFILE_ZONE("FixIndex.Load");
+
+	Unmap();
+	_scanned.clear();
+	_records = nullptr;
+	_count = 0;
+
+	std::string path = ApiHelper::GetPluginDirectory() + FIX_CACHE_FILE;
+	uint64_t sectorFileSize = 0;
+	uint64_t sectorFileWriteTime = 0;
+	bool stamped = StampSectorFile(sectorFile, sectorFileSize, sectorFileWriteTime);
+
+	if (stamped && MapCache(path, sectorFile, sectorFileSize, sectorFileWriteTime))
+	{
+		Metrics::GetInstance()->Counter("fixes.cache_hits").Increment();
+	}
+	else
+	{
+		Metrics::GetInstance()->Counter("fixes.scans").Increment();
+
+		Scan();
+
+		// The sector file may not be read in yet, so try again next time rather than caching nothing
+		if (_count == 0) return;
+
+		// Without a size and time to check it against, a cache could never be trusted
+		if (stamped)
+			WriteCache(path, sectorFile, sectorFileSize, sectorFileWriteTime);
+	}
+
+	_sectorFile = sectorFile;
+	BuildIndex();
+}
+
+bool FixIndex::IsLoaded()
+{
+	std::lock_guard<std::mutex> guard(_lock);
+	return !_sectorFile.empty();
+}
+
+bool FixIndex::Contains(const std::string& name)
+{
+	std::lock_guard<std::mutex> guard(_lock);
+	return _byName.find(name) != _byName.end();
+}
+
+bool FixIndex::Find(const std::string& name, EuroScopePlugIn::CPosition& position, const EuroScopePlugIn::CPosition* near)
+{
+	std::lock_guard<std::mutex> guard(_lock);
+
+	auto points = _byName.find(name);
+	if (points == _byName.end()) return false;
+
+	position = ToPosition(_records[points->second.front()]);
+	if (!near || points->second.size() == 1) return true;
+
+	double nearest = position.DistanceTo(*near);
+	for (size_t i = 1; i < points->second.size(); i++)
+	{
+		EuroScopePlugIn::CPosition candidate = ToPosition(_records[points->second[i]]);
+		double distance = candidate.DistanceTo(*near);
+
+		if (distance < nearest)
+		{
+			nearest = distance;
+			position = candidate;
+		}
+	}
+
+	return true;
+}
+
+size_t FixIndex::GetSize()
+{
+	std::lock_guard<std::mutex> guard(_lock);
+	return _count;
+}
+
+/**
+* The size and last write time of the sector file, false if it cannot be read.
+*/
+bool FixIndex::StampSectorFile(const std::string& sectorFile, uint64_t& size, uint64_t& writeTime)
+{
+	WIN32_FILE_ATTRIBUTE_DATA attributes;
+	if (!GetFileAttributesEx(sectorFile.c_str(), GetFileExInfoStandard, &attributes)) return false;
+
+	size = (static_cast<uint64_t>(attributes.nFileSizeHigh) << 32) | attributes.nFileSizeLow;
+	writeTime = (static_cast<uint64_t>(attributes.ftLastWriteTime.dwHighDateTime) << 32) | attributes.ftLastWriteTime.dwLowDateTime;
+	return true;
+}
+
+/**
+* Maps the cache file, if it was written for this version of the sector file and is not damaged.
+*/
+bool FixIndex::MapCache(const std::string& path, const std::string& sectorFile, uint64_t sectorFileSize, uint64_t sectorFileWriteTime)
+{
+	HANDLE file = CreateFile(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE) return false;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart < static_cast<LONGLONG>(sizeof(FixCacheHeader)))
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	HANDLE mapping = CreateFileMapping(file, NULL, PAGE_READONLY, 0, 0, NULL);
+
+	// The mapping keeps the file open
+	CloseHandle(file);
+	if (!mapping) return false;
+
+	const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!view)
+	{
+		CloseHandle(mapping);
+		return false;
+	}
+
+	_mappingHandle = mapping;
+	_mappedView = view;
+
+	const FixCacheHeader* header = static_cast<const FixCacheHeader*>(view);
+	bool valid = memcmp(header->magic, FIX_CACHE_MAGIC, sizeof(FIX_CACHE_MAGIC)) == 0
+		&& header->version == FIX_CACHE_VERSION
+		&& strncmp(header->sectorFile, sectorFile.c_str(), MAX_PATH) == 0
+		&& header->sectorFileSize == sectorFileSize
+		&& header->sectorFileWriteTime == sectorFileWriteTime
+		&& static_cast<uint64_t>(size.QuadPart) == sizeof(FixCacheHeader) + static_cast<uint64_t>(header->count) * sizeof(FixRecord);
+
+	if (!valid)
+	{
+		Unmap();
+		return false;
+	}
+
+	_records = reinterpret_cast<const FixRecord*>(header + 1);
+	_count = header->count;
+	return true;
+}
+
+void FixIndex::WriteCache(const std::string& path, const std::string& sectorFile, uint64_t sectorFileSize, uint64_t sectorFileWriteTime)
+{
+	FixCacheHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, FIX_CACHE_MAGIC, sizeof(FIX_CACHE_MAGIC));
+	header.version = FIX_CACHE_VERSION;
+	header.count = static_cast<uint32_t>(_count);
+	header.sectorFileSize = sectorFileSize;
+	header.sectorFileWriteTime = sectorFileWriteTime;
+	strncpy(header.sectorFile, sectorFile.c_str(), MAX_PATH - 1);
+
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+	{
+		Metrics::CountException("FixIndex", "EXCDS Error: Could not write the fix cache");
+		return;
+	}
+
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	if (_count > 0)
+		file.write(reinterpret_cast<const char*>(_records), _count * sizeof(FixRecord));
+}
+
+void FixIndex::Scan()
+{
+	CEXCDSBridge* bridgeInstance = CEXCDSBridge::GetInstance();
+
+	for (int elementType : INDEXED_ELEMENTS)
+	{
+		for (EuroScopePlugIn::CSectorElement element = bridgeInstance->SectorFileElementSelectFirst(elementType);
+			element.IsValid();
+			element = bridgeInstance->SectorFileElementSelectNext(element, elementType))
+		{
+			const char* name = element.GetName();
+			EuroScopePlugIn::CPosition position;
+
+			// Longer names are not something a route refers to
+			if (!name || strlen(name) == 0 || strlen(name) >= sizeof(FixRecord::name)) continue;
+			if (!element.GetPosition(&position, 0)) continue;
+
+			FixRecord record;
+			memset(&record, 0, sizeof(record));
+			strncpy(record.name, name, sizeof(record.name) - 1);
+			record.latitude = static_cast<int32_t>(std::lround(position.m_Latitude * 1e6));
+			record.longitude = static_cast<int32_t>(std::lround(position.m_Longitude * 1e6));
+			record.elementType = static_cast<uint8_t>(elementType);
+
+			_scanned.push_back(record);
+		}
+	}
+
+	_records = _scanned.data();
+	_count = _scanned.size();
+}
+
+void FixIndex::BuildIndex()
+{
+	_byName.clear();
+	_byName.reserve(_count);
+
+	for (uint32_t i = 0; i < _count; i++)
+		_byName[std::string(_records[i].name, strnlen(_records[i].name, sizeof(FixRecord::name)))].push_back(i);
+}
+
+void FixIndex::Unmap()
+{
+	if (_mappedView)
+		UnmapViewOfFile(_mappedView);
+	if (_mappingHandle)
+		CloseHandle(_mappingHandle);
+
+	_mappedView = nullptr;
+	_mappingHandle = nullptr;
+}
+
+EuroScopePlugIn::CPosition FixIndex::ToPosition(const FixRecord& record)
+{
+	EuroScopePlugIn::CPosition position;
+	position.m_Latitude = record.latitude / 1e6;
+	position.m_Longitude = record.longitude / 1e6;
+
+	return position;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "EuroScopePlugIn.h"
+
+/**
+* A named point from the sector file, as it is stored in the cache file. Coordinates are in millionths of a degree.
+*/
+struct FixRecord
+{
+    char name[12];
+    int32_t latitude;
+    int32_t longitude;
+    uint8_t elementType;
+    uint8_t reserved[3];
+};
+
+/**
+* Every fix, VOR, NDB and airport in the sector file, by name.
+*
+* Walking the sector file takes a while on a large one, so the points are written to EXCDS-Bridge-fixes.bin with the
+* name, size and last write time of the sector file they came from. When the same sector file is loaded again
+* unchanged, the cache file is mapped into memory and used as it is. Names are not unique across a sector file, so a lookup can be given a position to pick the
+* nearest of several points with the name.
+*/
+class FixIndex
+{
+public:
+    static FixIndex* GetInstance();
+
+    /**
+    * Loads the points for the sector file in use, if they are not loaded already. Must be called on the EuroScope
+    * thread, as it may walk the sector file.
+    */
+    void EnsureLoaded();
+
+    bool IsLoaded();
+    bool Contains(const std::string& name);
+
+    /**
+    * The position of the point with this name, nearest to `near` when there are several.
+    */
+    bool Find(const std::string& name, EuroScopePlugIn::CPosition& position, const EuroScopePlugIn::CPosition* near = nullptr);
+
+    size_t GetSize();
+
+    ~FixIndex();
+private:
+    std::mutex _lock;
+    std::string _sectorFile;
+
+    // Points into the mapped cache file, or into _scanned when the sector file was walked
+    const FixRecord* _records = nullptr;
+    size_t _count = 0;
+    std::vector<FixRecord> _scanned;
+
+    std::unordered_map<std::string, std::vector<uint32_t>> _byName;
+
+    void* _mappingHandle = nullptr;
+    const void* _mappedView = nullptr;
+
+    bool MapCache(const std::string& path, const std::string& sectorFile, uint64_t sectorFileSize, uint64_t sectorFileWriteTime);
+    void WriteCache(const std::string& path, const std::string& sectorFile, uint64_t sectorFileSize, uint64_t sectorFileWriteTime);
+    void Scan();
+    void BuildIndex();
+    void Unmap();
+
+    static bool StampSectorFile(const std::string& sectorFile, uint64_t& size, uint64_t& writeTime);
+    static EuroScopePlugIn::CPosition ToPosition(const FixRecord& record);
+};
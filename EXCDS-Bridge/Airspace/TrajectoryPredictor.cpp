@@ -0,0 +1,196 @@
+#include <algorithm>
+#include <cmath>
+
+#include "TrajectoryPredictor.h"
+
+static const double PI = 3.14159265358979323846;
+static const double EARTH_RADIUS_NM = 3440.065;
+
+TrajectoryPredictor::TrajectoryPredictor(const TrajectoryInput& input)
+	: _input(input)
+{
+	double along = 0;
+	double latitude = input.latitude;
+	double longitude = input.longitude;
+
+	_along.reserve(input.route.size());
+	for (const RoutePoint& point : input.route)
+	{
+		along += Distance(latitude, longitude, point.latitude, point.longitude);
+		_along.push_back(along);
+
+		latitude = point.latitude;
+		longitude = point.longitude;
+	}
+
+	if (input.sectorExitSeconds < 0 || input.groundSpeed <= 0) return;
+
+	// Walk the route to where the aircraft leaves the sector
+	_exitAlong = std::min(input.sectorExitSeconds * input.groundSpeed / 3600, along);
+
+	double legStart = 0;
+	latitude = input.latitude;
+	longitude = input.longitude;
+
+	for (size_t i = 0; i < input.route.size(); i++)
+	{
+		if (_along[i] >= _exitAlong)
+		{
+			double length = _along[i] - legStart;
+			double fraction = length > 0 ? (_exitAlong - legStart) / length : 0;
+
+			_exitLatitude = latitude + (input.route[i].latitude - latitude) * fraction;
+			_exitLongitude = longitude + (input.route[i].longitude - longitude) * fraction;
+			return;
+		}
+
+		legStart = _along[i];
+		latitude = input.route[i].latitude;
+		longitude = input.route[i].longitude;
+	}
+
+	_exitLatitude = latitude;
+	_exitLongitude = longitude;
+}
+
+DirectToPrediction TrajectoryPredictor::Evaluate(size_t routeIndex) const
+{
+	DirectToPrediction prediction;
+	if (routeIndex >= _input.route.size()) return prediction;
+
+	const RoutePoint& point = _input.route[routeIndex];
+	double total = _along.back();
+	double direct = Distance(_input.latitude, _input.longitude, point.latitude, point.longitude);
+
+	prediction.name = point.name;
+	prediction.onRoute = true;
+	prediction.routeSeconds = ToSeconds(total);
+	prediction.directSeconds = ToSeconds(direct + total - _along[routeIndex]);
+	prediction.timeSaved = prediction.routeSeconds - prediction.directSeconds;
+	prediction.altitude = AltitudeAfter(ToSeconds(direct));
+
+	if (_exitAlong < 0) return prediction;
+
+	double exit;
+	if (_exitAlong >= _along[routeIndex])
+	{
+		// Still leaves at the same point, further along the route
+		exit = direct + _exitAlong - _along[routeIndex];
+	}
+	else
+	{
+		// The point where it would have left is cut off, so it leaves on the direct leg, abeam of it
+		exit = AlongTrack(_input.latitude, _input.longitude, point.latitude, point.longitude, direct);
+	}
+
+	SetSectorExit(prediction, exit);
+	return prediction;
+}
+
+DirectToPrediction TrajectoryPredictor::Evaluate(const RoutePoint& point) const
+{
+	DirectToPrediction prediction;
+	prediction.name = point.name;
+
+	double direct = Distance(_input.latitude, _input.longitude, point.latitude, point.longitude);
+	prediction.altitude = AltitudeAfter(ToSeconds(direct));
+
+	// With nothing left of the route there is nothing to compare against, and nothing saved
+	if (_input.route.empty())
+	{
+		prediction.routeSeconds = ToSeconds(direct);
+		prediction.directSeconds = prediction.routeSeconds;
+		return prediction;
+	}
+
+	const RoutePoint& last = _input.route.back();
+	double onwards = Distance(point.latitude, point.longitude, last.latitude, last.longitude);
+
+	prediction.routeSeconds = ToSeconds(_along.back());
+	prediction.directSeconds = ToSeconds(direct + onwards);
+	prediction.timeSaved = prediction.routeSeconds - prediction.directSeconds;
+
+	if (_exitAlong < 0) return prediction;
+
+	// Abeam of the point where it would have left the route, on the direct leg or the one after it
+	double exit = AlongTrack(_input.latitude, _input.longitude, point.latitude, point.longitude, direct);
+	if (exit < 0)
+	{
+		exit = AlongTrack(point.latitude, point.longitude, last.latitude, last.longitude, onwards);
+		if (exit >= 0) exit += direct;
+	}
+
+	SetSectorExit(prediction, exit);
+	return prediction;
+}
+
+int TrajectoryPredictor::FindOnRoute(const std::string& name) const
+{
+	for (size_t i = 0; i < _input.route.size(); i++)
+	{
+		if (_input.route[i].name == name) return static_cast<int>(i);
+	}
+
+	return -1;
+}
+
+double TrajectoryPredictor::Distance(double latitude1, double longitude1, double latitude2, double longitude2)
+{
+	double phi1 = latitude1 * PI / 180;
+	double phi2 = latitude2 * PI / 180;
+	double dphi = phi2 - phi1;
+	double dlambda = (longitude2 - longitude1) * PI / 180;
+
+	double a = std::sin(dphi / 2) * std::sin(dphi / 2) + std::cos(phi1) * std::cos(phi2) * std::sin(dlambda / 2) * std::sin(dlambda / 2);
+	return 2 * EARTH_RADIUS_NM * std::asin(std::min(1.0, std::sqrt(a)));
+}
+
+/**
+* How far along the great circle from one point to another the aircraft is abeam of the sector exit, or -1 if it
+* is never abeam of it on that leg.
+*/
+double TrajectoryPredictor::AlongTrack(double latitude1, double longitude1, double latitude2, double longitude2, double length) const
+{
+	double toExit = Distance(latitude1, longitude1, _exitLatitude, _exitLongitude) / EARTH_RADIUS_NM;
+	double angle = Bearing(latitude1, longitude1, _exitLatitude, _exitLongitude) - Bearing(latitude1, longitude1, latitude2, longitude2);
+
+	double crossTrack = std::asin(std::sin(toExit) * std::sin(angle));
+	double alongTrack = std::acos(std::max(-1.0, std::min(1.0, std::cos(toExit) / std::cos(crossTrack)))) * EARTH_RADIUS_NM;
+
+	// Behind the start of the leg, or past its end
+	if (std::cos(angle) < 0 || alongTrack > length) return -1;
+
+	return alongTrack;
+}
+
+void TrajectoryPredictor::SetSectorExit(DirectToPrediction& prediction, double exit) const
+{
+	if (exit < 0) return;
+
+	prediction.sectorExitSeconds = ToSeconds(exit);
+	prediction.sectorExitChange = prediction.sectorExitSeconds - ToSeconds(_exitAlong);
+}
+
+double TrajectoryPredictor::Bearing(double latitude1, double longitude1, double latitude2, double longitude2)
+{
+	double phi1 = latitude1 * PI / 180;
+	double phi2 = latitude2 * PI / 180;
+	double dlambda = (longitude2 - longitude1) * PI / 180;
+
+	return std::atan2(std::sin(dlambda) * std::cos(phi2), std::cos(phi1) * std::sin(phi2) - std::sin(phi1) * std::cos(phi2) * std::cos(dlambda));
+}
+
+int TrajectoryPredictor::AltitudeAfter(double seconds) const
+{
+	double minutes = seconds / 60;
+
+	if (_input.targetAltitude > _input.altitude)
+		return std::min(_input.targetAltitude, static_cast<int>(_input.altitude + _input.climbRate * minutes));
+
+	return std::max(_input.targetAltitude, static_cast<int>(_input.altitude - _input.descentRate * minutes));
+}
+
+double TrajectoryPredictor::ToSeconds(double distance) const
+{
+	return _input.groundSpeed > 0 ? distance / _input.groundSpeed * 3600 : 0;
+}
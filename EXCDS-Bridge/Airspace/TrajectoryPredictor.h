@@ -0,0 +1,108 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+struct RoutePoint
+{
+    std::string name;
+    double latitude = 0;
+    double longitude = 0;
+};
+
+/**
+* Where an aircraft is and how it is flying, and what is left of its route.
+*/
+struct TrajectoryInput
+{
+    double latitude = 0;
+    double longitude = 0;
+
+    // Knots over the ground
+    double groundSpeed = 0;
+
+    int altitude = 0;
+    int targetAltitude = 0;
+
+    // Feet a minute, both positive
+    int climbRate = 0;
+    int descentRate = 0;
+
+    // From the point the aircraft is flying to, to the end of the route
+    std::vector<RoutePoint> route;
+
+    // When the aircraft leaves the sector along the route, in seconds, or -1 if it does not
+    double sectorExitSeconds = -1;
+};
+
+/**
+* What flying direct to one point would do.
+*/
+struct DirectToPrediction
+{
+    std::string name;
+    bool onRoute = false;
+
+    // To the end of the route, flying it and going direct, in seconds
+    double routeSeconds = 0;
+    double directSeconds = 0;
+    double timeSaved = 0;
+
+    // Predicted altitude at the point
+    int altitude = 0;
+
+    // When the aircraft would leave the sector, or -1 if it does not or that cannot be told, and how much earlier or
+    // later than on the route
+    double sectorExitSeconds = -1;
+    double sectorExitChange = 0;
+};
+
+/**
+* A light trajectory predictor for comparing directs, kept apart from EuroScope's own predictions.
+*
+* Legs are great circles flown at a constant ground speed, and the altitude climbs or descends at a constant rate
+* to the target altitude. Distances along the route are worked out once, so each candidate is a few great circle
+* distances. A point that is not on the route is flown direct, then direct to the end of the route.
+*
+* The sector boundary is not known here, so the exit is taken to be the point on the route where the aircraft would
+* leave, as EuroScope predicts it. A direct that skips that point leaves the sector where it passes abeam of it, and
+* if it never does, the exit is not known.
+*/
+class TrajectoryPredictor
+{
+public:
+    explicit TrajectoryPredictor(const TrajectoryInput& input);
+
+    DirectToPrediction Evaluate(size_t routeIndex) const;
+    DirectToPrediction Evaluate(const RoutePoint& point) const;
+
+    /**
+    * The index of a point on the route, or -1.
+    */
+    int FindOnRoute(const std::string& name) const;
+
+    /**
+    * Great circle distance in nautical miles.
+    */
+    static double Distance(double latitude1, double longitude1, double latitude2, double longitude2);
+private:
+    TrajectoryInput _input;
+
+    // Along the route from the aircraft to each point, in nautical miles
+    std::vector<double> _along;
+
+    // Along the route to the sector exit, and where that is, if the aircraft leaves the sector
+    double _exitAlong = -1;
+    double _exitLatitude = 0;
+    double _exitLongitude = 0;
+
+    double AlongTrack(double latitude1, double longitude1, double latitude2, double longitude2, double length) const;
+    void SetSectorExit(DirectToPrediction& prediction, double exit) const;
+    int AltitudeAfter(double seconds) const;
+    double ToSeconds(double distance) const;
+
+    /**
+    * Initial great circle course in radians from true north.
+    */
+    static double Bearing(double latitude1, double longitude1, double latitude2, double longitude2);
+};
@@ -1,5 +1,7 @@
 #include <string>
 #include <iostream>
+#include <cstdio>
+#include <Windows.h>
 
 #include "ApiHelper.h"
 
@@ -37,3 +39,190 @@ std::string ApiHelper::ToASCII(const std::string& input) {
     return asciiString;
 }
 
+
+/*
+* Approximates the size of a message once it is serialized to JSON, without actually serializing it.
+*/
+size_t ApiHelper::EstimateMessageSize(const sio::message::ptr& message)
+{
+	if (!message) return 4;
+
+	switch (message->get_flag())
+	{
+	case sio::message::flag_string:
+		return message->get_string().size() + 2;
+	case sio::message::flag_integer:
+	case sio::message::flag_double:
+		return 8;
+	case sio::message::flag_boolean:
+		return 5;
+	case sio::message::flag_binary:
+		return message->get_binary() ? message->get_binary()->size() : 0;
+	case sio::message::flag_array:
+	{
+		size_t size = 2;
+		for (const sio::message::ptr& item : message->get_vector())
+			size += EstimateMessageSize(item) + 1;
+		return size;
+	}
+	case sio::message::flag_object:
+	{
+		size_t size = 2;
+		for (const auto& item : message->get_map())
+			size += item.first.size() + 4 + EstimateMessageSize(item.second);
+		return size;
+	}
+	default:
+		return 4;
+	}
+}
+
+/*
+* Serializes a message to JSON, for files the bridge writes. Binary data is left out.
+*/
+std::string ApiHelper::ToJson(const sio::message::ptr& message)
+{
+	if (!message) return "null";
+
+	switch (message->get_flag())
+	{
+	case sio::message::flag_string:
+	{
+		std::string json = "\"";
+		for (char c : message->get_string())
+		{
+			switch (c)
+			{
+			case '"': json += "\\\""; break;
+			case '\\': json += "\\\\"; break;
+			case '\n': json += "\\n"; break;
+			case '\r': json += "\\r"; break;
+			case '\t': json += "\\t"; break;
+			default:
+				if (static_cast<unsigned char>(c) < 0x20)
+				{
+					char escaped[8];
+					snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+					json += escaped;
+				}
+				else
+					json += c;
+			}
+		}
+		return json + "\"";
+	}
+	case sio::message::flag_integer:
+		return std::to_string(message->get_int());
+	case sio::message::flag_double:
+	{
+		char number[32];
+		snprintf(number, sizeof(number), "%.17g", message->get_double());
+		return number;
+	}
+	case sio::message::flag_boolean:
+		return message->get_bool() ? "true" : "false";
+	case sio::message::flag_array:
+	{
+		std::string json = "[";
+		for (const sio::message::ptr& item : message->get_vector())
+			json += (json.size() > 1 ? "," : "") + ToJson(item);
+		return json + "]";
+	}
+	case sio::message::flag_object:
+	{
+		std::string json = "{";
+		for (const auto& item : message->get_map())
+			json += (json.size() > 1 ? "," : "") + ToJson(sio::string_message::create(item.first)) + ":" + ToJson(item.second);
+		return json + "}";
+	}
+	default:
+		return "null";
+	}
+}
+
+/*
+* Copies a message and everything in it, so the copy can be handed to another thread or changed without touching
+* the original. Binary data is shared, as sio never changes it once created.
+*/
+sio::message::ptr ApiHelper::CopyMessage(const sio::message::ptr& message)
+{
+	if (!message) return message;
+
+	switch (message->get_flag())
+	{
+	case sio::message::flag_string:
+		return sio::string_message::create(message->get_string());
+	case sio::message::flag_integer:
+		return sio::int_message::create(message->get_int());
+	case sio::message::flag_double:
+		return sio::double_message::create(message->get_double());
+	case sio::message::flag_boolean:
+		return sio::bool_message::create(message->get_bool());
+	case sio::message::flag_binary:
+		return sio::binary_message::create(message->get_binary());
+	case sio::message::flag_array:
+	{
+		sio::message::ptr copy = sio::array_message::create();
+		for (const sio::message::ptr& item : message->get_vector())
+			copy->get_vector().push_back(CopyMessage(item));
+		return copy;
+	}
+	case sio::message::flag_object:
+	{
+		sio::message::ptr copy = sio::object_message::create();
+		for (const auto& item : message->get_map())
+			copy->get_map()[item.first] = CopyMessage(item.second);
+		return copy;
+	}
+	default:
+		return sio::null_message::create();
+	}
+}
+
+/*
+* The string at a path of object keys in a message, or an empty string if any of it is missing.
+*/
+std::string ApiHelper::GetString(const sio::message::ptr& message, std::initializer_list<const char*> path)
+{
+	sio::message::ptr value = message;
+
+	for (const char* key : path)
+	{
+		if (!value || value->get_flag() != sio::message::flag_object) return "";
+
+		auto entry = value->get_map().find(key);
+		if (entry == value->get_map().end()) return "";
+
+		value = entry->second;
+	}
+
+	return value && value->get_flag() == sio::message::flag_string ? value->get_string() : "";
+}
+
+/*
+* The folder the plugin DLL was loaded from, with a trailing slash. Files the bridge writes are kept there.
+*/
+std::string ApiHelper::GetPluginDirectory()
+{
+	HMODULE module = NULL;
+	char path[MAX_PATH] = { 0 };
+
+	if (!GetModuleHandleEx(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+		reinterpret_cast<LPCSTR>(&ApiHelper::GetPluginDirectory), &module))
+		return "";
+
+	GetModuleFileName(module, path, MAX_PATH);
+
+	std::string directory = path;
+	return directory.substr(0, directory.find_last_of("\\/") + 1);
+}
+
+/**
+* Relative file names are taken to be in the plugin folder.
+*/
+std::string ApiHelper::ResolvePluginPath(const std::string& file)
+{
+	bool absolute = file.find(':') != std::string::npos || (!file.empty() && (file[0] == '\\' || file[0] == '/'));
+
+	return absolute ? file : GetPluginDirectory() + file;
+}
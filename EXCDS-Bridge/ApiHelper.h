@@ -1,9 +1,17 @@
 #pragma once
+#include <initializer_list>
 #include <string>
+#include <sio_client.h>
 
 class ApiHelper
 {
 public:
 	static void Login(std::string callsign, int cid);
 	static std::string ToASCII(const std::string&);
-};
\ No newline at end of file
+	static size_t EstimateMessageSize(const sio::message::ptr&);
+	static std::string ToJson(const sio::message::ptr&);
+	static sio::message::ptr CopyMessage(const sio::message::ptr&);
+	static std::string GetString(const sio::message::ptr& message, std::initializer_list<const char*> path);
+	static std::string GetPluginDirectory();
+	static std::string ResolvePluginPath(const std::string& file);
+};
@@ -3,13 +3,34 @@
 #include <afxsock.h>
 #include <iostream>
 #include <string>
+#include <unordered_map>
 #include "stdio.h"
 #include "MessageHandler.h"
 #include "CEXCDSBridge.h"
+#include "Stream/RadarStream.h"
+#include "Surveillance/ConflictDetector.h"
+#include "Surveillance/KinematicsFilter.h"
+#include "Surveillance/MinimumAltitudeWarning.h"
+#include "Surveillance/SquawkIndex.h"
+#include "Surveillance/TrackArchive.h"
+#include "Surveillance/TrackHistory.h"
+#include "Surveillance/TrafficIndex.h"
+#include "Diagnostics/CommandTracer.h"
+#include "Diagnostics/Metrics.h"
+#include "Diagnostics/Profiler.h"
+#include "Replay/SessionRecorder.h"
+#include "Replay/SessionReplayer.h"
+#include "Simulation/TrafficGenerator.h"
+#include "Simulation/LoopbackSocket.h"
+#include "Simulation/LoadTest.h"
+#include "Airspace/AirportIndex.h"
+#include "Airspace/ControllerRoster.h"
+#include "Airspace/FixIndex.h"
+#include "ApiHelper.h"
 
 // Events
-#include "Events/AltitudeUpdateEvent.h"
-#include "Events/ScratchpadUpdateEvent.h"
+#include "Events/Events.h"
+#include "Events/AmendmentCoalescer.h"
 
 #define PLUGIN_NAME		"EXCDS Bridge"
 #define PLUGIN_VERSION	"0.0.5-alpha"
@@ -25,6 +46,9 @@ sio::client socketClient;
 // The instance of the bridge, for accessing EuroScope functions from other classes
 CEXCDSBridge* instance;
 
+// Every listener registered with the socket, by event. Only written while binding the events.
+std::map<std::string, sio::socket::event_listener> registeredEvents;
+
 CEXCDSBridge::CEXCDSBridge() :
 	EuroScopePlugIn::CPlugIn(
 		EuroScopePlugIn::COMPATIBILITY_CODE,
@@ -39,63 +63,105 @@ CEXCDSBridge::CEXCDSBridge() :
 	// Set instance
 	instance = this;
 
+	// Frames in flight on a previous connection will never be acknowledged
+	socketClient.set_open_listener([]() {
+		RadarStream::GetInstance()->Reset();
+
+		// Deltas sent while disconnected are lost, so a new connection starts from the whole roster
+		Emit("SEND_CTRLR_DATA", ControllerRoster::GetInstance()->ToMessage());
+		Emit("SEND_AIRPORT_DATA", AirportIndex::GetInstance()->ToMessage());
+	});
+
 	socketClient.connect(BRIDGE_HOST + ":" + BRIDGE_PORT);
-	socketClient.socket()->emit("CONNECTED", sio::message::list("true"));
+	Emit("CONNECTED", sio::message::list("true"));
 
 	// Register for the socket events
 	bind_events();
+
+	// Without a grid file there are no minimum altitude warnings, until one is loaded with LOAD_MSAW_GRID
+	MinimumAltitudeWarning::GetInstance()->Load(ApiHelper::ResolvePluginPath(MinimumAltitudeWarning::DEFAULT_FILE));
 }
 
 CEXCDSBridge::~CEXCDSBridge()
 {
 	AFX_MANAGE_STATE(AfxGetStaticModuleState());
 
+	// Nothing may use the socket once it is closed
+	SessionReplayer::GetInstance()->Stop();
+	TrafficGenerator::GetInstance()->Stop();
+	LoadTest::GetInstance()->Stop();
+	LoopbackSocket::GetInstance()->StopStorm();
+	AmendmentCoalescer::GetInstance()->Flush();
+	SessionRecorder::GetInstance()->Stop();
+
 	// Cleanup socket
-	socketClient.socket()->emit("CONNECTED", sio::message::list("false"));
+	Emit("CONNECTED", sio::message::list("false"));
 	socketClient.socket()->off_all();
 	socketClient.close();
 }
 
 void CEXCDSBridge::bind_events()
 {
-	MessageHandler messageHandler;
-
-	// Messages FROM EXCDS, to update aircraft in EuroScope
-	(new AltitudeUpdateEvent())->RegisterEvent("UPDATE_ALTITUDE");
-	(new ScratchpadUpdateEvent())->RegisterEvent("UPDATE_SCRATCHPAD");
-
-	socketClient.socket()->on("UPDATE_TIME", std::bind(&MessageHandler::UpdateTime, &messageHandler, std::placeholders::_1));
-	socketClient.socket()->on("UPDATE_DEPARTURE_TIME", std::bind(&MessageHandler::UpdateDepartureTime, &messageHandler, std::placeholders::_1));
-	socketClient.socket()->on("UPDATE_SPEED", std::bind(&MessageHandler::UpdateSpeed, &messageHandler, std::placeholders::_1));
-	socketClient.socket()->on("UPDATE_STATUS", std::bind(&MessageHandler::UpdateAircraftStatus, &messageHandler, std::placeholders::_1));
-	socketClient.socket()->on("UPDATE_TRACKING_STATUS", std::bind(&MessageHandler::UpdateTrackingStatus, &messageHandler, std::placeholders::_1));
-	socketClient.socket()->on("UPDATE_DIRECT", std::bind(&MessageHandler::UpdateDirectTo, &messageHandler, std::placeholders::_1));
-	socketClient.socket()->on("UPDATE_FLIGHT_PLAN", std::bind(&MessageHandler::UpdateFlightPlan, &messageHandler, std::placeholders::_1));
-	socketClient.socket()->on("UPDATE_ROUTE", std::bind(&MessageHandler::UpdateRoute, &messageHandler, std::placeholders::_1));
-	socketClient.socket()->on("UPDATE_SQUAWK", std::bind(&MessageHandler::UpdateSquawk, &messageHandler, std::placeholders::_1));
-	socketClient.socket()->on("NEW_FLIGHT_PLAN", std::bind(&MessageHandler::HandleNewFlightPlan, &messageHandler, std::placeholders::_1));
-	socketClient.socket()->on("UPDATE_POSITIONS", std::bind(&MessageHandler::UpdatePositions, &messageHandler, std::placeholders::_1));
-	socketClient.socket()->on("SEND_PDC", std::bind(&MessageHandler::SendPDC, &messageHandler, std::placeholders::_1));
-	socketClient.socket()->on("HANDOFF_TARGET", std::bind(&MessageHandler::HandoffTarget, &messageHandler, std::placeholders::_1));
-	socketClient.socket()->on("REFUSE_HANDOFF", std::bind(&MessageHandler::RefuseHandoff, &messageHandler, std::placeholders::_1));
-	socketClient.socket()->on("ACCEPT_HANDOFF", std::bind(&MessageHandler::AcceptHandoff, &messageHandler, std::placeholders::_1));
-	socketClient.socket()->on("REFUSE_COORD", std::bind(&MessageHandler::RefuseCoordination, &messageHandler, std::placeholders::_1));
-	socketClient.socket()->on("ACCEPT_COORD", std::bind(&MessageHandler::AcceptCoordination, &messageHandler, std::placeholders::_1));
-	socketClient.socket()->on("CORRELATE_TARGET", std::bind(&MessageHandler::CorrelateTarget, &messageHandler, std::placeholders::_1));
-	socketClient.socket()->on("DECORRELATE_TARGET", std::bind(&MessageHandler::DecorrelateTarget, &messageHandler, std::placeholders::_1));
-
-	// EXCDS information requests
-	socketClient.socket()->on("REQUEST_ALL_FP_DATA", std::bind(&MessageHandler::RequestAllAircraft, &messageHandler, std::placeholders::_1));
-	socketClient.socket()->on("REQUEST_FP_DATA_CALLSIGN", std::bind(&MessageHandler::RequestAircraftByCallsign, &messageHandler, std::placeholders::_1));
-	socketClient.socket()->on("REQUEST_ROUTE_DATA", std::bind(&MessageHandler::PrepareRouteDataResponse, &messageHandler, std::placeholders::_1));
+	// Bound handlers are called after this returns
+	static MessageHandler messageHandler;
+
+	// Messages FROM EXCDS, and their information requests
+	CommandEvents::RegisterAll();
+
+	// Bridge diagnostics, kept out of local dispatch so storms and load tests cannot drive them
+	DiagnosticEvents::RegisterAll();
+	RegisterSocketEvent("REQUEST_COMMAND_LATENCY", std::bind(&MessageHandler::RequestCommandLatency, &messageHandler, std::placeholders::_1), false);
+	RegisterSocketEvent("REQUEST_METRICS", std::bind(&MessageHandler::RequestMetrics, &messageHandler, std::placeholders::_1), false);
+	RegisterSocketEvent("START_RECORDING", std::bind(&MessageHandler::StartRecording, &messageHandler, std::placeholders::_1), false);
+	RegisterSocketEvent("STOP_RECORDING", std::bind(&MessageHandler::StopRecording, &messageHandler, std::placeholders::_1), false);
+	RegisterSocketEvent("START_REPLAY", std::bind(&MessageHandler::StartReplay, &messageHandler, std::placeholders::_1), false);
+	RegisterSocketEvent("STOP_REPLAY", std::bind(&MessageHandler::StopReplay, &messageHandler, std::placeholders::_1), false);
+	RegisterSocketEvent("START_SYNTHETIC_TRAFFIC", std::bind(&MessageHandler::StartSyntheticTraffic, &messageHandler, std::placeholders::_1), false);
+	RegisterSocketEvent("STOP_SYNTHETIC_TRAFFIC", std::bind(&MessageHandler::StopSyntheticTraffic, &messageHandler, std::placeholders::_1), false);
+	RegisterSocketEvent("START_LOOPBACK_STORM", std::bind(&MessageHandler::StartLoopbackStorm, &messageHandler, std::placeholders::_1), false);
+	RegisterSocketEvent("STOP_LOOPBACK_STORM", std::bind(&MessageHandler::StopLoopbackStorm, &messageHandler, std::placeholders::_1), false);
+	RegisterSocketEvent("REQUEST_LOOPBACK_REPORT", std::bind(&MessageHandler::RequestLoopbackReport, &messageHandler, std::placeholders::_1), false);
+	RegisterSocketEvent("RUN_LOAD_TEST", std::bind(&MessageHandler::RunLoadTest, &messageHandler, std::placeholders::_1), false);
+	RegisterSocketEvent("STOP_LOAD_TEST", std::bind(&MessageHandler::StopLoadTest, &messageHandler, std::placeholders::_1), false);
+	RegisterSocketEvent("REQUEST_LOAD_TEST_RESULTS", std::bind(&MessageHandler::RequestLoadTestResults, &messageHandler, std::placeholders::_1), false);
+#ifndef EXCDS_LEAN
+	RegisterSocketEvent("REQUEST_PROFILE_TRACE", std::bind(&MessageHandler::RequestProfileTrace, &messageHandler, std::placeholders::_1), false);
+#endif
 }
 
 void CEXCDSBridge::OnTimer(int counter)
 {
+	PROFILE_ZONE("OnTimer");
+	static MetricHistogram& tickTime = Metrics::GetInstance()->Histogram("tick.on_timer_us");
+	MetricTimer timer(tickTime);
+
+	SessionRecorder::GetInstance()->RecordTimer(counter);
+
+	// Amend everything EXCDS changed since the last tick, once per aircraft
+	AmendmentCoalescer::GetInstance()->Flush();
+
+	TickStreams(counter);
+
 	if (counter % 5 != 0) return;
 
 	CEXCDSBridge* bridgeInstance = CEXCDSBridge::GetInstance();
 
+	try {
+		// Loads once the sector file is known, and again if the controller changes it
+		FixIndex::GetInstance()->EnsureLoaded();
+	}
+	catch (...) {
+		Metrics::CountException("OnTimer.Fixes", "EXCDS Error: Failed to load the fix index");
+	}
+
+	try {
+		// Runway activity is read once the sector file is known, then again only when the controller changes it
+		AirportIndex::GetInstance()->EnsureLoaded();
+	}
+	catch (...) {
+		Metrics::CountException("OnTimer.Airports", "EXCDS Error: Failed to read runway activity");
+	}
+
 	try {
 		sio::message::ptr statusMessage = sio::object_message::create();
 
@@ -108,7 +174,7 @@ void CEXCDSBridge::OnTimer(int counter)
 
 		statusMessage->get_map()["connection"] = sio::int_message::create(bridgeInstance->GetConnectionType());
 
-		bridgeInstance->GetSocket()->emit("STATUS", statusMessage);
+		Emit("STATUS", statusMessage);
 
 		if (!me.IsValid()) return;
 
@@ -120,7 +186,12 @@ void CEXCDSBridge::OnTimer(int counter)
 
 		const EuroScopePlugIn::CPosition center = me.GetPosition();
 
+		PROFILE_ZONE("OnTimer.FlightPlans");
+
 		while (flightPlan.IsValid()) {
+			// Every flight plan holds on to its code, whether or not it is sent to EXCDS
+			SquawkIndex::GetInstance()->UpdateAssigned(flightPlan.GetCallsign(), flightPlan.GetControllerAssignedData().GetSquawk());
+
 			// If the FP is in an FLIGHT_PLAN_STATE_NON_CONCERNED or FLIGHT_PLAN_STATE_NOTIFIED state, we don't need this data
 			if (flightPlan.GetState() == 0 &&
 				(flightPlan.GetFPTrackPosition().IsValid() &&
@@ -135,74 +206,56 @@ void CEXCDSBridge::OnTimer(int counter)
 			sio::message::ptr msg = sio::object_message::create();
 			MessageHandler::PrepareFlightPlanDataResponse(flightPlan, msg);
 
+			// Keeps sector entry times current in the traffic index
+			TrafficIndex::GetInstance()->Update(msg);
+
 			arrayMessage->get_vector().push_back(msg);
 
 			flightPlan = bridgeInstance->FlightPlanSelectNext(flightPlan);
 		}
 
 		// Send
-		bridgeInstance->GetSocket()->emit("MASS_SEND_FP_DATA", arrayMessage);
+		Emit("MASS_SEND_FP_DATA", arrayMessage);
 	}
 	catch (...) {
-		OutputDebugString("EXCDS Error: 5 Second FP Refresh error");
+		Metrics::CountException("OnTimer.FlightPlans", "EXCDS Error: 5 Second FP Refresh error");
 	}
+}
 
-	try {
-		sio::message::ptr controllerMessage = sio::array_message::create();
-		EuroScopePlugIn::CController controller = bridgeInstance->ControllerSelectFirst();
-
-		while (controller.IsValid())
-		{
-			if (!controller.IsController() || controller.GetFacility() == 0)
-				controller = bridgeInstance->ControllerSelectNext(controller);
-
-			std::string controllerId = controller.GetPositionId();
-			std::string controllerCallsign = controller.GetCallsign();
-			double controllerFrequency = controller.GetPrimaryFrequency();
-			int facility = controller.GetFacility();
-
-			sio::message::ptr msg = sio::object_message::create();
-
-			msg->get_map()["callsign"] = sio::string_message::create(controllerCallsign);
-			msg->get_map()["cjs"] = sio::string_message::create(controllerId);
-			msg->get_map()["frequency"] = sio::double_message::create(controllerFrequency);
-			msg->get_map()["facility"] = sio::int_message::create(facility);
+void CEXCDSBridge::OnControllerPositionUpdate(EuroScopePlugIn::CController controller)
+{
+	ControllerRoster::GetInstance()->Update(controller);
+}
 
-			controller = bridgeInstance->ControllerSelectNext(controller);
-		}
+void CEXCDSBridge::OnControllerDisconnect(EuroScopePlugIn::CController controller)
+{
+	ControllerRoster::GetInstance()->Remove(controller.GetCallsign());
+}
 
-		bridgeInstance->GetSocket()->emit("SEND_CTRLR_DATA", controllerMessage);
-	} catch (...) {
-		OutputDebugString("EXCDS Error: 5 Second Controller refresh error");
+void CEXCDSBridge::OnAirportRunwayActivityChanged()
+{
+	try {
+		AirportIndex::GetInstance()->Rebuild();
+	}
+	catch (...) {
+		Metrics::CountException("OnAirportRunwayActivityChanged", "EXCDS Error: Failed to read runway activity");
 	}
 }
 
-//void CEXCDSBridge::OnControllerPositionUpdate(EuroScopePlugIn::CController controller)
-//{
-//	sio::message::ptr response = sio::object_message::create();
-//	MessageHandler::RequestAirports(response);
-//}
-//
-//void CEXCDSBridge::OnControllerDisconnect(EuroScopePlugIn::CController controller)
-//{
-//	sio::message::ptr response = sio::object_message::create();
-//	MessageHandler::RequestAirports(response);
-//}
-
 void CEXCDSBridge::OnFlightPlanControllerAssignedDataUpdate(EuroScopePlugIn::CFlightPlan fp, int Datatype)
 {
 	sio::message::ptr response = sio::object_message::create();
 	CEXCDSBridge* bridgeInstance = CEXCDSBridge::GetInstance();
 	MessageHandler::PrepareFlightPlanDataResponse(fp, response);
 
-	bridgeInstance->GetSocket()->emit("SEND_FP_DATA", response);
+	PublishFlightPlan(response);
 
 	if (fp.GetCorrelatedRadarTarget().IsValid())
 	{
 		sio::message::ptr rtresponse = sio::object_message::create();
 		MessageHandler::PrepareRadarTargetResponse(fp.GetCorrelatedRadarTarget(), rtresponse);
 
-		bridgeInstance->GetSocket()->emit("SEND_RT_DATA", rtresponse);
+		PublishRadarTarget(RadarSample::FromRadarTarget(fp.GetCorrelatedRadarTarget()), rtresponse);
 	}
 }
 
@@ -212,14 +265,14 @@ void CEXCDSBridge::OnFlightPlanFlightPlanDataUpdate(EuroScopePlugIn::CFlightPlan
 	CEXCDSBridge* bridgeInstance = CEXCDSBridge::GetInstance();
 	MessageHandler::PrepareFlightPlanDataResponse(fp, response);
 
-	bridgeInstance->GetSocket()->emit("SEND_FP_DATA", response);
+	PublishFlightPlan(response);
 
 	if (fp.GetCorrelatedRadarTarget().IsValid())
 	{
 		sio::message::ptr rtresponse = sio::object_message::create();
 		MessageHandler::PrepareRadarTargetResponse(fp.GetCorrelatedRadarTarget(), rtresponse);
 
-		bridgeInstance->GetSocket()->emit("SEND_RT_DATA", rtresponse);
+		PublishRadarTarget(RadarSample::FromRadarTarget(fp.GetCorrelatedRadarTarget()), rtresponse);
 	}
 }
 
@@ -229,14 +282,14 @@ void CEXCDSBridge::OnFlightPlanFlightStripPushed(EuroScopePlugIn::CFlightPlan fp
 	CEXCDSBridge* bridgeInstance = CEXCDSBridge::GetInstance();
 	MessageHandler::PrepareFlightPlanDataResponse(fp, response);
 
-	bridgeInstance->GetSocket()->emit("SEND_FP_DATA", response);
+	PublishFlightPlan(response);
 
 	if (fp.GetCorrelatedRadarTarget().IsValid())
 	{
 		sio::message::ptr rtresponse = sio::object_message::create();
 		MessageHandler::PrepareRadarTargetResponse(fp.GetCorrelatedRadarTarget(), rtresponse);
 
-		bridgeInstance->GetSocket()->emit("SEND_RT_DATA", rtresponse);
+		PublishRadarTarget(RadarSample::FromRadarTarget(fp.GetCorrelatedRadarTarget()), rtresponse);
 	}
 }
 
@@ -250,16 +303,18 @@ void CEXCDSBridge::OnPlaneInformationUpdate(const char* sCallsign,
 	response->get_map()["type"] = sio::string_message::create(sPlaneType);
 
 	CEXCDSBridge* bridgeInstance = CEXCDSBridge::GetInstance();
-	bridgeInstance->GetSocket()->emit("SEND_PLANE_DATA", response);
+	SessionRecorder::GetInstance()->RecordPlaneInfo(response);
+	Emit("SEND_PLANE_DATA", response);
 }
 
 void CEXCDSBridge::OnRadarTargetPositionUpdate(EuroScopePlugIn::CRadarTarget rt)
 {
+	PROFILE_ZONE("OnRadarTargetPositionUpdate");
+
 	sio::message::ptr response = sio::object_message::create();
 	MessageHandler::PrepareRadarTargetResponse(rt, response);
 
-	CEXCDSBridge* bridgeInstance = CEXCDSBridge::GetInstance();
-	bridgeInstance->GetSocket()->emit("SEND_RT_DATA", response);
+	PublishRadarTarget(RadarSample::FromRadarTarget(rt), response);
 }
 
 void CEXCDSBridge::OnCompileFrequencyChat(const char* sSenderCallsign,
@@ -273,7 +328,8 @@ void CEXCDSBridge::OnCompileFrequencyChat(const char* sSenderCallsign,
 	response->get_map()["message"] = sio::string_message::create(sChatMessage);
 
 	CEXCDSBridge* bridgeInstance = CEXCDSBridge::GetInstance();
-	bridgeInstance->GetSocket()->emit("SEND_CHAT_DATA", response);
+	SessionRecorder::GetInstance()->RecordChat(response);
+	Emit("SEND_CHAT_DATA", response);
 }
 
 void CEXCDSBridge::OnCompilePrivateChat(const char* sSenderCallsign,
@@ -287,12 +343,14 @@ void CEXCDSBridge::OnCompilePrivateChat(const char* sSenderCallsign,
 	response->get_map()["message"] = sio::string_message::create(sChatMessage);
 
 	CEXCDSBridge* bridgeInstance = CEXCDSBridge::GetInstance();
-	bridgeInstance->GetSocket()->emit("SEND_CHAT_DATA", response);
+	SessionRecorder::GetInstance()->RecordChat(response);
+	Emit("SEND_CHAT_DATA", response);
 }
 
 void CEXCDSBridge::OnFlightPlanDisconnect(EuroScopePlugIn::CFlightPlan FlightPlan)
 {
-	GetSocket()->emit("CALLSIGN_DISCONNECT", sio::string_message::create(FlightPlan.GetCallsign()));
+	SessionRecorder::GetInstance()->RecordDisconnect(FlightPlan.GetCallsign());
+	PublishDisconnect(FlightPlan.GetCallsign());
 }
 
 /**
@@ -321,6 +379,189 @@ void CEXCDSBridge::SendEuroscopeMessage(const char* callsign, ExcdsResponseType
 	SendEuroscopeMessage(callsign, response.GetExcdsMessage().c_str(), response.GetCode().c_str());
 }
 
+/**
+* Listens to a socket event. Every command goes through the latency tracer on its way to the listener.
+* Unless localDispatch is false, the event can also be fired from inside the bridge with DispatchLocalEvent.
+*/
+void CEXCDSBridge::RegisterSocketEvent(const std::string& eventName, sio::socket::event_listener listener, bool localDispatch)
+{
+	MetricCounter& received = Metrics::GetInstance()->Counter("commands." + eventName);
+#ifndef EXCDS_LEAN
+	const char* zoneName = Profiler::GetInstance()->Intern(eventName);
+#endif
+
+	sio::socket::event_listener traced = [=, &received](sio::event& ev)
+	{
+		PROFILE_ZONE(zoneName);
+		CommandTracer* tracer = CommandTracer::GetInstance();
+
+		received.Increment();
+
+		tracer->Begin(eventName, ev);
+		listener(ev);
+		tracer->End(ev);
+	};
+
+	if (localDispatch)
+		registeredEvents[eventName] = traced;
+	socketClient.socket()->on(eventName, traced);
+}
+
+/**
+* Runs an event through the same listener the socket would, for events that did not come from the socket.
+*/
+bool CEXCDSBridge::DispatchLocalEvent(sio::event& event)
+{
+	auto listener = registeredEvents.find(event.get_name());
+	if (listener == registeredEvents.end()) return false;
+
+	listener->second(event);
+	return true;
+}
+
+std::vector<std::string> CEXCDSBridge::GetRegisteredEvents()
+{
+	std::vector<std::string> events;
+
+	for (const auto& listener : registeredEvents)
+		events.push_back(listener.first);
+
+	return events;
+}
+
+/**
+* Sends an event to EXCDS. All outbound traffic goes through here so it can be counted.
+* Sizes are only worked out while the loopback socket is capturing, unless the caller already knows them.
+*/
+void CEXCDSBridge::Emit(const std::string& eventName, sio::message::list const& message, std::function<void(sio::message::list const&)> const& ack, size_t knownBytes)
+{
+	PROFILE_ZONE("Emit");
+
+	// Each thread keeps the counters of the events it sends, so an emit takes no lock once its event has been seen
+	static thread_local std::unordered_map<std::string, MetricCounter*> emitted;
+
+	auto counter = emitted.find(eventName);
+	if (counter == emitted.end())
+		counter = emitted.emplace(eventName, &Metrics::GetInstance()->Counter("emit." + eventName)).first;
+
+	counter->second->Increment();
+
+	LoopbackSocket* loopback = LoopbackSocket::GetInstance();
+	if (loopback->IsCapturing())
+	{
+		size_t bytes = knownBytes;
+		if (bytes == 0)
+		{
+			for (size_t i = 0; i < message.size(); i++)
+				bytes += ApiHelper::EstimateMessageSize(message[i]);
+		}
+
+		loopback->OnEmit(eventName, bytes);
+	}
+
+	socketClient.socket()->emit(eventName, message, ack);
+}
+
+/**
+* Hands a radar target update to everything downstream of the radar: the recorder and the radar stream to EXCDS.
+* Live radar, replayed sessions and generated traffic all come through here.
+*/
+void CEXCDSBridge::PublishRadarTarget(const RadarSample& sample, sio::message::ptr message)
+{
+	// A replay or generated traffic must not end up in the recording of the session, or hold on to real codes
+	if (!sample.synthetic)
+	{
+		SessionRecorder::GetInstance()->RecordRadar(sample, message);
+		SquawkIndex::GetInstance()->UpdateTransponder(sample.callsign, sample.squawk);
+	}
+
+	// The alerts work from the smoothed track rather than the reported one
+	TrackKinematics kinematics = KinematicsFilter::GetInstance()->Update(sample);
+	KinematicsFilter::Annotate(kinematics, message);
+	KinematicsFilter::AnnotateLevelOff(kinematics, sample, message);
+
+	RadarSample smoothed = KinematicsFilter::Smooth(sample, kinematics);
+	ConflictDetector::GetInstance()->Update(smoothed);
+	ConflictDetector::GetInstance()->Annotate(sample.callsign, message);
+	MinimumAltitudeWarning::GetInstance()->Annotate(smoothed, message);
+
+	TrackHistory::GetInstance()->Record(sample);
+	TrackArchive::GetInstance()->Record(sample);
+	RadarStream::GetInstance()->Push(sample.systemId, message);
+}
+
+/**
+* Hands a message made by MessageHandler::PrepareFlightPlanDataResponse to the traffic and squawk indexes, the
+* recorder and EXCDS. Replayed and generated flight plans are not recorded.
+*/
+void CEXCDSBridge::PublishFlightPlan(sio::message::ptr message, bool synthetic)
+{
+	TrafficIndex::GetInstance()->Update(message);
+
+	std::string callsign = ApiHelper::GetString(message, { "callsign" });
+	if (!callsign.empty())
+		SquawkIndex::GetInstance()->UpdateAssigned(callsign, ApiHelper::GetString(message, { "controllerData", "squawk" }));
+
+	if (!synthetic)
+		SessionRecorder::GetInstance()->RecordFlightPlan(message);
+
+	Emit("SEND_FP_DATA", message);
+}
+
+/**
+* Tells everything downstream of the radar that an aircraft has gone, wherever it came from.
+*/
+void CEXCDSBridge::PublishDisconnect(const std::string& callsign)
+{
+	TrafficIndex::GetInstance()->Remove(callsign);
+	SquawkIndex::GetInstance()->Remove(callsign);
+	ConflictDetector::GetInstance()->Remove(callsign);
+	KinematicsFilter::GetInstance()->Remove(callsign);
+	TrackHistory::GetInstance()->Remove(callsign);
+	Emit("CALLSIGN_DISCONNECT", sio::string_message::create(callsign));
+}
+
+/**
+* The part of the one second timer that does not talk to EuroScope.
+*/
+void CEXCDSBridge::TickStreams(int counter)
+{
+	// Count radar frames that are late being acknowledged and send whatever was held back
+	RadarStream* radarStream = RadarStream::GetInstance();
+	radarStream->Tick();
+
+	ConflictDetector::GetInstance()->Tick();
+	TrackArchive::GetInstance()->Trim();
+
+	Metrics* metrics = Metrics::GetInstance();
+	metrics->Gauge("queue.radar_outstanding_frames").Set(radarStream->GetOutstandingFrames());
+	metrics->Gauge("queue.radar_outstanding_bytes").Set(radarStream->GetOutstandingBytes());
+	metrics->Gauge("queue.radar_parked_frames").Set(radarStream->GetParkedFrames());
+	metrics->Gauge("queue.pending_amendments").Set(AmendmentCoalescer::GetInstance()->GetPending());
+	metrics->Gauge("roster.controllers").Set(ControllerRoster::GetInstance()->GetSize());
+	metrics->Gauge("fixes.indexed").Set(FixIndex::GetInstance()->GetSize());
+	metrics->Gauge("traffic.indexed").Set(TrafficIndex::GetInstance()->GetSize());
+	metrics->Gauge("squawks.conflicting_codes").Set(SquawkIndex::GetInstance()->GetConflictCount());
+	metrics->Gauge("history.tracks").Set(TrackHistory::GetInstance()->GetSize());
+	metrics->Gauge("archive.points").Set(TrackArchive::GetInstance()->GetPointCount());
+	metrics->Gauge("archive.bytes").Set(TrackArchive::GetInstance()->GetBytes());
+	metrics->Gauge("stca.conflicts").Set(ConflictDetector::GetInstance()->GetConflictCount());
+
+	if (counter % 60 == 0)
+		metrics->DumpToFile();
+}
+
+/**
+* Whether EuroScope is connected to anything other people are on: the live network, a sweatbox or a simulator session.
+* Replays, generated traffic and load tests are refused while it is, so only offline and playback are allowed.
+*/
+bool CEXCDSBridge::IsLiveConnection()
+{
+	int connection = GetInstance()->GetConnectionType();
+
+	return connection != EuroScopePlugIn::CONNECTION_TYPE_NO && connection != EuroScopePlugIn::CONNECTION_TYPE_PLAYBACK;
+}
+
 CEXCDSBridge* CEXCDSBridge::GetInstance()
 {
 	return instance;
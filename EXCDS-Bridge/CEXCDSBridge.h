@@ -2,7 +2,11 @@
 #include "sio_client.h"
 #include "EuroScopePlugIn.h"
 
+#include <string>
+#include <vector>
+
 #include "Response/ExcdsResponse.h"
+#include "Surveillance/RadarSample.h"
 
 class CEXCDSBridge : public EuroScopePlugIn::CPlugIn
 {
@@ -11,6 +15,15 @@ public:
     static sio::socket::ptr GetSocket();
     static void SendEuroscopeMessage(const char* callsign, const char* message, const char* id);
     static void CEXCDSBridge::SendEuroscopeMessage(const char*, ExcdsResponseType);
+    static void RegisterSocketEvent(const std::string& eventName, sio::socket::event_listener listener, bool localDispatch = true);
+    static void Emit(const std::string& eventName, sio::message::list const& message, std::function<void(sio::message::list const&)> const& ack = nullptr, size_t knownBytes = 0);
+    static bool DispatchLocalEvent(sio::event& event);
+    static std::vector<std::string> GetRegisteredEvents();
+    static void PublishRadarTarget(const RadarSample& sample, sio::message::ptr message);
+    static void PublishFlightPlan(sio::message::ptr message, bool synthetic = false);
+    static void PublishDisconnect(const std::string& callsign);
+    static void TickStreams(int counter);
+    static bool IsLiveConnection();
 
     CEXCDSBridge();
     virtual ~CEXCDSBridge();
@@ -23,6 +36,7 @@ public:
     void OnTimer(int Counter);
     void OnControllerPositionUpdate(EuroScopePlugIn::CController controller);
     void OnControllerDisconnect(EuroScopePlugIn::CController controller);
+    void OnAirportRunwayActivityChanged();
     void OnRadarTargetPositionUpdate(EuroScopePlugIn::CRadarTarget rt);
     void OnCompileFrequencyChat(const char* sSenderCallsign,
         double Frequency,
@@ -0,0 +1,143 @@
+#include "CommandTracer.h"
+
+thread_local CommandTracer::Trace* CommandTracer::_current = nullptr;
+
+CommandTracer* CommandTracer::GetInstance()
+{
+	static CommandTracer tracer;
+	return &tracer;
+}
+
+void CommandTracer::Begin(const std::string& eventName, sio::event& event)
+{
+	Trace* trace = new Trace();
+	trace->eventName = eventName;
+	trace->stamps[TRACE_RECEIVED] = std::chrono::steady_clock::now();
+	trace->stamped[TRACE_RECEIVED] = true;
+
+	const sio::message::ptr& message = event.get_message();
+	if (message && message->get_flag() == sio::message::flag_object)
+	{
+		const std::map<std::string, sio::message::ptr>& payload = message->get_map();
+
+		auto id = payload.find("id");
+		if (id != payload.end() && id->second && id->second->get_flag() == sio::message::flag_string)
+			trace->id = id->second->get_string();
+
+		auto requested = payload.find("trace");
+		if (requested != payload.end() && requested->second && requested->second->get_flag() == sio::message::flag_boolean)
+			trace->requested = requested->second->get_bool();
+	}
+
+	delete _current;
+	_current = trace;
+}
+
+void CommandTracer::Mark(TraceStage stage)
+{
+	if (_current == nullptr || _current->stamped[stage]) return;
+
+	_current->stamps[stage] = std::chrono::steady_clock::now();
+	_current->stamped[stage] = true;
+}
+
+void CommandTracer::End(sio::event& event)
+{
+	Trace* trace = _current;
+	if (trace == nullptr) return;
+
+	_current = nullptr;
+
+	// Stages that were never reached take the time of the one before, so they show up as zero
+	if (!trace->stamped[TRACE_DISPATCHED])
+		trace->stamps[TRACE_DISPATCHED] = trace->stamps[TRACE_RECEIVED];
+
+	// Handlers that don't report when EuroScope was done have finished applying by the time they return
+	if (!trace->stamped[TRACE_APPLIED])
+		trace->stamps[TRACE_APPLIED] = std::chrono::steady_clock::now();
+
+	trace->stamps[TRACE_ACKED] = std::chrono::steady_clock::now();
+
+	auto micros = [trace](TraceStage from, TraceStage to) -> uint64_t {
+		return std::chrono::duration_cast<std::chrono::microseconds>(trace->stamps[to] - trace->stamps[from]).count();
+	};
+
+	uint64_t total = micros(TRACE_RECEIVED, TRACE_ACKED);
+	uint64_t dispatch = micros(TRACE_RECEIVED, TRACE_DISPATCHED);
+	uint64_t apply = micros(TRACE_DISPATCHED, TRACE_APPLIED);
+	uint64_t ack = micros(TRACE_APPLIED, TRACE_ACKED);
+
+	EventLatency& latency = GetEventLatency(trace->eventName);
+	latency.total.Record(total);
+	latency.dispatch.Record(dispatch);
+	latency.apply.Record(apply);
+	latency.ack.Record(ack);
+
+	if (trace->requested && event.need_ack())
+	{
+		sio::message::ptr timing = sio::object_message::create();
+		timing->get_map()["id"] = sio::string_message::create(trace->id);
+		timing->get_map()["dispatch_us"] = sio::int_message::create(dispatch);
+		timing->get_map()["apply_us"] = sio::int_message::create(apply);
+		timing->get_map()["ack_us"] = sio::int_message::create(ack);
+		timing->get_map()["total_us"] = sio::int_message::create(total);
+
+		const sio::message::list& ackMessage = event.get_ack_message();
+		if (ackMessage.size() > 0 && ackMessage[0] && ackMessage[0]->get_flag() == sio::message::flag_object)
+		{
+			ackMessage[0]->get_map()["timing"] = timing;
+		}
+		else if (ackMessage.size() == 0)
+		{
+			sio::message::ptr response = sio::object_message::create();
+			response->get_map()["timing"] = timing;
+			event.put_ack_message(response);
+		}
+	}
+
+	delete trace;
+}
+
+sio::message::ptr CommandTracer::GetLatencySummary()
+{
+	sio::message::ptr summary = sio::object_message::create();
+
+	std::lock_guard<std::mutex> guard(_lock);
+	for (const auto& latency : _latencies)
+	{
+		sio::message::ptr msg = sio::object_message::create();
+		msg->get_map()["total"] = Summarize(latency.second->total);
+		msg->get_map()["dispatch"] = Summarize(latency.second->dispatch);
+		msg->get_map()["apply"] = Summarize(latency.second->apply);
+		msg->get_map()["ack"] = Summarize(latency.second->ack);
+
+		summary->get_map()[latency.first] = msg;
+	}
+
+	return summary;
+}
+
+CommandTracer::EventLatency& CommandTracer::GetEventLatency(const std::string& eventName)
+{
+	std::lock_guard<std::mutex> guard(_lock);
+
+	std::unique_ptr<EventLatency>& latency = _latencies[eventName];
+	if (!latency)
+		latency.reset(new EventLatency());
+
+	return *latency;
+}
+
+sio::message::ptr CommandTracer::Summarize(const LatencyHistogram& histogram)
+{
+	sio::message::ptr msg = sio::object_message::create();
+	msg->get_map()["count"] = sio::int_message::create(histogram.GetCount());
+	msg->get_map()["mean_us"] = sio::double_message::create(histogram.GetMean());
+	msg->get_map()["p50_us"] = sio::int_message::create(histogram.GetPercentile(50));
+	msg->get_map()["p90_us"] = sio::int_message::create(histogram.GetPercentile(90));
+	msg->get_map()["p99_us"] = sio::int_message::create(histogram.GetPercentile(99));
+	msg->get_map()["p999_us"] = sio::int_message::create(histogram.GetPercentile(99.9));
+	msg->get_map()["max_us"] = sio::int_message::create(histogram.GetMax());
+
+	return msg;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <sio_client.h>
+
+#include "LatencyHistogram.h"
+
+enum TraceStage {
+    /**
+    * The socket handed the command to the bridge
+    */
+    TRACE_RECEIVED,
+
+    /**
+    * The payload was decoded and the flight plan looked up, EuroScope is about to be modified
+    */
+    TRACE_DISPATCHED,
+
+    /**
+    * EuroScope has applied the command
+    */
+    TRACE_APPLIED,
+
+    /**
+    * The ack is ready to go back to EXCDS
+    */
+    TRACE_ACKED,
+
+    TRACE_STAGE_COUNT
+};
+
+/**
+* End-to-end latency tracing of commands sent by EXCDS.
+*
+* Every inbound socket event is stamped as it moves through the bridge, and the durations are kept in per-event
+* histograms. If the payload contains `"trace": true`, the timing breakdown (in microseconds) is added to the ack.
+*/
+class CommandTracer
+{
+public:
+    static CommandTracer* GetInstance();
+
+    /**
+    * Starts tracing a command on the current thread.
+    */
+    void Begin(const std::string& eventName, sio::event& event);
+
+    /**
+    * Stamps a stage of the command currently being handled on this thread, if any.
+    */
+    static void Mark(TraceStage stage);
+
+    /**
+    * Finishes the command on the current thread, records its latencies and adds the timing to the ack if asked.
+    */
+    void End(sio::event& event);
+
+    /**
+    * Latency percentiles for every event seen so far.
+    */
+    sio::message::ptr GetLatencySummary();
+private:
+    struct EventLatency
+    {
+        LatencyHistogram total;
+        LatencyHistogram dispatch;
+        LatencyHistogram apply;
+        LatencyHistogram ack;
+    };
+
+    struct Trace
+    {
+        std::string eventName;
+        std::string id;
+        bool requested = false;
+        bool stamped[TRACE_STAGE_COUNT] = {};
+        std::chrono::steady_clock::time_point stamps[TRACE_STAGE_COUNT];
+    };
+
+    // The command being handled on this thread
+    static thread_local Trace* _current;
+
+    EventLatency& GetEventLatency(const std::string& eventName);
+    static sio::message::ptr Summarize(const LatencyHistogram& histogram);
+
+    std::mutex _lock;
+    std::map<std::string, std::unique_ptr<EventLatency>> _latencies;
+};
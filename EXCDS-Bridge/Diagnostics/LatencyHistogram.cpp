@@ -0,0 +1,100 @@
+#include <cmath>
+
+#include "LatencyHistogram.h"
+
+LatencyHistogram::LatencyHistogram()
+{
+	Reset();
+}
+
+void LatencyHistogram::Record(uint64_t micros)
+{
+	_buckets[BucketIndex(micros)].fetch_add(1, std::memory_order_relaxed);
+	_count.fetch_add(1, std::memory_order_relaxed);
+	_sum.fetch_add(micros, std::memory_order_relaxed);
+
+	uint64_t max = _max.load(std::memory_order_relaxed);
+	while (micros > max && !_max.compare_exchange_weak(max, micros, std::memory_order_relaxed));
+}
+
+void LatencyHistogram::Reset()
+{
+	for (int i = 0; i < BUCKET_COUNT; i++)
+		_buckets[i].store(0, std::memory_order_relaxed);
+
+	_count.store(0, std::memory_order_relaxed);
+	_sum.store(0, std::memory_order_relaxed);
+	_max.store(0, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::GetCount() const
+{
+	return _count.load(std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::GetMax() const
+{
+	return _max.load(std::memory_order_relaxed);
+}
+
+double LatencyHistogram::GetMean() const
+{
+	uint64_t count = GetCount();
+	if (count == 0) return 0;
+
+	return static_cast<double>(_sum.load(std::memory_order_relaxed)) / count;
+}
+
+uint64_t LatencyHistogram::GetPercentile(double percentile) const
+{
+	uint64_t count = GetCount();
+	if (count == 0) return 0;
+
+	// The nearest rank: the smallest value with at least the percentile of values at or below it
+	uint64_t rank = static_cast<uint64_t>(std::ceil(percentile / 100.0 * count));
+	if (rank < 1) rank = 1;
+	if (rank > count) rank = count;
+
+	uint64_t seen = 0;
+	for (int i = 0; i < BUCKET_COUNT; i++)
+	{
+		seen += _buckets[i].load(std::memory_order_relaxed);
+
+		if (seen >= rank)
+		{
+			uint64_t upper = BucketUpperBound(i);
+			uint64_t max = GetMax();
+			return upper < max ? upper : max;
+		}
+	}
+
+	return GetMax();
+}
+
+int LatencyHistogram::BucketIndex(uint64_t micros)
+{
+	if (micros < EXACT_BUCKETS) return static_cast<int>(micros);
+
+	// Position of the highest set bit, at least 5 here
+	int magnitude = 0;
+	for (uint64_t v = micros; v > 1; v >>= 1)
+		magnitude++;
+
+	if (magnitude - 5 >= MAGNITUDES) return BUCKET_COUNT - 1;
+
+	// The top 5 bits of the value (16 - 31) select the sub-bucket
+	int top = static_cast<int>(micros >> (magnitude - 4));
+
+	return EXACT_BUCKETS + (magnitude - 5) * SUB_BUCKETS + (top - SUB_BUCKETS);
+}
+
+uint64_t LatencyHistogram::BucketUpperBound(int index)
+{
+	if (index < EXACT_BUCKETS) return index;
+
+	int offset = index - EXACT_BUCKETS;
+	int magnitude = offset / SUB_BUCKETS + 5;
+	uint64_t top = offset % SUB_BUCKETS + SUB_BUCKETS;
+
+	return ((top + 1) << (magnitude - 4)) - 1;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+/**
+* HDR style histogram of latencies in microseconds.
+*
+* Values below 32us are counted exactly, everything above lands in one of 16 linear sub-buckets per power of two,
+* which keeps the error under ~6% from microseconds up to days while using a fixed amount of memory.
+* Recording is lock free and can happen from any thread.
+*/
+class LatencyHistogram
+{
+public:
+    LatencyHistogram();
+
+    void Record(uint64_t micros);
+    void Reset();
+
+    uint64_t GetCount() const;
+    uint64_t GetMax() const;
+    double GetMean() const;
+
+    /**
+    * Returns the value at the given percentile (0 - 100), accurate to the bucket resolution.
+    */
+    uint64_t GetPercentile(double percentile) const;
+private:
+    static const int EXACT_BUCKETS = 32;
+    static const int SUB_BUCKETS = 16;
+    static const int MAGNITUDES = 36;
+    static const int BUCKET_COUNT = EXACT_BUCKETS + MAGNITUDES * SUB_BUCKETS;
+
+    static int BucketIndex(uint64_t micros);
+    static uint64_t BucketUpperBound(int index);
+
+    std::atomic<uint64_t> _buckets[BUCKET_COUNT];
+    std::atomic<uint64_t> _count;
+    std::atomic<uint64_t> _sum;
+    std::atomic<uint64_t> _max;
+};
@@ -0,0 +1,165 @@
+#include <fstream>
+#include <sstream>
+#include <Windows.h>
+
+#include "Metrics.h"
+#include "CommandTracer.h"
+#include "../ApiHelper.h"
+
+const uint64_t MetricHistogram::BUCKET_BOUNDS[MetricHistogram::BUCKET_COUNT - 1] = {
+	10, 25, 50, 100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 500000, 1000000
+};
+
+void MetricHistogram::Record(uint64_t value)
+{
+	int index = 0;
+	while (index < BUCKET_COUNT - 1 && value > BUCKET_BOUNDS[index])
+		index++;
+
+	_buckets[index].fetch_add(1, std::memory_order_relaxed);
+	_count.fetch_add(1, std::memory_order_relaxed);
+	_sum.fetch_add(value, std::memory_order_relaxed);
+}
+
+MetricTimer::~MetricTimer()
+{
+	_histogram.Record(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - _start).count());
+}
+
+Metrics* Metrics::GetInstance()
+{
+	static Metrics metrics;
+	return &metrics;
+}
+
+MetricCounter& Metrics::Counter(const std::string& name)
+{
+	std::lock_guard<std::mutex> guard(_lock);
+
+	std::unique_ptr<MetricCounter>& counter = _counters[name];
+	if (!counter) counter.reset(new MetricCounter());
+
+	return *counter;
+}
+
+MetricGauge& Metrics::Gauge(const std::string& name)
+{
+	std::lock_guard<std::mutex> guard(_lock);
+
+	std::unique_ptr<MetricGauge>& gauge = _gauges[name];
+	if (!gauge) gauge.reset(new MetricGauge());
+
+	return *gauge;
+}
+
+MetricHistogram& Metrics::Histogram(const std::string& name)
+{
+	std::lock_guard<std::mutex> guard(_lock);
+
+	std::unique_ptr<MetricHistogram>& histogram = _histograms[name];
+	if (!histogram) histogram.reset(new MetricHistogram());
+
+	return *histogram;
+}
+
+void Metrics::CountException(const char* handler, const char* message)
+{
+	GetInstance()->Counter(std::string("exceptions.") + handler).Increment();
+	GetInstance()->Counter("exceptions.total").Increment();
+
+	OutputDebugString(message);
+}
+
+sio::message::ptr Metrics::Snapshot()
+{
+	sio::message::ptr snapshot = sio::object_message::create();
+	sio::message::ptr counters = sio::object_message::create();
+	sio::message::ptr gauges = sio::object_message::create();
+	sio::message::ptr histograms = sio::object_message::create();
+
+	{
+		std::lock_guard<std::mutex> guard(_lock);
+
+		for (const auto& counter : _counters)
+			counters->get_map()[counter.first] = sio::int_message::create(counter.second->Get());
+
+		for (const auto& gauge : _gauges)
+			gauges->get_map()[gauge.first] = sio::int_message::create(gauge.second->Get());
+
+		for (const auto& histogram : _histograms)
+		{
+			sio::message::ptr msg = sio::object_message::create();
+			sio::message::ptr buckets = sio::array_message::create();
+
+			for (int i = 0; i < MetricHistogram::BUCKET_COUNT; i++)
+			{
+				sio::message::ptr bucket = sio::object_message::create();
+				if (i < MetricHistogram::BUCKET_COUNT - 1)
+					bucket->get_map()["le"] = sio::int_message::create(MetricHistogram::BUCKET_BOUNDS[i]);
+				else
+					bucket->get_map()["le"] = sio::string_message::create("inf");
+				bucket->get_map()["count"] = sio::int_message::create(histogram.second->GetBucket(i));
+
+				buckets->get_vector().push_back(bucket);
+			}
+
+			msg->get_map()["count"] = sio::int_message::create(histogram.second->GetCount());
+			msg->get_map()["sum"] = sio::int_message::create(histogram.second->GetSum());
+			msg->get_map()["buckets"] = buckets;
+
+			histograms->get_map()[histogram.first] = msg;
+		}
+	}
+
+	snapshot->get_map()["counters"] = counters;
+	snapshot->get_map()["gauges"] = gauges;
+	snapshot->get_map()["histograms"] = histograms;
+	snapshot->get_map()["command_latency"] = CommandTracer::GetInstance()->GetLatencySummary();
+
+	return snapshot;
+}
+
+std::string Metrics::ToText()
+{
+	std::ostringstream text;
+
+	std::lock_guard<std::mutex> guard(_lock);
+
+	for (const auto& counter : _counters)
+		text << counter.first << " " << counter.second->Get() << "\n";
+
+	for (const auto& gauge : _gauges)
+		text << gauge.first << " " << gauge.second->Get() << "\n";
+
+	for (const auto& histogram : _histograms)
+	{
+		uint64_t count = histogram.second->GetCount();
+
+		text << histogram.first << " count=" << count;
+		if (count > 0)
+			text << " mean=" << histogram.second->GetSum() / count;
+
+		for (int i = 0; i < MetricHistogram::BUCKET_COUNT; i++)
+		{
+			uint64_t bucket = histogram.second->GetBucket(i);
+			if (bucket == 0) continue;
+
+			if (i < MetricHistogram::BUCKET_COUNT - 1)
+				text << " le" << MetricHistogram::BUCKET_BOUNDS[i] << "=" << bucket;
+			else
+				text << " inf=" << bucket;
+		}
+
+		text << "\n";
+	}
+
+	return text.str();
+}
+
+void Metrics::DumpToFile()
+{
+	std::ofstream file(ApiHelper::GetPluginDirectory() + "EXCDS-Bridge-metrics.txt", std::ios::trunc);
+	if (!file.is_open()) return;
+
+	file << ToText();
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <sio_client.h>
+
+class MetricCounter
+{
+public:
+    void Increment(uint64_t by = 1) { _value.fetch_add(by, std::memory_order_relaxed); }
+    uint64_t Get() const { return _value.load(std::memory_order_relaxed); }
+private:
+    std::atomic<uint64_t> _value{ 0 };
+};
+
+class MetricGauge
+{
+public:
+    void Set(int64_t value) { _value.store(value, std::memory_order_relaxed); }
+    void Add(int64_t by) { _value.fetch_add(by, std::memory_order_relaxed); }
+    int64_t Get() const { return _value.load(std::memory_order_relaxed); }
+private:
+    std::atomic<int64_t> _value{ 0 };
+};
+
+/**
+* Histogram with fixed bucket bounds, in microseconds (or any unit the caller picks).
+*/
+class MetricHistogram
+{
+public:
+    static const int BUCKET_COUNT = 17;
+    static const uint64_t BUCKET_BOUNDS[BUCKET_COUNT - 1];
+
+    void Record(uint64_t value);
+
+    uint64_t GetCount() const { return _count.load(std::memory_order_relaxed); }
+    uint64_t GetSum() const { return _sum.load(std::memory_order_relaxed); }
+    uint64_t GetBucket(int index) const { return _buckets[index].load(std::memory_order_relaxed); }
+private:
+    std::atomic<uint64_t> _buckets[BUCKET_COUNT] = {};
+    std::atomic<uint64_t> _count{ 0 };
+    std::atomic<uint64_t> _sum{ 0 };
+};
+
+/**
+* Records the time between its construction and destruction into a histogram, in microseconds.
+*/
+class MetricTimer
+{
+public:
+    MetricTimer(MetricHistogram& histogram) : _histogram(histogram), _start(std::chrono::steady_clock::now()) {};
+    ~MetricTimer();
+private:
+    MetricHistogram& _histogram;
+    std::chrono::steady_clock::time_point _start;
+};
+
+/**
+* Registry of the bridge's counters, gauges and histograms.
+*
+* Metrics are created the first time they are asked for and live until the plugin unloads, so hot paths can keep a
+* reference to them. Updating a metric is a single relaxed atomic operation; the registry is only locked when a
+* metric is looked up by name or read.
+*/
+class Metrics
+{
+public:
+    static Metrics* GetInstance();
+
+    MetricCounter& Counter(const std::string& name);
+    MetricGauge& Gauge(const std::string& name);
+    MetricHistogram& Histogram(const std::string& name);
+
+    /**
+    * Counts an exception swallowed by a handler and logs it to the debugger.
+    */
+    static void CountException(const char* handler, const char* message);
+
+    sio::message::ptr Snapshot();
+    std::string ToText();
+
+    /**
+    * Writes the text dump next to the plugin DLL.
+    */
+    void DumpToFile();
+private:
+    std::mutex _lock;
+    std::map<std::string, std::unique_ptr<MetricCounter>> _counters;
+    std::map<std::string, std::unique_ptr<MetricGauge>> _gauges;
+    std::map<std::string, std::unique_ptr<MetricHistogram>> _histograms;
+};
@@ -0,0 +1,105 @@
+#include "Profiler.h"
+
+#ifndef EXCDS_LEAN
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <Windows.h>
+
+#include "../ApiHelper.h"
+
+thread_local Profiler::ThreadBuffer* Profiler::_threadBuffer = nullptr;
+
+Profiler* Profiler::GetInstance()
+{
+	static Profiler profiler;
+	return &profiler;
+}
+
+int64_t Profiler::Now()
+{
+	static const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+const char* Profiler::Intern(const std::string& name)
+{
+	std::lock_guard<std::mutex> guard(_lock);
+	return _names.insert(name).first->c_str();
+}
+
+Profiler::ThreadBuffer* Profiler::GetThreadBuffer()
+{
+	if (_threadBuffer) return _threadBuffer;
+
+	std::unique_ptr<ThreadBuffer> buffer(new ThreadBuffer());
+	buffer->threadId = GetCurrentThreadId();
+
+	std::lock_guard<std::mutex> guard(_lock);
+	_threadBuffer = buffer.get();
+	_buffers.push_back(std::move(buffer));
+
+	return _threadBuffer;
+}
+
+void Profiler::Record(const char* name, int64_t start, int64_t duration)
+{
+	ThreadBuffer* buffer = GetThreadBuffer();
+	uint64_t head = buffer->head.load(std::memory_order_relaxed);
+
+	Zone& zone = buffer->zones[head % RING_SIZE];
+	zone.name = name;
+	zone.start = start;
+	zone.duration = duration;
+
+	buffer->head.store(head + 1, std::memory_order_release);
+}
+
+std::string Profiler::ToChromeTrace(size_t* eventCount)
+{
+	std::ostringstream json;
+	size_t count = 0;
+
+	json << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+	std::lock_guard<std::mutex> guard(_lock);
+
+	for (const auto& buffer : _buffers)
+	{
+		uint64_t head = buffer->head.load(std::memory_order_acquire);
+
+		// The owning thread keeps writing while we read, so leave out the slot it may be overwriting
+		uint64_t available = std::min<uint64_t>(head, RING_SIZE - 1);
+
+		for (uint64_t i = head - available; i < head; i++)
+		{
+			const Zone& zone = buffer->zones[i % RING_SIZE];
+
+			json << (count ? "," : "") << "{\"name\":\"" << zone.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->threadId
+				<< ",\"ts\":" << zone.start << ",\"dur\":" << zone.duration << "}";
+			count++;
+		}
+	}
+
+	json << "]}";
+
+	if (eventCount) *eventCount = count;
+
+	return json.str();
+}
+
+std::string Profiler::DumpToFile(size_t* eventCount)
+{
+	std::string path = ApiHelper::GetPluginDirectory() + "EXCDS-Bridge-trace.json";
+
+	std::ofstream file(path, std::ios::trunc);
+	if (!file.is_open()) return "";
+
+	file << ToChromeTrace(eventCount);
+
+	return path;
+}
+
+#endif
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+/**
+* Timeline profiler for the bridge, written out in the Chrome trace-event format (chrome://tracing, Perfetto).
+*
+* Code marks a zone with PROFILE_ZONE("Name"); the zone is recorded when it goes out of scope. Every thread writes
+* into its own fixed-size ring buffer, so recording never takes a lock and only the newest zones are kept.
+*
+* Building with EXCDS_LEAN defined compiles the profiler out entirely: the zones expand to nothing and nothing is
+* recorded or registered.
+*/
+#ifndef EXCDS_LEAN
+
+class Profiler
+{
+public:
+    static const size_t RING_SIZE = 16384;
+
+    static Profiler* GetInstance();
+
+    /**
+    * Microseconds since the profiler started.
+    */
+    static int64_t Now();
+
+    /**
+    * Returns a name that lives as long as the plugin, for zones whose name is built at runtime.
+    */
+    const char* Intern(const std::string& name);
+
+    void Record(const char* name, int64_t start, int64_t duration);
+
+    /**
+    * The recorded zones of every thread, as a Chrome trace JSON document.
+    */
+    std::string ToChromeTrace(size_t* eventCount = nullptr);
+
+    /**
+    * Writes the trace next to the plugin DLL and returns the path written, or an empty string on failure.
+    */
+    std::string DumpToFile(size_t* eventCount = nullptr);
+private:
+    struct Zone
+    {
+        const char* name;
+        int64_t start;
+        int64_t duration;
+    };
+
+    struct ThreadBuffer
+    {
+        uint32_t threadId;
+        std::atomic<uint64_t> head{ 0 };
+        Zone zones[RING_SIZE];
+    };
+
+    ThreadBuffer* GetThreadBuffer();
+
+    // The ring buffer of the calling thread
+    static thread_local ThreadBuffer* _threadBuffer;
+
+    std::mutex _lock;
+    std::vector<std::unique_ptr<ThreadBuffer>> _buffers;
+    std::set<std::string> _names;
+};
+
+class ProfileZone
+{
+public:
+    ProfileZone(const char* name) : _name(name), _start(Profiler::Now()) {};
+    ~ProfileZone() { Profiler::GetInstance()->Record(_name, _start, Profiler::Now() - _start); };
+private:
+    const char* _name;
+    int64_t _start;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_ZONE(name) ProfileZone PROFILE_CONCAT(_profileZone, __LINE__)(name)
+
+#else
+
+#define PROFILE_ZONE(name)
+
+#endif
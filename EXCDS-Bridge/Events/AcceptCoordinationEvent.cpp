@@ -0,0 +1,10 @@
+#include "AcceptCoordinationEvent.h"
+#include "sio_client.h"
+
+void AcceptCoordinationEvent::ExecuteEvent(sio::event& event, EuroScopePlugIn::CFlightPlan flightPlan)
+{
+	flightPlan.AcceptCoordination();
+
+	// Tell EXCDS the change is done
+	SendModified(event);
+}
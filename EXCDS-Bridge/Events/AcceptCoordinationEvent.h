@@ -0,0 +1,13 @@
+#pragma once
+#include "ExcdsEvent.h"
+
+class AcceptCoordinationEvent :
+    public ExcdsEvent
+{
+public:
+    AcceptCoordinationEvent() : ExcdsEvent(FLIGHT_PLAN_CHECK_EXISTS) {};
+
+    static const char* Name() { return "ACCEPT_COORD"; }
+protected:
+    void ExecuteEvent(sio::event&, EuroScopePlugIn::CFlightPlan) override;
+};
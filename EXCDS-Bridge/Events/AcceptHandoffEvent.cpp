@@ -0,0 +1,10 @@
+#include "AcceptHandoffEvent.h"
+#include "sio_client.h"
+
+void AcceptHandoffEvent::ExecuteEvent(sio::event& event, EuroScopePlugIn::CFlightPlan flightPlan)
+{
+	flightPlan.AcceptHandoff();
+
+	// Tell EXCDS the change is done
+	SendModified(event);
+}
@@ -0,0 +1,13 @@
+#pragma once
+#include "ExcdsEvent.h"
+
+class AcceptHandoffEvent :
+    public ExcdsEvent
+{
+public:
+    AcceptHandoffEvent() : ExcdsEvent(FLIGHT_PLAN_CHECK_EXISTS) {};
+
+    static const char* Name() { return "ACCEPT_HANDOFF"; }
+protected:
+    void ExecuteEvent(sio::event&, EuroScopePlugIn::CFlightPlan) override;
+};
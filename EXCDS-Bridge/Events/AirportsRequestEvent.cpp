@@ -0,0 +1,13 @@
+#include "AirportsRequestEvent.h"
+#include "../Airspace/AirportIndex.h"
+#include "sio_client.h"
+
+/**
+* Sends every active airport and its runways as SEND_AIRPORT_DATA. Changes after that arrive as AIRPORT_ACTIVITY_DELTA.
+*/
+void AirportsRequestEvent::ExecuteEvent(sio::event& event, EuroScopePlugIn::CFlightPlan flightPlan)
+{
+	CEXCDSBridge::Emit("SEND_AIRPORT_DATA", AirportIndex::GetInstance()->ToMessage());
+
+	SendDone(event);
+}
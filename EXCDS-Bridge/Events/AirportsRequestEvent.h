@@ -0,0 +1,13 @@
+#pragma once
+#include "ExcdsEvent.h"
+
+class AirportsRequestEvent :
+    public ExcdsEvent
+{
+public:
+    AirportsRequestEvent() : ExcdsEvent(FLIGHT_PLAN_CHECK_NONE) {};
+
+    static const char* Name() { return "REQUEST_AIRPORT_DATA"; }
+protected:
+    void ExecuteEvent(sio::event&, EuroScopePlugIn::CFlightPlan) override;
+};
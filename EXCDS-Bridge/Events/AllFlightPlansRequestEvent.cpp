@@ -0,0 +1,16 @@
+#include "AllFlightPlansRequestEvent.h"
+#include "../MessageHandler.h"
+#include "sio_client.h"
+
+void AllFlightPlansRequestEvent::ExecuteEvent(sio::event& event, EuroScopePlugIn::CFlightPlan flightPlan)
+{
+	for (EuroScopePlugIn::CFlightPlan fp = _bridgeInstance->FlightPlanSelectFirst(); fp.IsValid(); fp = _bridgeInstance->FlightPlanSelectNext(fp))
+	{
+		sio::message::ptr response = sio::object_message::create();
+		MessageHandler::PrepareFlightPlanDataResponse(fp, response);
+
+		CEXCDSBridge::Emit("SEND_ALL_FP_DATA", response);
+	}
+
+	SendDone(event);
+}
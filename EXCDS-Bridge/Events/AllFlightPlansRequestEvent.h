@@ -0,0 +1,13 @@
+#pragma once
+#include "ExcdsEvent.h"
+
+class AllFlightPlansRequestEvent :
+    public ExcdsEvent
+{
+public:
+    AllFlightPlansRequestEvent() : ExcdsEvent(FLIGHT_PLAN_CHECK_NONE) {};
+
+    static const char* Name() { return "REQUEST_ALL_FP_DATA"; }
+protected:
+    void ExecuteEvent(sio::event&, EuroScopePlugIn::CFlightPlan) override;
+};
@@ -1,20 +1,39 @@
 #include "AltitudeUpdateEvent.h"
 #include "../Response/ExcdsResponse.h"
+#include "../Diagnostics/Metrics.h"
 #include "sio_client.h"
 
-void AltitudeUpdateEvent::ExecuteEvent(sio::event& event, EuroScopePlugIn::CFlightPlan flightPlan)
+/**
+* Event payload:
+*
+* {
+*	"callsign": "AAL123",
+*	"id": "...",
+*	"cleared": 24000,
+*	"final": -1,
+*	"coordinated": -1,
+*	"reported": ""
+* }
+*/
+
+AltitudeUpdateEvent::AltitudeUpdateEvent()
 {
-	try {
-		// Get aircraft data from EXCDS
-		std::string callsign = flightPlan.GetCallsign();
-
-		std::map<std::string, sio::message::ptr> e = GetMessageValue(event);
-		std::string id = e["id"]->get_string();
-		int cleared = e["cleared"]->get_int();
-		int final = e["final"]->get_int();
-		int coordinated = e["coordinated"]->get_int();
+	_schema
+		.String("id", &AltitudeUpdatePayload::id, false)
+		.Integer("cleared", &AltitudeUpdatePayload::cleared)
+		.Integer("final", &AltitudeUpdatePayload::final)
+		.Integer("coordinated", &AltitudeUpdatePayload::coordinated)
 		// Reported altitude, goes to strip annotations for situ
-		std::string reported = e["reported"]->get_string();
+		.String("reported", &AltitudeUpdatePayload::reported, false);
+}
+
+void AltitudeUpdateEvent::ExecuteEvent(sio::event& event, EuroScopePlugIn::CFlightPlan flightPlan, const AltitudeUpdatePayload& payload)
+{
+	try {
+		int cleared = payload.cleared;
+		int final = payload.final;
+		int coordinated = payload.coordinated;
+		const std::string& reported = payload.reported;
 
 		if (cleared != -1) {
 			flightPlan.GetControllerAssignedData().SetClearedAltitude(cleared);
@@ -33,12 +52,13 @@ void AltitudeUpdateEvent::ExecuteEvent(sio::event& event, EuroScopePlugIn::CFlig
 			flightPlan.GetControllerAssignedData().SetFlightStripAnnotation(8, reported.c_str());
 		}
 
-		flightPlan.GetFlightPlanData().AmendFlightPlan();
+		Amend(flightPlan);
 
 		// Tell EXCDS the change is done
 		SendModified(event);
 	}
 	catch (...) {
+		Metrics::CountException("AltitudeUpdateEvent", "EXCDS Error: Update altitude error");
 		CEXCDSBridge::SendEuroscopeMessage(flightPlan.GetCallsign(), ALT_EXCEPTION);
 	}
 }
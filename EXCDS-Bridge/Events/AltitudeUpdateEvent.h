@@ -1,10 +1,25 @@
 #pragma once
-#include "ExcdsEvent.h"
+#include "TypedExcdsEvent.h"
+
+/**
+* Altitudes of -1 and an empty reported altitude are left as they are.
+*/
+struct AltitudeUpdatePayload
+{
+    std::string id;
+    int cleared = -1;
+    int final = -1;
+    int coordinated = -1;
+    std::string reported;
+};
 
 class AltitudeUpdateEvent :
-    public ExcdsEvent
+    public TypedExcdsEvent<AltitudeUpdatePayload>
 {
 public:
-    void ExecuteEvent(sio::event&, EuroScopePlugIn::CFlightPlan) override;
-};
+    AltitudeUpdateEvent();
 
+    static const char* Name() { return "UPDATE_ALTITUDE"; }
+protected:
+    void ExecuteEvent(sio::event&, EuroScopePlugIn::CFlightPlan, const AltitudeUpdatePayload&) override;
+};
@@ -0,0 +1,61 @@
+#include "AmendmentCoalescer.h"
+#include "../CEXCDSBridge.h"
+#include "../Diagnostics/Metrics.h"
+
+AmendmentCoalescer* AmendmentCoalescer::GetInstance()
+{
+	static AmendmentCoalescer coalescer;
+	return &coalescer;
+}
+
+void AmendmentCoalescer::Request(const std::string& callsign)
+{
+	static MetricCounter& requested = Metrics::GetInstance()->Counter("amendments.requested");
+	requested.Increment();
+
+	if (callsign.empty()) return;
+
+	std::lock_guard<std::mutex> guard(_lock);
+	_pending.insert(callsign);
+}
+
+size_t AmendmentCoalescer::Flush()
+{
+	static MetricCounter& made = Metrics::GetInstance()->Counter("amendments.made");
+
+	std::unordered_set<std::string> pending;
+
+	{
+		std::lock_guard<std::mutex> guard(_lock);
+		if (_pending.empty()) return 0;
+
+		pending.swap(_pending);
+	}
+
+	CEXCDSBridge* bridgeInstance = CEXCDSBridge::GetInstance();
+	size_t amended = 0;
+
+	for (const std::string& callsign : pending)
+	{
+		try {
+			// The aircraft may have disconnected since
+			EuroScopePlugIn::CFlightPlan fp = bridgeInstance->FlightPlanSelect(callsign.c_str());
+			if (!fp.IsValid()) continue;
+
+			fp.GetFlightPlanData().AmendFlightPlan();
+			amended++;
+		}
+		catch (...) {
+			Metrics::CountException("AmendmentCoalescer", "EXCDS Error: Failed to amend flight plan");
+		}
+	}
+
+	made.Increment(amended);
+	return amended;
+}
+
+size_t AmendmentCoalescer::GetPending()
+{
+	std::lock_guard<std::mutex> guard(_lock);
+	return _pending.size();
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <unordered_set>
+
+/**
+* Holds back flight plan amendments so that each aircraft is amended at most once a tick.
+*
+* Amending makes EuroScope re-extract the route, send the flight plan to the network and call our own flight plan
+* callbacks, which send it on to EXCDS. Events that change an aircraft only mark it as pending here, and every pending
+* aircraft is amended once when OnTimer flushes, on the EuroScope thread. Several commands for one aircraft within a
+* second are sent out as a single amendment.
+*/
+class AmendmentCoalescer
+{
+public:
+    static AmendmentCoalescer* GetInstance();
+
+    void Request(const std::string& callsign);
+
+    /**
+    * Amends every pending aircraft that still has a flight plan. Returns how many were amended.
+    */
+    size_t Flush();
+
+    size_t GetPending();
+private:
+    std::mutex _lock;
+    std::unordered_set<std::string> _pending;
+};
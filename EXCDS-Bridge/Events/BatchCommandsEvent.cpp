@@ -0,0 +1,132 @@
+#include <utility>
+
+#include "BatchCommandsEvent.h"
+#include "LocalEvent.h"
+#include "sio_client.h"
+
+/**
+* Event payload, each operation being the payload of the event it names:
+*
+* {
+*	"operations": [
+*		{ "event": "UPDATE_ALTITUDE", "callsign": "AAL123", "cleared": 24000, ... },
+*		{ "event": "UPDATE_SCRATCHPAD", "callsign": "AAL123", "value": "..." }
+*	]
+* }
+*
+* The ack lists the result of each operation in the order they were sent:
+*
+* {
+*	"modified": true,
+*	"applied": 2,
+*	"failed": 0,
+*	"results": [{ "event": "UPDATE_ALTITUDE", "callsign": "AAL123", "ack": { "modified": true, ... } }, ...]
+* }
+*/
+
+BatchCommandsEvent::BatchCommandsEvent()
+	: TypedExcdsEvent(FLIGHT_PLAN_CHECK_NONE)
+{
+	_schema.Array("operations", &BatchCommandsPayload::operations);
+}
+
+static std::string GetString(const sio::message::ptr& operation, const char* key)
+{
+	if (!operation || operation->get_flag() != sio::message::flag_object) return "";
+
+	auto value = operation->get_map().find(key);
+	if (value == operation->get_map().end() || !value->second || value->second->get_flag() != sio::message::flag_string) return "";
+
+	return value->second->get_string();
+}
+
+void BatchCommandsEvent::ExecuteEvent(sio::event& event, EuroScopePlugIn::CFlightPlan flightPlan, const BatchCommandsPayload& payload)
+{
+	const std::vector<sio::message::ptr>& operations = payload.operations->get_vector();
+
+	// Operations grouped by callsign, in the order each aircraft first appears
+	std::vector<std::pair<std::string, std::vector<size_t>>> aircraft;
+
+	for (size_t i = 0; i < operations.size(); i++)
+	{
+		std::string callsign = GetString(operations[i], "callsign");
+
+		auto group = aircraft.begin();
+		while (group != aircraft.end() && group->first != callsign)
+			group++;
+
+		if (group == aircraft.end())
+		{
+			aircraft.push_back(std::make_pair(callsign, std::vector<size_t>()));
+			group = aircraft.end() - 1;
+		}
+
+		group->second.push_back(i);
+	}
+
+	std::vector<sio::message::ptr> results(operations.size());
+	int applied = 0;
+
+	for (const auto& group : aircraft)
+	{
+		EuroScopePlugIn::CFlightPlan fp;
+		if (!group.first.empty())
+			fp = _bridgeInstance->FlightPlanSelect(group.first.c_str());
+
+		for (size_t i : group.second)
+		{
+			std::string eventName = GetString(operations[i], "event");
+			ExcdsEvent* target = eventName == Name() ? nullptr : ExcdsEvent::Find(eventName);
+
+			sio::message::ptr result = sio::object_message::create();
+			result->get_map()["event"] = sio::string_message::create(eventName);
+			result->get_map()["callsign"] = sio::string_message::create(group.first);
+
+			if (!target)
+			{
+				sio::message::ptr ack = sio::object_message::create();
+				ack->get_map()["modified"] = sio::bool_message::create(false);
+				ack->get_map()["reason"] = sio::string_message::create("Unknown event.");
+
+				result->get_map()["ack"] = ack;
+			}
+			else
+			{
+				LocalEvent operation(eventName, operations[i]);
+				target->TriggerBatched(operation, fp);
+
+				sio::message::ptr ack = operation.get_ack_message().size() > 0 ? operation.get_ack_message()[0] : sio::null_message::create();
+				result->get_map()["ack"] = ack;
+
+				// Requests are acked with true, commands with whether they modified the flight plan
+				bool modified = false;
+				if (ack->get_flag() == sio::message::flag_boolean)
+				{
+					modified = ack->get_bool();
+				}
+				else if (ack->get_flag() == sio::message::flag_object)
+				{
+					auto modifiedFlag = ack->get_map().find("modified");
+					modified = modifiedFlag != ack->get_map().end() && modifiedFlag->second->get_flag() == sio::message::flag_boolean && modifiedFlag->second->get_bool();
+				}
+
+				if (modified)
+					applied++;
+			}
+
+			results[i] = result;
+		}
+	}
+
+	sio::message::ptr resultList = sio::array_message::create();
+	resultList->get_vector() = results;
+
+	_response->get_map()["applied"] = sio::int_message::create(applied);
+	_response->get_map()["failed"] = sio::int_message::create(operations.size() - applied);
+	_response->get_map()["results"] = resultList;
+
+	if (applied > 0)
+		SendModified(event);
+	else
+		SendNotModified(event, "No operation was applied.");
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include "TypedExcdsEvent.h"
+
+struct BatchCommandsPayload
+{
+    sio::message::ptr operations;
+};
+
+/**
+* Applies several commands in one go. Operations are grouped by callsign, and each aircraft's flight plan is looked
+* up once. Operations for an aircraft run in the order they were sent, and their amendments are coalesced into one.
+*/
+class BatchCommandsEvent :
+    public TypedExcdsEvent<BatchCommandsPayload>
+{
+public:
+    BatchCommandsEvent();
+
+    static const char* Name() { return "BATCH_COMMANDS"; }
+protected:
+    void ExecuteEvent(sio::event&, EuroScopePlugIn::CFlightPlan, const BatchCommandsPayload&) override;
+};
@@ -0,0 +1,62 @@
+#include "ConflictParametersUpdateEvent.h"
+#include "../Surveillance/ConflictDetector.h"
+#include "sio_client.h"
+
+/**
+* Event payload:
+*
+* {
+*	"lateralMinimum": 3,
+*	"verticalMinimum": 1000,
+*	"lookAhead": 90
+* }
+*
+* Lateral minimum in nautical miles, vertical minimum in feet, look-ahead in seconds. Every field is optional, and
+* those that are sent must be more than 0.
+*/
+
+ConflictParametersUpdateEvent::ConflictParametersUpdateEvent()
+	: TypedExcdsEvent(FLIGHT_PLAN_CHECK_NONE)
+{
+	_schema
+		.Double("lateralMinimum", &ConflictParametersUpdatePayload::lateralMinimum, false)
+		.Integer("verticalMinimum", &ConflictParametersUpdatePayload::verticalMinimum, false)
+		.Integer("lookAhead", &ConflictParametersUpdatePayload::lookAhead, false);
+}
+
+void ConflictParametersUpdateEvent::ExecuteEvent(sio::event& event, EuroScopePlugIn::CFlightPlan flightPlan, const ConflictParametersUpdatePayload& payload)
+{
+	std::vector<std::string> errors;
+
+	bool lateralSent = payload.lateralMinimum != -DBL_MAX;
+	bool verticalSent = payload.verticalMinimum != INT_MIN;
+	bool lookAheadSent = payload.lookAhead != INT_MIN;
+
+	if (lateralSent && (payload.lateralMinimum <= 0 || payload.lateralMinimum > 20))
+		errors.push_back("'lateralMinimum' must be more than 0 and at most 20 nautical miles.");
+
+	if (verticalSent && (payload.verticalMinimum <= 0 || payload.verticalMinimum > 5000))
+		errors.push_back("'verticalMinimum' must be more than 0 and at most 5000 feet.");
+
+	// The grid cells grow with the look-ahead, so a long one compares most of the traffic with each other
+	if (lookAheadSent && (payload.lookAhead <= 0 || payload.lookAhead > 600))
+		errors.push_back("'lookAhead' must be more than 0 and at most 600 seconds.");
+
+	if (!errors.empty())
+	{
+		SendInvalid(event, errors);
+		return;
+	}
+
+	ConflictDetector* detector = ConflictDetector::GetInstance();
+	ConflictParameters parameters = detector->GetParameters();
+
+	if (lateralSent) parameters.lateralMinimum = payload.lateralMinimum;
+	if (verticalSent) parameters.verticalMinimum = payload.verticalMinimum;
+	if (lookAheadSent) parameters.lookAhead = payload.lookAhead;
+
+	detector->SetParameters(parameters);
+
+	// Tell EXCDS the change is done
+	SendModified(event);
+}
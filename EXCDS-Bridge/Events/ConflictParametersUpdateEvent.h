@@ -0,0 +1,25 @@
+#pragma once
+#include <cfloat>
+#include <climits>
+#include "TypedExcdsEvent.h"
+
+/**
+* Fields that are not sent are left as they are.
+*/
+struct ConflictParametersUpdatePayload
+{
+    double lateralMinimum = -DBL_MAX;
+    int verticalMinimum = INT_MIN;
+    int lookAhead = INT_MIN;
+};
+
+class ConflictParametersUpdateEvent :
+    public TypedExcdsEvent<ConflictParametersUpdatePayload>
+{
+public:
+    ConflictParametersUpdateEvent();
+
+    static const char* Name() { return "UPDATE_CONFLICT_PARAMETERS"; }
+protected:
+    void ExecuteEvent(sio::event&, EuroScopePlugIn::CFlightPlan, const ConflictParametersUpdatePayload&) override;
+};
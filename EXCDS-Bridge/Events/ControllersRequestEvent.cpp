@@ -0,0 +1,13 @@
+#include "ControllersRequestEvent.h"
+#include "../Airspace/ControllerRoster.h"
+#include "sio_client.h"
+
+/**
+* Sends the whole controller roster as SEND_CTRLR_DATA. Changes after that arrive as CONTROLLER_DELTA.
+*/
+void ControllersRequestEvent::ExecuteEvent(sio::event& event, EuroScopePlugIn::CFlightPlan flightPlan)
+{
+	CEXCDSBridge::Emit("SEND_CTRLR_DATA", ControllerRoster::GetInstance()->ToMessage());
+
+	SendDone(event);
+}
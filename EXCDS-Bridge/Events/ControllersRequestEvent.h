@@ -0,0 +1,13 @@
+#pragma once
+#include "ExcdsEvent.h"
+
+class ControllersRequestEvent :
+    public ExcdsEvent
+{
+public:
+    ControllersRequestEvent() : ExcdsEvent(FLIGHT_PLAN_CHECK_NONE) {};
+
+    static const char* Name() { return "REQUEST_CTRLR_DATA"; }
+protected:
+    void ExecuteEvent(sio::event&, EuroScopePlugIn::CFlightPlan) override;
+};
@@ -0,0 +1,33 @@
+#include "CorrelateTargetEvent.h"
+#include "sio_client.h"
+
+/**
+* Event payload:
+*
+* {
+*	"callsign": "AAL123",
+*	"id": "..."
+* }
+*/
+
+CorrelateTargetEvent::CorrelateTargetEvent()
+	: TypedExcdsEvent(FLIGHT_PLAN_CHECK_EXISTS)
+{
+	// System ID of the radar target to correlate with
+	_schema.String("id", &CorrelateTargetPayload::id);
+}
+
+void CorrelateTargetEvent::ExecuteEvent(sio::event& event, EuroScopePlugIn::CFlightPlan flightPlan, const CorrelateTargetPayload& payload)
+{
+	EuroScopePlugIn::CRadarTarget radarTarget = _bridgeInstance->RadarTargetSelect(payload.id.c_str());
+
+	if (!radarTarget.IsValid()) {
+		SendNotModified(event, "Radar target not found.");
+		return;
+	}
+
+	flightPlan.CorrelateWithRadarTarget(radarTarget);
+
+	// Tell EXCDS the change is done
+	SendModified(event);
+}
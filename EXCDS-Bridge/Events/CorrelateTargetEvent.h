@@ -0,0 +1,18 @@
+#pragma once
+#include "TypedExcdsEvent.h"
+
+struct CorrelateTargetPayload
+{
+    std::string id;
+};
+
+class CorrelateTargetEvent :
+    public TypedExcdsEvent<CorrelateTargetPayload>
+{
+public:
+    CorrelateTargetEvent();
+
+    static const char* Name() { return "CORRELATE_TARGET"; }
+protected:
+    void ExecuteEvent(sio::event&, EuroScopePlugIn::CFlightPlan, const CorrelateTargetPayload&) override;
+};
@@ -0,0 +1,18 @@
+#include "DecorrelateTargetEvent.h"
+#include "sio_client.h"
+
+void DecorrelateTargetEvent::ExecuteEvent(sio::event& event, EuroScopePlugIn::CFlightPlan flightPlan)
+{
+	// The radar target is looked up by its callsign, it may not have a flight plan
+	EuroScopePlugIn::CRadarTarget radarTarget = _bridgeInstance->RadarTargetSelect(GetCallsign(event).c_str());
+
+	if (!radarTarget.IsValid()) {
+		SendNotModified(event, "Radar target not found.");
+		return;
+	}
+
+	radarTarget.Uncorrelate();
+
+	// Tell EXCDS the change is done
+	SendModified(event);
+}
@@ -0,0 +1,13 @@
+#pragma once
+#include "ExcdsEvent.h"
+
+class DecorrelateTargetEvent :
+    public ExcdsEvent
+{
+public:
+    DecorrelateTargetEvent() : ExcdsEvent(FLIGHT_PLAN_CHECK_NONE) {};
+
+    static const char* Name() { return "DECORRELATE_TARGET"; }
+protected:
+    void ExecuteEvent(sio::event&, EuroScopePlugIn::CFlightPlan) override;
+};
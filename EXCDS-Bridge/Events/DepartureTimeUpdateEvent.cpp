@@ -0,0 +1,33 @@
+#include "DepartureTimeUpdateEvent.h"
+#include "sio_client.h"
+
+/**
+* Event payload:
+*
+* {
+*	"callsign": "AAL123",
+*	"value": "1430"
+* }
+*/
+
+DepartureTimeUpdateEvent::DepartureTimeUpdateEvent()
+{
+	_schema.String("value", &DepartureTimeUpdatePayload::value);
+}
+
+void DepartureTimeUpdateEvent::ExecuteEvent(sio::event& event, EuroScopePlugIn::CFlightPlan flightPlan, const DepartureTimeUpdatePayload& payload)
+{
+	bool isAssigned = flightPlan.GetFlightPlanData().SetEstimatedDepartureTime(payload.value.c_str());
+
+	if (!isAssigned) {
+		SendNotModified(event, "Unknown reason.");
+
+		CEXCDSBridge::SendEuroscopeMessage(flightPlan.GetCallsign(), "Cannot modify.", "UNKNOWN");
+		return;
+	}
+
+	Amend(flightPlan);
+
+	// Tell EXCDS the change is done
+	SendModified(event);
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include "TypedExcdsEvent.h"
+
+struct DepartureTimeUpdatePayload
+{
+    std::string value;
+};
+
+class DepartureTimeUpdateEvent :
+    public TypedExcdsEvent<DepartureTimeUpdatePayload>
+{
+public:
+    DepartureTimeUpdateEvent();
+
+    static const char* Name() { return "UPDATE_DEPARTURE_TIME"; }
+protected:
+    void ExecuteEvent(sio::event&, EuroScopePlugIn::CFlightPlan, const DepartureTimeUpdatePayload&) override;
+};
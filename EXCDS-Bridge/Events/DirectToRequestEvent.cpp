@@ -0,0 +1,164 @@
+#include <algorithm>
+#include <cmath>
+
+#include "DirectToRequestEvent.h"
+#include "../Airspace/FixIndex.h"
+#include "../Airspace/TrajectoryPredictor.h"
+#include "../Diagnostics/Profiler.h"
+#include "sio_client.h"
+
+/**
+* Event payload:
+*
+* {
+*	"callsign": "AAL123",
+*	"candidates": ["YOW", "BAXUS"]
+* }
+*
+* The ack holds what flying direct to each candidate would do, under "candidates", in seconds:
+*   { "name": "YOW", "on_route": true, "time_saved": 95, "direct_time": 1520, "route_time": 1615, "altitude": 24000,
+*     "sector_exit": 610, "sector_exit_change": -40 }
+* A candidate that is neither on the route nor in the sector file is sent back with "unknown" set.
+*/
+
+// Slower than this, the aircraft is taken to fly its filed true airspeed
+static const int MINIMUM_GROUND_SPEED = 50;
+
+static sio::message::ptr ToMessage(const DirectToPrediction& prediction)
+{
+	sio::message::ptr msg = sio::object_message::create();
+	msg->get_map()["name"] = sio::string_message::create(prediction.name);
+	msg->get_map()["on_route"] = sio::bool_message::create(prediction.onRoute);
+	msg->get_map()["time_saved"] = sio::int_message::create(static_cast<int>(std::lround(prediction.timeSaved)));
+	msg->get_map()["direct_time"] = sio::int_message::create(static_cast<int>(std::lround(prediction.directSeconds)));
+	msg->get_map()["route_time"] = sio::int_message::create(static_cast<int>(std::lround(prediction.routeSeconds)));
+	msg->get_map()["altitude"] = sio::int_message::create(prediction.altitude);
+	msg->get_map()["sector_exit"] = sio::int_message::create(static_cast<int>(std::lround(prediction.sectorExitSeconds)));
+	msg->get_map()["sector_exit_change"] = sio::int_message::create(static_cast<int>(std::lround(prediction.sectorExitChange)));
+
+	return msg;
+}
+
+DirectToRequestEvent::DirectToRequestEvent()
+	: TypedExcdsEvent(FLIGHT_PLAN_CHECK_EXISTS)
+{
+	_schema.Array("candidates", &DirectToRequestPayload::candidates, false);
+}
+
+void DirectToRequestEvent::ExecuteEvent(sio::event& event, EuroScopePlugIn::CFlightPlan flightPlan, const DirectToRequestPayload& payload)
+{
+	PROFILE_ZONE("DirectToRequestEvent");
+
+	TrajectoryInput input;
+	EuroScopePlugIn::CRadarTarget radarTarget = flightPlan.GetCorrelatedRadarTarget();
+
+	EuroScopePlugIn::CPosition position;
+	if (radarTarget.IsValid() && radarTarget.GetPosition().IsValid())
+	{
+		position = radarTarget.GetPosition().GetPosition();
+		input.groundSpeed = radarTarget.GetPosition().GetReportedGS();
+		input.altitude = radarTarget.GetPosition().GetFlightLevel() >= 18000 ? radarTarget.GetPosition().GetFlightLevel() : radarTarget.GetPosition().GetPressureAltitude();
+	}
+	else if (flightPlan.GetFPTrackPosition().IsValid())
+	{
+		position = flightPlan.GetFPTrackPosition().GetPosition();
+		input.altitude = flightPlan.GetFPTrackPosition().GetFlightLevel();
+	}
+	else
+	{
+		SendNotModified(event, "The aircraft has no position.");
+		return;
+	}
+
+	input.latitude = position.m_Latitude;
+	input.longitude = position.m_Longitude;
+
+	if (input.groundSpeed < MINIMUM_GROUND_SPEED)
+		input.groundSpeed = flightPlan.GetFlightPlanData().GetTrueAirspeed();
+
+	if (input.groundSpeed <= 0)
+	{
+		SendNotModified(event, "The aircraft has no speed to predict with.");
+		return;
+	}
+
+	// 0 is no cleared altitude, and 1 and 2 are approach clearances
+	int clearedAltitude = flightPlan.GetControllerAssignedData().GetClearedAltitude();
+	if (clearedAltitude == 0)
+		input.targetAltitude = flightPlan.GetFinalAltitude();
+	else if (clearedAltitude <= 2)
+		input.targetAltitude = input.altitude;
+	else
+		input.targetAltitude = clearedAltitude;
+
+	input.climbRate = flightPlan.GetFlightPlanData().PerformanceGetClimbRate(input.altitude);
+	input.descentRate = flightPlan.GetFlightPlanData().PerformanceGetDescentRate(input.altitude);
+
+	int sectorExit = flightPlan.GetSectorExitMinutes();
+	input.sectorExitSeconds = sectorExit >= 0 ? sectorExit * 60.0 : -1;
+
+	// Start from whichever is further along, the point we were sent direct to or the closest one
+	EuroScopePlugIn::CFlightPlanExtractedRoute route = flightPlan.GetExtractedRoute();
+	int start = std::max(route.GetPointsAssignedIndex(), route.GetPointsCalculatedIndex());
+
+	for (int i = std::max(start, 0); i < route.GetPointsNumber(); i++)
+	{
+		RoutePoint point;
+		point.name = route.GetPointName(i);
+		point.latitude = route.GetPointPosition(i).m_Latitude;
+		point.longitude = route.GetPointPosition(i).m_Longitude;
+
+		input.route.push_back(point);
+	}
+
+	TrajectoryPredictor predictor(input);
+	sio::message::ptr candidates = sio::array_message::create();
+
+	if (!payload.candidates)
+	{
+		for (size_t i = 0; i < input.route.size(); i++)
+			candidates->get_vector().push_back(ToMessage(predictor.Evaluate(i)));
+	}
+	else
+	{
+		for (const sio::message::ptr& candidate : payload.candidates->get_vector())
+		{
+			if (!candidate || candidate->get_flag() != sio::message::flag_string)
+			{
+				SendInvalid(event, { "Field 'candidates' must be an array of strings." });
+				return;
+			}
+
+			const std::string& name = candidate->get_string();
+
+			int index = predictor.FindOnRoute(name);
+			if (index >= 0)
+			{
+				candidates->get_vector().push_back(ToMessage(predictor.Evaluate(index)));
+				continue;
+			}
+
+			// Off the route, the nearest point with the name
+			EuroScopePlugIn::CPosition fix;
+			if (FixIndex::GetInstance()->Find(name, fix, &position))
+			{
+				RoutePoint point;
+				point.name = name;
+				point.latitude = fix.m_Latitude;
+				point.longitude = fix.m_Longitude;
+
+				candidates->get_vector().push_back(ToMessage(predictor.Evaluate(point)));
+				continue;
+			}
+
+			sio::message::ptr unknown = sio::object_message::create();
+			unknown->get_map()["name"] = sio::string_message::create(name);
+			unknown->get_map()["unknown"] = sio::bool_message::create(true);
+			candidates->get_vector().push_back(unknown);
+		}
+	}
+
+	_response->get_map()["callsign"] = sio::string_message::create(flightPlan.GetCallsign());
+	_response->get_map()["candidates"] = candidates;
+	SendResult(event);
+}
@@ -0,0 +1,21 @@
+#pragma once
+#include "TypedExcdsEvent.h"
+
+/**
+* Without candidates, every point left on the route is one.
+*/
+struct DirectToRequestPayload
+{
+    sio::message::ptr candidates;
+};
+
+class DirectToRequestEvent :
+    public TypedExcdsEvent<DirectToRequestPayload>
+{
+public:
+    DirectToRequestEvent();
+
+    static const char* Name() { return "REQUEST_DIRECT_TO"; }
+protected:
+    void ExecuteEvent(sio::event&, EuroScopePlugIn::CFlightPlan, const DirectToRequestPayload&) override;
+};
@@ -0,0 +1,79 @@
+#include "DirectToUpdateEvent.h"
+#include "../MessageHandler.h"
+#include "../Airspace/FixIndex.h"
+#include "../Response/ExcdsResponse.h"
+#include "sio_client.h"
+
+/**
+* Event payload:
+*
+* {
+*	"callsign": "AAL123",
+*	"altitude": 0,
+*	"new_destination": "",
+*	"route": "DCT YXU"
+* }
+*/
+
+DirectToUpdateEvent::DirectToUpdateEvent()
+{
+	_schema
+		.Integer("altitude", &DirectToUpdatePayload::altitude)
+		.String("new_destination", &DirectToUpdatePayload::newDestination)
+		.String("route", &DirectToUpdatePayload::route);
+}
+
+/**
+* Whether the point a "DCT" route goes to is in the sector file. Coordinates, and anything else with a digit in it, are
+* left for EuroScope to make sense of.
+*/
+static bool IsKnownPoint(const std::string& route)
+{
+	std::string point = route.size() > 4 ? route.substr(4) : "";
+	point = point.substr(0, point.find(' '));
+
+	FixIndex* fixes = FixIndex::GetInstance();
+	if (point.empty() || !fixes->IsLoaded()) return true;
+
+	for (char c : point)
+	{
+		if (!isalpha(static_cast<unsigned char>(c))) return true;
+	}
+
+	return fixes->Contains(point);
+}
+
+void DirectToUpdateEvent::ExecuteEvent(sio::event& event, EuroScopePlugIn::CFlightPlan flightPlan, const DirectToUpdatePayload& payload)
+{
+	bool direct = payload.newDestination != "" || payload.route.substr(0, 3) == "DCT";
+	if (direct && !IsKnownPoint(payload.route))
+	{
+		SendNotModified(event, "The direct to point is not in the sector file.");
+
+		CEXCDSBridge::SendEuroscopeMessage(flightPlan.GetCallsign(), DCT_UNKNOWN_FIX);
+		return;
+	}
+
+	if (payload.newDestination != "")
+	{
+		flightPlan.GetFlightPlanData().SetDestination(payload.newDestination.c_str());
+
+		MessageHandler::DirectTo(payload.route, flightPlan, true);
+	}
+	else if (payload.route.substr(0, 3) == "DCT")
+	{
+		MessageHandler::DirectTo(payload.route, flightPlan, true);
+	}
+	else
+	{
+		flightPlan.GetFlightPlanData().SetRoute(payload.route.c_str());
+	}
+
+	if (payload.altitude > 0)
+		flightPlan.GetControllerAssignedData().SetClearedAltitude(payload.altitude);
+
+	Amend(flightPlan);
+
+	// Tell EXCDS the change is done
+	SendModified(event);
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include "TypedExcdsEvent.h"
+
+/**
+* An altitude of 0 and an empty new destination are left as they are.
+*/
+struct DirectToUpdatePayload
+{
+    int altitude = 0;
+    std::string newDestination;
+    std::string route;
+};
+
+class DirectToUpdateEvent :
+    public TypedExcdsEvent<DirectToUpdatePayload>
+{
+public:
+    DirectToUpdateEvent();
+
+    static const char* Name() { return "UPDATE_DIRECT"; }
+protected:
+    void ExecuteEvent(sio::event&, EuroScopePlugIn::CFlightPlan, const DirectToUpdatePayload&) override;
+};
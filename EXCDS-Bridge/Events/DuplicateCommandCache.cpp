@@ -0,0 +1,69 @@
+#include "DuplicateCommandCache.h"
+#include "../ApiHelper.h"
+
+const std::chrono::seconds DuplicateCommandCache::WINDOW(10);
+
+DuplicateCommandCache* DuplicateCommandCache::GetInstance()
+{
+	static DuplicateCommandCache cache;
+	return &cache;
+}
+
+std::string DuplicateCommandCache::MakeKey(const std::string& eventName, const sio::message::ptr& payload)
+{
+	if (!payload || payload->get_flag() != sio::message::flag_object) return "";
+
+	// EXCDS sends "id" today, "request_id" is accepted from clients that have moved to it
+	std::string id = ApiHelper::GetString(payload, { "id" });
+	if (id.empty())
+		id = ApiHelper::GetString(payload, { "request_id" });
+
+	if (id.empty()) return "";
+
+	// Some commands use "id" for something else, such as the radar target CORRELATE_TARGET links to, so the
+	// aircraft is part of the key
+	return eventName + "#" + ApiHelper::GetString(payload, { "callsign" }) + "#" + id;
+}
+
+sio::message::ptr DuplicateCommandCache::Find(const std::string& key)
+{
+	std::lock_guard<std::mutex> guard(_lock);
+
+	auto entry = _index.find(key);
+	if (entry == _index.end()) return nullptr;
+
+	if (std::chrono::steady_clock::now() - entry->second->storedAt > WINDOW)
+	{
+		_entries.erase(entry->second);
+		_index.erase(entry);
+		return nullptr;
+	}
+
+	return ApiHelper::CopyMessage(entry->second->ack);
+}
+
+void DuplicateCommandCache::Store(const std::string& key, const sio::message::ptr& ack)
+{
+	std::lock_guard<std::mutex> guard(_lock);
+
+	auto existing = _index.find(key);
+	if (existing != _index.end())
+	{
+		_entries.erase(existing->second);
+		_index.erase(existing);
+	}
+
+	Entry entry;
+	entry.key = key;
+	entry.ack = ApiHelper::CopyMessage(ack);
+	entry.storedAt = std::chrono::steady_clock::now();
+
+	_entries.push_front(entry);
+	_index[key] = _entries.begin();
+
+	while (_entries.size() > CAPACITY)
+	{
+		_index.erase(_entries.back().key);
+		_entries.pop_back();
+	}
+}
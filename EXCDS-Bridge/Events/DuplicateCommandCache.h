@@ -0,0 +1,51 @@
+#pragma once
+
+#include <chrono>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <sio_client.h>
+
+/**
+* Remembers the acks of recently applied commands, so a command EXCDS retries is answered with the first ack instead
+* of being applied again.
+*
+* A command is identified by its event, its callsign and its "id" (or "request_id"). Commands without one are never
+* taken for a retry, since sending the same command twice on purpose is allowed. Only commands that modified something are remembered; a
+* command that failed is run again when retried. Entries are forgotten after WINDOW, or sooner when more than
+* CAPACITY commands have been applied since. Acks are copied on the way in and out, so nothing that changes an ack
+* after it is sent can change the one kept here.
+*/
+class DuplicateCommandCache
+{
+public:
+    static const size_t CAPACITY = 1024;
+    static const std::chrono::seconds WINDOW;
+
+    static DuplicateCommandCache* GetInstance();
+
+    /**
+    * The key of the command, or an empty string if it has no id and cannot be deduplicated.
+    */
+    static std::string MakeKey(const std::string& eventName, const sio::message::ptr& payload);
+
+    /**
+    * The ack the command was first answered with, or nullptr if it has not been applied within the window.
+    */
+    sio::message::ptr Find(const std::string& key);
+    void Store(const std::string& key, const sio::message::ptr& ack);
+private:
+    struct Entry
+    {
+        std::string key;
+        sio::message::ptr ack;
+        std::chrono::steady_clock::time_point storedAt;
+    };
+
+    std::mutex _lock;
+
+    // Most recently stored first
+    std::list<Entry> _entries;
+    std::unordered_map<std::string, std::list<Entry>::iterator> _index;
+};
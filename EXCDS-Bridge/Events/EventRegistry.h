@@ -0,0 +1,27 @@
+#pragma once
+
+/**
+* Registers a list of event types with the socket, each under the name it gives in its static Name().
+*
+* One instance of every event type is made the first time the list is registered and kept until the plugin unloads.
+* Registering again, after the socket reconnects, binds the same instances.
+*
+*     EventRegistry<AltitudeUpdateEvent, ScratchpadUpdateEvent>::RegisterAll();
+*/
+template <typename... Events>
+class EventRegistry
+{
+public:
+    static void RegisterAll()
+    {
+        int registered[] = { 0, (Register<Events>(), 0)... };
+        (void)registered;
+    }
+private:
+    template <typename Event>
+    static void Register()
+    {
+        static Event event;
+        event.RegisterEvent(Event::Name());
+    }
+};
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+#include <sio_client.h>
+
+/**
+* The fields an event reads from its payload, and the members of a plain payload struct they decode into.
+*
+* Each field is declared once with its name, type and whether EXCDS has to send it. Decoding takes one pass over
+* the payload map, so keys are neither copied nor inserted, and every problem with the payload is reported at once
+* instead of surfacing as an exception halfway through the handler. Fields that are optional and not sent keep the
+* value the struct was constructed with.
+*/
+template <typename T>
+class EventSchema
+{
+public:
+    EventSchema& String(const char* name, std::string T::* member, bool required = true)
+    {
+        Field field(name, required);
+        field.stringMember = member;
+        return Add(field);
+    }
+
+    EventSchema& Integer(const char* name, int T::* member, bool required = true)
+    {
+        Field field(name, required);
+        field.intMember = member;
+        return Add(field);
+    }
+
+    EventSchema& Double(const char* name, double T::* member, bool required = true)
+    {
+        Field field(name, required);
+        field.doubleMember = member;
+        return Add(field);
+    }
+
+    EventSchema& Boolean(const char* name, bool T::* member, bool required = true)
+    {
+        Field field(name, required);
+        field.boolMember = member;
+        return Add(field);
+    }
+
+    /**
+    * Arrays are kept as the message they arrived in, for the event to walk through.
+    */
+    EventSchema& Array(const char* name, sio::message::ptr T::* member, bool required = true)
+    {
+        Field field(name, required);
+        field.arrayMember = member;
+        return Add(field);
+    }
+
+    /**
+    * Decodes the payload into out. Returns false with a description of each bad or missing field in errors.
+    */
+    bool Decode(const sio::message::ptr& message, T& out, std::vector<std::string>& errors) const
+    {
+        if (!message || message->get_flag() != sio::message::flag_object)
+        {
+            errors.push_back("Payload must be an object.");
+            return false;
+        }
+
+        uint64_t sent = 0;
+
+        for (const auto& entry : message->get_map())
+        {
+            for (size_t i = 0; i < _fields.size(); i++)
+            {
+                if (entry.first != _fields[i].name) continue;
+
+                // null is as good as not sent
+                if (entry.second && entry.second->get_flag() != sio::message::flag_null)
+                {
+                    sent |= 1ull << i;
+
+                    if (!Assign(_fields[i], entry.second, out))
+                        errors.push_back("Field '" + entry.first + "' must be " + TypeName(_fields[i]) + ".");
+                }
+                break;
+            }
+        }
+
+        for (size_t i = 0; i < _fields.size(); i++)
+        {
+            if (_fields[i].required && !(sent & (1ull << i)))
+                errors.push_back("Field '" + std::string(_fields[i].name) + "' is required.");
+        }
+
+        return errors.empty();
+    }
+private:
+    struct Field
+    {
+        Field(const char* name, bool required) : name(name), required(required) {};
+
+        const char* name;
+        bool required;
+
+        std::string T::* stringMember = nullptr;
+        int T::* intMember = nullptr;
+        double T::* doubleMember = nullptr;
+        bool T::* boolMember = nullptr;
+        sio::message::ptr T::* arrayMember = nullptr;
+    };
+
+    std::vector<Field> _fields;
+
+    EventSchema& Add(const Field& field)
+    {
+        // Fields seen while decoding are kept in a 64 bit mask
+        if (_fields.size() < 64)
+            _fields.push_back(field);
+
+        return *this;
+    }
+
+    static bool Assign(const Field& field, const sio::message::ptr& value, T& out)
+    {
+        sio::message::flag flag = value->get_flag();
+
+        if (field.stringMember)
+        {
+            if (flag != sio::message::flag_string) return false;
+            out.*field.stringMember = value->get_string();
+        }
+        else if (field.intMember)
+        {
+            // JavaScript has no integers, so whole doubles are accepted too
+            if (flag == sio::message::flag_integer)
+                out.*field.intMember = static_cast<int>(value->get_int());
+            else if (flag == sio::message::flag_double && std::floor(value->get_double()) == value->get_double())
+                out.*field.intMember = static_cast<int>(value->get_double());
+            else
+                return false;
+        }
+        else if (field.doubleMember)
+        {
+            if (flag != sio::message::flag_integer && flag != sio::message::flag_double) return false;
+            out.*field.doubleMember = value->get_double();
+        }
+        else if (field.boolMember)
+        {
+            if (flag != sio::message::flag_boolean) return false;
+            out.*field.boolMember = value->get_bool();
+        }
+        else if (field.arrayMember)
+        {
+            if (flag != sio::message::flag_array) return false;
+            out.*field.arrayMember = value;
+        }
+
+        return true;
+    }
+
+    static const char* TypeName(const Field& field)
+    {
+        if (field.stringMember) return "a string";
+        if (field.intMember) return "an integer";
+        if (field.doubleMember) return "a number";
+        if (field.arrayMember) return "an array";
+        return "a boolean";
+    }
+};
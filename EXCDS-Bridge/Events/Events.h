@@ -0,0 +1,91 @@
+#pragma once
+
+#include "EventRegistry.h"
+
+// Messages FROM EXCDS, to update aircraft in EuroScope
+#include "AltitudeUpdateEvent.h"
+#include "ScratchpadUpdateEvent.h"
+#include "TimeUpdateEvent.h"
+#include "DepartureTimeUpdateEvent.h"
+#include "SpeedUpdateEvent.h"
+#include "StatusUpdateEvent.h"
+#include "TrackingStatusUpdateEvent.h"
+#include "DirectToUpdateEvent.h"
+#include "FlightPlanUpdateEvent.h"
+#include "RouteUpdateEvent.h"
+#include "SquawkUpdateEvent.h"
+#include "NewFlightPlanEvent.h"
+#include "PositionsUpdateEvent.h"
+#include "SendPdcEvent.h"
+#include "HandoffTargetEvent.h"
+#include "RefuseHandoffEvent.h"
+#include "AcceptHandoffEvent.h"
+#include "RefuseCoordinationEvent.h"
+#include "AcceptCoordinationEvent.h"
+#include "CorrelateTargetEvent.h"
+#include "DecorrelateTargetEvent.h"
+#include "ConflictParametersUpdateEvent.h"
+
+// EXCDS information requests
+#include "AllFlightPlansRequestEvent.h"
+#include "FlightPlanRequestEvent.h"
+#include "RouteDataRequestEvent.h"
+#include "ControllersRequestEvent.h"
+#include "AirportsRequestEvent.h"
+#include "FlightPlanQueryEvent.h"
+#include "TrackHistoryRequestEvent.h"
+#include "TrackArchiveQueryEvent.h"
+#include "DirectToRequestEvent.h"
+
+// Several of the above at once
+#include "BatchCommandsEvent.h"
+
+// Bridge diagnostics, only run when EXCDS sends them
+#include "MinimumAltitudeGridLoadEvent.h"
+#include "TrackArchiveExportEvent.h"
+
+/**
+* Every event EXCDS can send, registered with the socket by bind_events.
+*/
+typedef EventRegistry<
+    AltitudeUpdateEvent,
+    ScratchpadUpdateEvent,
+    TimeUpdateEvent,
+    DepartureTimeUpdateEvent,
+    SpeedUpdateEvent,
+    StatusUpdateEvent,
+    TrackingStatusUpdateEvent,
+    DirectToUpdateEvent,
+    FlightPlanUpdateEvent,
+    RouteUpdateEvent,
+    SquawkUpdateEvent,
+    NewFlightPlanEvent,
+    PositionsUpdateEvent,
+    SendPdcEvent,
+    HandoffTargetEvent,
+    RefuseHandoffEvent,
+    AcceptHandoffEvent,
+    RefuseCoordinationEvent,
+    AcceptCoordinationEvent,
+    CorrelateTargetEvent,
+    DecorrelateTargetEvent,
+    ConflictParametersUpdateEvent,
+    AllFlightPlansRequestEvent,
+    FlightPlanRequestEvent,
+    RouteDataRequestEvent,
+    ControllersRequestEvent,
+    AirportsRequestEvent,
+    FlightPlanQueryEvent,
+    TrackHistoryRequestEvent,
+    TrackArchiveQueryEvent,
+    DirectToRequestEvent,
+    BatchCommandsEvent
+> CommandEvents;
+
+/**
+* Bridge diagnostics built on events, registered by bind_events outside local dispatch.
+*/
+typedef EventRegistry<
+    MinimumAltitudeGridLoadEvent,
+    TrackArchiveExportEvent
+> DiagnosticEvents;
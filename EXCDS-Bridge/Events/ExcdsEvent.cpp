@@ -1,61 +1,179 @@
 #include "ExcdsEvent.h"
 #include "EuroScopePlugIn.h"
+#include "AmendmentCoalescer.h"
+#include "DuplicateCommandCache.h"
+#include "LocalEvent.h"
+#include "../Diagnostics/CommandTracer.h"
+
+// Filled in while bind_events runs, and only read after
+static std::map<std::string, ExcdsEvent*> registeredEvents;
 
 std::string ExcdsEvent::GetCallsign(sio::event& event)
 {
-    return event.get_message()->get_map()["callsign"]->get_string();
+    const std::map<std::string, sio::message::ptr>& payload = GetMessageValue(event);
+
+    auto callsign = payload.find("callsign");
+    if (callsign == payload.end() || !callsign->second || callsign->second->get_flag() != sio::message::flag_string) return "";
+
+    return callsign->second->get_string();
 }
 
-std::map<std::string, sio::message::ptr> ExcdsEvent::GetMessageValue(sio::event& event)
+const std::map<std::string, sio::message::ptr>& ExcdsEvent::GetMessageValue(sio::event& event)
 {
     return event.get_message()->get_map();
 }
 
 void ExcdsEvent::SendNotModified(sio::event& event, std::string reason)
 {
+    CommandTracer::Mark(TRACE_APPLIED);
+
+    if (_notModified)
+        _notModified->Increment();
+
     _response->get_map()["modified"] = sio::bool_message::create(false);
     _response->get_map()["message"] = sio::string_message::create(reason);
+    // The handlers EXCDS used before events read the reason from here
+    _response->get_map()["reason"] = sio::string_message::create(reason);
     event.put_ack_message(_response);
 }
 
+void ExcdsEvent::SendInvalid(sio::event& event, const std::vector<std::string>& errors)
+{
+	if (_invalid)
+		_invalid->Increment();
+
+	sio::message::ptr errorList = sio::array_message::create();
+	for (const std::string& error : errors)
+		errorList->get_vector().push_back(sio::string_message::create(error));
+
+	_response->get_map()["errors"] = errorList;
+	SendNotModified(event, "Invalid payload.");
+}
+
 void ExcdsEvent::SendModified(sio::event& event)
 {
+	CommandTracer::Mark(TRACE_APPLIED);
+
 	_response->get_map()["modified"] = sio::bool_message::create(true);
 	event.put_ack_message(_response);
 }
 
+void ExcdsEvent::SendDone(sio::event& event)
+{
+	CommandTracer::Mark(TRACE_APPLIED);
+
+	event.put_ack_message(sio::bool_message::create(true));
+}
+
+void ExcdsEvent::SendResult(sio::event& event)
+{
+	CommandTracer::Mark(TRACE_APPLIED);
+
+	event.put_ack_message(_response);
+}
+
+void ExcdsEvent::Amend(EuroScopePlugIn::CFlightPlan flightPlan)
+{
+	AmendmentCoalescer::GetInstance()->Request(flightPlan.GetCallsign());
+}
+
 void ExcdsEvent::TriggerEvent(sio::event& event)
 {
-	EuroScopePlugIn::CFlightPlan fp;
-	if (!_skipFlightPlanChecks)
-    {
-        // Check if the flight plan exists (and is valid)
+	std::lock_guard<std::mutex> guard(_triggerLock);
 
+	// A retry of a command that was already applied gets the first ack, and EuroScope is left alone. Storms and load
+	// tests repeat the same payloads on purpose, so commands fired from inside the bridge are never deduplicated.
+	DuplicateCommandCache* duplicates = DuplicateCommandCache::GetInstance();
+	std::string key = LocalEvent::IsLocal(event) ? "" : DuplicateCommandCache::MakeKey(_eventName, event.get_message());
+
+	sio::message::ptr firstAck = key.empty() ? nullptr : duplicates->Find(key);
+	if (firstAck)
+	{
+		if (_duplicate)
+			_duplicate->Increment();
+
+		CommandTracer::Mark(TRACE_APPLIED);
+		event.put_ack_message(firstAck);
+		return;
+	}
+
+	EuroScopePlugIn::CFlightPlan fp;
+	if (_flightPlanCheck != FLIGHT_PLAN_CHECK_NONE)
 		fp = _bridgeInstance->FlightPlanSelect(GetCallsign(event).c_str());
+
+	Run(event, fp);
+
+	// Requests never set "modified", so only commands that changed something are remembered
+	auto modified = _response->get_map().find("modified");
+	if (!key.empty() && modified != _response->get_map().end() && modified->second->get_bool())
+		duplicates->Store(key, _response);
+}
+
+void ExcdsEvent::TriggerBatched(sio::event& event, EuroScopePlugIn::CFlightPlan fp)
+{
+	std::lock_guard<std::mutex> guard(_triggerLock);
+
+	Run(event, fp);
+}
+
+void ExcdsEvent::Run(sio::event& event, EuroScopePlugIn::CFlightPlan fp)
+{
+	// Every command gets its own ack
+	_response = sio::object_message::create();
+
+	std::string callsign = GetCallsign(event);
+	if (!callsign.empty())
+		_response->get_map()["callsign"] = sio::string_message::create(callsign);
+
+	if (_flightPlanCheck != FLIGHT_PLAN_CHECK_NONE)
+	{
+		// Check if the flight plan exists (and is valid)
 		if (!fp.IsValid())
 		{
-			CEXCDSBridge::SendEuroscopeMessage(fp.GetCallsign(), "Cannot modify.", "NO_FPLN");
+			CEXCDSBridge::SendEuroscopeMessage(callsign.c_str(), "Cannot modify.", "NO_FPLN");
 			SendNotModified(event, "Flight plan not found.");
 			return;
 		}
 
 		// Are we allowed to modify this aircraft?
-		if (!fp.GetTrackingControllerIsMe() && strlen(fp.GetTrackingControllerId()) != 0)
+		if (_flightPlanCheck == FLIGHT_PLAN_CHECK_MODIFIABLE && !fp.GetTrackingControllerIsMe() && strlen(fp.GetTrackingControllerId()) != 0)
 		{
-			CEXCDSBridge::SendEuroscopeMessage(fp.GetCallsign(), "Cannot modify.", "ALRDY_TRACKD");
+			CEXCDSBridge::SendEuroscopeMessage(callsign.c_str(), "Cannot modify.", "ALRDY_TRACKD");
 			SendNotModified(event, "Aircraft is being tracked by another controller.");
 
 			return;
 		}
-    }
+	}
+
+	CommandTracer::Mark(TRACE_DISPATCHED);
 
-    ExecuteEvent(event, fp);
+	try {
+		ExecuteEvent(event, fp);
+	}
+	catch (...) {
+		Metrics::CountException(_eventName.c_str(), "EXCDS Error: Event threw an exception");
+		SendNotModified(event, "Exception thrown while executing the event.");
+	}
+}
+
+ExcdsEvent* ExcdsEvent::Find(const std::string& eventName)
+{
+	auto event = registeredEvents.find(eventName);
+	return event == registeredEvents.end() ? nullptr : event->second;
 }
 
 void ExcdsEvent::RegisterEvent(std::string eventName)
 {
-	_bridgeInstance->GetSocket()->on(eventName, [&](sio::event& ev)
+	if (_localDispatch)
+		registeredEvents[eventName] = this;
+
+	_eventName = eventName;
+	_notModified = &Metrics::GetInstance()->Counter("commands." + eventName + ".not_modified");
+	_invalid = &Metrics::GetInstance()->Counter("commands." + eventName + ".invalid");
+	_duplicate = &Metrics::GetInstance()->Counter("commands." + eventName + ".duplicate");
+
+	CEXCDSBridge::RegisterSocketEvent(eventName, [this](sio::event& ev)
 	{
 		TriggerEvent(ev);
-	});
-}
\ No newline at end of file
+	}, _localDispatch);
+}
@@ -2,40 +2,110 @@
 
 #include <string>
 #include <map>
+#include <mutex>
+#include <vector>
 #include <sio_client.h>
 
 #include "../CEXCDSBridge.h"
+#include "../Diagnostics/Metrics.h"
+
+/**
+* What has to be true of the payload's flight plan before the event is executed.
+*/
+enum FlightPlanCheck
+{
+    /**
+    * The event does not act on a flight plan, or finds what it needs itself.
+    */
+    FLIGHT_PLAN_CHECK_NONE,
+
+    /**
+    * The flight plan has to exist.
+    */
+    FLIGHT_PLAN_CHECK_EXISTS,
+
+    /**
+    * The flight plan has to exist, and be tracked by us or nobody.
+    */
+    FLIGHT_PLAN_CHECK_MODIFIABLE
+};
 
 class ExcdsEvent
 {
 public:
     ExcdsEvent() {};
-    ExcdsEvent(bool skipFlightPlanChecks): _skipFlightPlanChecks(skipFlightPlanChecks) {};
+    ExcdsEvent(FlightPlanCheck flightPlanCheck): _flightPlanCheck(flightPlanCheck) {};
 
     /**
     * The EXCDS Bridge will call this method when an event is received from the socket.
     */
     void TriggerEvent(sio::event&);
     void RegisterEvent(std::string);
+
+    /**
+    * Runs the event as one operation of a batch, against a flight plan the batch has already looked up.
+    */
+    void TriggerBatched(sio::event&, EuroScopePlugIn::CFlightPlan);
+
+    /**
+    * The registered event with this name, or nullptr. Events kept out of local dispatch are not found.
+    */
+    static ExcdsEvent* Find(const std::string&);
 protected:
     CEXCDSBridge* _bridgeInstance = CEXCDSBridge::GetInstance();
     sio::message::ptr _response = sio::object_message::create();
 
+    /**
+    * Bridge diagnostics set this to false in their constructor, so they are only run when EXCDS sends them and never
+    * from a storm, a load test or a batch.
+    */
+    bool _localDispatch = true;
+
     /**
     * This method is called internally by TriggerEvent. It is where the event is actually executed.
     */
     virtual void ExecuteEvent(sio::event&, EuroScopePlugIn::CFlightPlan) = 0;
 
     /**
-    * The following functions are used to extract the callsign and value from the payload.
+    * The following functions are used to extract the callsign and value from the payload. Neither copies the payload
+    * or adds missing keys to it, and a missing callsign is returned as an empty string.
     */
 
     std::string GetCallsign(sio::event&);
-    std::map<std::string, sio::message::ptr> GetMessageValue(sio::event&);
+    const std::map<std::string, sio::message::ptr>& GetMessageValue(sio::event&);
 
     void SendNotModified(sio::event&, std::string);
     void SendModified(sio::event&);
+
+    /**
+    * Not modified, with the list of problems the payload has under "errors".
+    */
+    void SendInvalid(sio::event&, const std::vector<std::string>&);
+
+    /**
+    * Acknowledges a request for information, which is sent back as its own event.
+    */
+    void SendDone(sio::event&);
+
+    /**
+    * Answers a query with what has been put in the response, rather than in an event of its own.
+    */
+    void SendResult(sio::event&);
+
+    /**
+    * Marks the flight plan to be amended on the next tick, together with anything else changed on it until then.
+    */
+    void Amend(EuroScopePlugIn::CFlightPlan);
 private:
-    bool _skipFlightPlanChecks = false;
-};
+    FlightPlanCheck _flightPlanCheck = FLIGHT_PLAN_CHECK_MODIFIABLE;
+    std::string _eventName;
+
+    // Events are triggered from the socket and from local dispatch, and share one ack between them
+    std::mutex _triggerLock;
 
+    MetricCounter* _notModified = nullptr;
+    MetricCounter* _invalid = nullptr;
+    MetricCounter* _duplicate = nullptr;
+
+    void Run(sio::event&, EuroScopePlugIn::CFlightPlan);
+};
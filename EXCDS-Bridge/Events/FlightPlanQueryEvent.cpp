@@ -0,0 +1,82 @@
+#include "FlightPlanQueryEvent.h"
+#include "../Surveillance/TrafficIndex.h"
+#include "sio_client.h"
+
+/**
+* Event payload, with every field optional:
+*
+* {
+*	"origin": "CYYZ",
+*	"destination": "KJFK",
+*	"tracking": "T",
+*	"ground_status": ["NSTS", "CLEA"],
+*	"squawk": "1234",
+*	"sector_entry_min": 0,
+*	"sector_entry_max": 10,
+*	"full": false
+* }
+*
+* The ack holds the matching callsigns under "callsigns", or with "full" their flight plan data, as sent in
+* SEND_FP_DATA, under "flight_plans".
+*/
+
+FlightPlanQueryEvent::FlightPlanQueryEvent()
+	: TypedExcdsEvent(FLIGHT_PLAN_CHECK_NONE)
+{
+	_schema
+		.String("origin", &FlightPlanQueryPayload::origin, false)
+		.String("destination", &FlightPlanQueryPayload::destination, false)
+		.String("tracking", &FlightPlanQueryPayload::tracking, false)
+		.Array("ground_status", &FlightPlanQueryPayload::groundStatus, false)
+		.String("squawk", &FlightPlanQueryPayload::squawk, false)
+		.Integer("sector_entry_min", &FlightPlanQueryPayload::sectorEntryMin, false)
+		.Integer("sector_entry_max", &FlightPlanQueryPayload::sectorEntryMax, false)
+		.Boolean("full", &FlightPlanQueryPayload::full, false);
+}
+
+void FlightPlanQueryEvent::ExecuteEvent(sio::event& event, EuroScopePlugIn::CFlightPlan flightPlan, const FlightPlanQueryPayload& payload)
+{
+	TrafficFilter filter;
+	filter.origin = payload.origin;
+	filter.destination = payload.destination;
+	filter.trackingController = payload.tracking;
+	filter.squawk = payload.squawk;
+	filter.sectorEntryMin = payload.sectorEntryMin;
+	filter.sectorEntryMax = payload.sectorEntryMax;
+
+	if (payload.groundStatus)
+	{
+		for (const sio::message::ptr& status : payload.groundStatus->get_vector())
+		{
+			if (!status || status->get_flag() != sio::message::flag_string)
+			{
+				SendInvalid(event, { "Field 'ground_status' must be an array of strings." });
+				return;
+			}
+
+			filter.groundStatuses.insert(status->get_string());
+		}
+	}
+
+	TrafficIndex* traffic = TrafficIndex::GetInstance();
+	std::vector<std::string> callsigns = traffic->Query(filter);
+
+	sio::message::ptr results = sio::array_message::create();
+	for (const std::string& callsign : callsigns)
+	{
+		if (!payload.full)
+		{
+			results->get_vector().push_back(sio::string_message::create(callsign));
+			continue;
+		}
+
+		// The aircraft may have disconnected since the query
+		sio::message::ptr flightPlanData = traffic->GetFlightPlanData(callsign);
+		if (flightPlanData)
+			results->get_vector().push_back(flightPlanData);
+	}
+
+	_response->get_map()[payload.full ? "flight_plans" : "callsigns"] = results;
+	_response->get_map()["count"] = sio::int_message::create(results->get_vector().size());
+	SendResult(event);
+}
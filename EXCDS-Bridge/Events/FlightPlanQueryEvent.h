@@ -0,0 +1,29 @@
+#pragma once
+#include <climits>
+#include "TypedExcdsEvent.h"
+
+/**
+* Every field is optional, and a field that is not sent does not filter.
+*/
+struct FlightPlanQueryPayload
+{
+    std::string origin;
+    std::string destination;
+    std::string tracking;
+    sio::message::ptr groundStatus;
+    std::string squawk;
+    int sectorEntryMin = INT_MIN;
+    int sectorEntryMax = INT_MAX;
+    bool full = false;
+};
+
+class FlightPlanQueryEvent :
+    public TypedExcdsEvent<FlightPlanQueryPayload>
+{
+public:
+    FlightPlanQueryEvent();
+
+    static const char* Name() { return "QUERY_FP"; }
+protected:
+    void ExecuteEvent(sio::event&, EuroScopePlugIn::CFlightPlan, const FlightPlanQueryPayload&) override;
+};
@@ -0,0 +1,18 @@
+#include "FlightPlanRequestEvent.h"
+#include "../MessageHandler.h"
+#include "sio_client.h"
+
+void FlightPlanRequestEvent::ExecuteEvent(sio::event& event, EuroScopePlugIn::CFlightPlan flightPlan)
+{
+#if _DEBUG
+	_bridgeInstance->DisplayUserMessage("EXCDS Bridge [DEBUG]", "Data sent", std::string(std::string(flightPlan.GetCallsign()) + " was sent.").c_str(), true, true, true, true, true);
+#endif
+
+	sio::message::ptr response = sio::object_message::create();
+	response->get_map()["callsign"] = sio::string_message::create(flightPlan.GetCallsign());
+
+	MessageHandler::PrepareFlightPlanDataResponse(flightPlan, response);
+	CEXCDSBridge::Emit("SEND_FP_DATA", response);
+
+	SendDone(event);
+}
@@ -0,0 +1,13 @@
+#pragma once
+#include "ExcdsEvent.h"
+
+class FlightPlanRequestEvent :
+    public ExcdsEvent
+{
+public:
+    FlightPlanRequestEvent() : ExcdsEvent(FLIGHT_PLAN_CHECK_EXISTS) {};
+
+    static const char* Name() { return "REQUEST_FP_DATA_CALLSIGN"; }
+protected:
+    void ExecuteEvent(sio::event&, EuroScopePlugIn::CFlightPlan) override;
+};
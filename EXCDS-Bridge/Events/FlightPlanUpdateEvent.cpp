@@ -0,0 +1,64 @@
+#include "FlightPlanUpdateEvent.h"
+#include "sio_client.h"
+
+/**
+* Event payload:
+*
+* {
+*	"callsign": "AAL123",
+*	"flight_rules": "I",
+*	"aircraft_type": "A320",
+*	"origin": "CYUL",
+*	"destination": "CYYZ",
+*	"altitude": 35000,
+*	"speed": 450,
+*	"etehours": "1",
+*	"eteminutes": "0",
+*	"etd": "1430",
+*	"route": "...",
+*	"remarks": "",
+*	"scratchpad": ""
+* }
+*/
+
+FlightPlanUpdateEvent::FlightPlanUpdateEvent()
+{
+	_schema
+		.String("flight_rules", &FlightPlanUpdatePayload::flightRules)
+		.String("aircraft_type", &FlightPlanUpdatePayload::aircraftType)
+		.String("origin", &FlightPlanUpdatePayload::origin)
+		.String("destination", &FlightPlanUpdatePayload::destination)
+		.Integer("altitude", &FlightPlanUpdatePayload::altitude)
+		.Integer("speed", &FlightPlanUpdatePayload::speed)
+		.String("etehours", &FlightPlanUpdatePayload::eteHours)
+		.String("eteminutes", &FlightPlanUpdatePayload::eteMinutes)
+		.String("etd", &FlightPlanUpdatePayload::etd)
+		.String("route", &FlightPlanUpdatePayload::route)
+		.String("remarks", &FlightPlanUpdatePayload::remarks)
+		.String("scratchpad", &FlightPlanUpdatePayload::scratchpad);
+}
+
+void FlightPlanUpdateEvent::ExecuteEvent(sio::event& event, EuroScopePlugIn::CFlightPlan flightPlan, const FlightPlanUpdatePayload& payload)
+{
+	// Assign data
+	flightPlan.GetFlightPlanData().SetAircraftInfo(payload.aircraftType.c_str());
+	flightPlan.GetFlightPlanData().SetOrigin(payload.origin.c_str());
+	flightPlan.GetFlightPlanData().SetDestination(payload.destination.c_str());
+	flightPlan.GetFlightPlanData().SetFinalAltitude(payload.altitude);
+	flightPlan.GetControllerAssignedData().SetFinalAltitude(payload.altitude);
+	flightPlan.GetFlightPlanData().SetTrueAirspeed(payload.speed);
+	flightPlan.GetFlightPlanData().SetEnrouteHours(payload.eteHours.c_str());
+	flightPlan.GetFlightPlanData().SetEnrouteMinutes(payload.eteMinutes.c_str());
+	flightPlan.GetFlightPlanData().SetRoute(payload.route.c_str());
+	flightPlan.GetFlightPlanData().SetEstimatedDepartureTime(payload.etd.c_str());
+	flightPlan.GetFlightPlanData().SetRemarks(payload.remarks.c_str());
+	flightPlan.GetControllerAssignedData().SetScratchPadString(payload.scratchpad.c_str());
+
+	if (payload.flightRules == "I" || payload.flightRules == "V")
+		flightPlan.GetFlightPlanData().SetPlanType(payload.flightRules.c_str());
+
+	Amend(flightPlan);
+
+	// Tell EXCDS the change is done
+	SendModified(event);
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include "TypedExcdsEvent.h"
+
+struct FlightPlanUpdatePayload
+{
+    std::string flightRules;
+    std::string aircraftType;
+    std::string origin;
+    std::string destination;
+    int altitude = 0;
+    int speed = 0;
+    std::string eteHours;
+    std::string eteMinutes;
+    std::string etd;
+    std::string route;
+    std::string remarks;
+    std::string scratchpad;
+};
+
+class FlightPlanUpdateEvent :
+    public TypedExcdsEvent<FlightPlanUpdatePayload>
+{
+public:
+    FlightPlanUpdateEvent();
+
+    static const char* Name() { return "UPDATE_FLIGHT_PLAN"; }
+protected:
+    void ExecuteEvent(sio::event&, EuroScopePlugIn::CFlightPlan, const FlightPlanUpdatePayload&) override;
+};
@@ -0,0 +1,41 @@
+#include "HandoffTargetEvent.h"
+#include "sio_client.h"
+
+/**
+* Event payload:
+*
+* {
+*	"callsign": "AAL123",
+*	"cjs": "TC"
+* }
+*/
+
+HandoffTargetEvent::HandoffTargetEvent()
+{
+	// Position ID of the controller to hand off to
+	_schema.String("cjs", &HandoffTargetPayload::cjs);
+}
+
+void HandoffTargetEvent::ExecuteEvent(sio::event& event, EuroScopePlugIn::CFlightPlan flightPlan, const HandoffTargetPayload& payload)
+{
+	EuroScopePlugIn::CController nextController = _bridgeInstance->ControllerSelectByPositionId(payload.cjs.c_str());
+
+	if (!nextController.IsValid()) {
+		SendNotModified(event, "Controller not found.");
+
+		CEXCDSBridge::SendEuroscopeMessage(flightPlan.GetCallsign(), "Cannot handoff", "UNKNOWN");
+		return;
+	}
+
+	bool isAssigned = flightPlan.InitiateHandoff(nextController.GetCallsign());
+
+	if (!isAssigned) {
+		SendNotModified(event, "Could not handoff target.");
+
+		CEXCDSBridge::SendEuroscopeMessage(flightPlan.GetCallsign(), "Cannot modify.", "UNKNOWN");
+		return;
+	}
+
+	// Tell EXCDS the change is done
+	SendModified(event);
+}
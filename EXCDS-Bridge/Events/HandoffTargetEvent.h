@@ -0,0 +1,18 @@
+#pragma once
+#include "TypedExcdsEvent.h"
+
+struct HandoffTargetPayload
+{
+    std::string cjs;
+};
+
+class HandoffTargetEvent :
+    public TypedExcdsEvent<HandoffTargetPayload>
+{
+public:
+    HandoffTargetEvent();
+
+    static const char* Name() { return "HANDOFF_TARGET"; }
+protected:
+    void ExecuteEvent(sio::event&, EuroScopePlugIn::CFlightPlan, const HandoffTargetPayload&) override;
+};
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <string>
+#include <sio_client.h>
+
+/**
+* An inbound event that did not come from the socket. The ack is kept on the event for the sender to read.
+*/
+class LocalEvent : public sio::event
+{
+public:
+    LocalEvent(const std::string& name, const sio::message::ptr& message) : sio::event(NAMESPACE, name, sio::message::list(message), true) {};
+
+    /**
+    * Socket namespaces always start with a slash, so this one is never used by an event from the socket
+    */
+    static constexpr const char* NAMESPACE = "local";
+
+    static bool IsLocal(const sio::event& event) { return event.get_nsp() == NAMESPACE; }
+};
@@ -0,0 +1,38 @@
+#include "MinimumAltitudeGridLoadEvent.h"
+#include "../ApiHelper.h"
+#include "../Surveillance/MinimumAltitudeWarning.h"
+#include "sio_client.h"
+
+/**
+* Event payload:
+*
+* {
+*	"file": "EXCDS-Bridge-msaw.bin"
+* }
+*
+* A relative path is taken from the plugin's folder. The ack holds "success" and the "path" that was loaded, with
+* a "reason" when the grid could not be loaded. The grid in use is kept when loading fails.
+*/
+
+MinimumAltitudeGridLoadEvent::MinimumAltitudeGridLoadEvent()
+	: TypedExcdsEvent(FLIGHT_PLAN_CHECK_NONE)
+{
+	// Loading a file is for EXCDS to ask for, not for storms or batches
+	_localDispatch = false;
+
+	_schema.String("file", &MinimumAltitudeGridLoadPayload::file, false);
+}
+
+void MinimumAltitudeGridLoadEvent::ExecuteEvent(sio::event& event, EuroScopePlugIn::CFlightPlan flightPlan, const MinimumAltitudeGridLoadPayload& payload)
+{
+	std::string path = ApiHelper::ResolvePluginPath(payload.file.empty() ? MinimumAltitudeWarning::DEFAULT_FILE : payload.file);
+
+	bool loaded = MinimumAltitudeWarning::GetInstance()->Load(path);
+
+	_response->get_map()["success"] = sio::bool_message::create(loaded);
+	_response->get_map()["path"] = sio::string_message::create(path);
+	if (!loaded)
+		_response->get_map()["reason"] = sio::string_message::create("Could not open the grid file, or it is not a minimum altitude grid");
+
+	SendResult(event);
+}
@@ -0,0 +1,21 @@
+#pragma once
+#include "TypedExcdsEvent.h"
+
+/**
+* Without a file, the default grid next to the plugin is loaded again.
+*/
+struct MinimumAltitudeGridLoadPayload
+{
+    std::string file;
+};
+
+class MinimumAltitudeGridLoadEvent :
+    public TypedExcdsEvent<MinimumAltitudeGridLoadPayload>
+{
+public:
+    MinimumAltitudeGridLoadEvent();
+
+    static const char* Name() { return "LOAD_MSAW_GRID"; }
+protected:
+    void ExecuteEvent(sio::event&, EuroScopePlugIn::CFlightPlan, const MinimumAltitudeGridLoadPayload&) override;
+};
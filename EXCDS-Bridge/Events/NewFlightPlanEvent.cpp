@@ -0,0 +1,44 @@
+#include "NewFlightPlanEvent.h"
+#include "sio_client.h"
+
+/**
+* Event payload:
+*
+* {
+*	"callsign": "AAL123",
+*	"type": "A320",
+*	"origin": "CYUL",
+*	"dest": "CYYZ",
+*	"route": "...",
+*	"fpType": "I",
+*	"alt": 35000
+* }
+*/
+
+NewFlightPlanEvent::NewFlightPlanEvent()
+{
+	_schema
+		.String("type", &NewFlightPlanPayload::type)
+		.String("origin", &NewFlightPlanPayload::origin)
+		.String("dest", &NewFlightPlanPayload::dest)
+		.String("route", &NewFlightPlanPayload::route)
+		.String("fpType", &NewFlightPlanPayload::fpType)
+		.Integer("alt", &NewFlightPlanPayload::alt);
+}
+
+void NewFlightPlanEvent::ExecuteEvent(sio::event& event, EuroScopePlugIn::CFlightPlan flightPlan, const NewFlightPlanPayload& payload)
+{
+	flightPlan.GetFlightPlanData().SetAircraftInfo(payload.type.c_str());
+	flightPlan.GetFlightPlanData().SetOrigin(payload.origin.c_str());
+	flightPlan.GetFlightPlanData().SetDestination(payload.dest.c_str());
+	flightPlan.GetFlightPlanData().SetRoute(payload.route.c_str());
+	flightPlan.GetFlightPlanData().SetPlanType(payload.fpType.c_str());
+	flightPlan.GetControllerAssignedData().SetClearedAltitude(0);
+	flightPlan.GetFlightPlanData().SetFinalAltitude(payload.alt);
+	flightPlan.GetControllerAssignedData().SetFinalAltitude(payload.alt);
+
+	Amend(flightPlan);
+
+	// Tell EXCDS the change is done
+	SendModified(event);
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include "TypedExcdsEvent.h"
+
+struct NewFlightPlanPayload
+{
+    std::string type;
+    std::string origin;
+    std::string dest;
+    std::string route;
+    std::string fpType;
+    int alt = 0;
+};
+
+class NewFlightPlanEvent :
+    public TypedExcdsEvent<NewFlightPlanPayload>
+{
+public:
+    NewFlightPlanEvent();
+
+    static const char* Name() { return "NEW_FLIGHT_PLAN"; }
+protected:
+    void ExecuteEvent(sio::event&, EuroScopePlugIn::CFlightPlan, const NewFlightPlanPayload&) override;
+};
@@ -0,0 +1,61 @@
+#include "PositionsUpdateEvent.h"
+#include "../MessageHandler.h"
+#include "../Airspace/FixIndex.h"
+#include "sio_client.h"
+
+/**
+* Event payload:
+*
+* {
+*	"positions": [{ "name": "BAY1", "lat": "N045.00.00.000", "lon": "W075.00.00.000" }, { "name": "YOW" }]
+* }
+*
+* A position without "lat" and "lon" is looked up by name in the sector file.
+*/
+
+PositionsUpdateEvent::PositionsUpdateEvent()
+	: TypedExcdsEvent(FLIGHT_PLAN_CHECK_NONE)
+{
+	_schema.Array("positions", &PositionsUpdatePayload::positions);
+
+	_positionSchema
+		.String("name", &EstimatePositionPayload::name)
+		.String("lat", &EstimatePositionPayload::lat, false)
+		.String("lon", &EstimatePositionPayload::lon, false);
+}
+
+void PositionsUpdateEvent::ExecuteEvent(sio::event& event, EuroScopePlugIn::CFlightPlan flightPlan, const PositionsUpdatePayload& payload)
+{
+	const std::vector<sio::message::ptr>& positions = payload.positions->get_vector();
+	std::vector<EstimatePosn> estimates;
+
+	for (const sio::message::ptr& position : positions)
+	{
+		EstimatePositionPayload estimate;
+		std::vector<std::string> errors;
+
+		if (!_positionSchema.Decode(position, estimate, errors))
+		{
+			SendInvalid(event, errors);
+			return;
+		}
+
+		EuroScopePlugIn::CPosition pos;
+		if (!estimate.lat.empty() && !estimate.lon.empty())
+		{
+			pos.LoadFromStrings(estimate.lon.c_str(), estimate.lat.c_str());
+		}
+		else if (!FixIndex::GetInstance()->Find(estimate.name, pos))
+		{
+			SendInvalid(event, { "Position '" + estimate.name + "' has no coordinates and is not in the sector file." });
+			return;
+		}
+
+		estimates.push_back(std::make_tuple(estimate.name, pos));
+	}
+
+	MessageHandler::SetEstimatePositions(estimates);
+
+	// Tell EXCDS the change is done
+	SendModified(event);
+}
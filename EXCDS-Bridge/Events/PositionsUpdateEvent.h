@@ -0,0 +1,30 @@
+#pragma once
+#include "TypedExcdsEvent.h"
+
+/**
+* One of the fixes the estimates in flight plan data are given for, with its position as EuroScope writes it.
+*/
+struct EstimatePositionPayload
+{
+    std::string name;
+    std::string lat;
+    std::string lon;
+};
+
+struct PositionsUpdatePayload
+{
+    sio::message::ptr positions;
+};
+
+class PositionsUpdateEvent :
+    public TypedExcdsEvent<PositionsUpdatePayload>
+{
+public:
+    PositionsUpdateEvent();
+
+    static const char* Name() { return "UPDATE_POSITIONS"; }
+protected:
+    void ExecuteEvent(sio::event&, EuroScopePlugIn::CFlightPlan, const PositionsUpdatePayload&) override;
+private:
+    EventSchema<EstimatePositionPayload> _positionSchema;
+};
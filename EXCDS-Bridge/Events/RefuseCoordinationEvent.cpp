@@ -0,0 +1,10 @@
+#include "RefuseCoordinationEvent.h"
+#include "sio_client.h"
+
+void RefuseCoordinationEvent::ExecuteEvent(sio::event& event, EuroScopePlugIn::CFlightPlan flightPlan)
+{
+	flightPlan.RefuseCoordination();
+
+	// Tell EXCDS the change is done
+	SendModified(event);
+}
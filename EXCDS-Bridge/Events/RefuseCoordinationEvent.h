@@ -0,0 +1,13 @@
+#pragma once
+#include "ExcdsEvent.h"
+
+class RefuseCoordinationEvent :
+    public ExcdsEvent
+{
+public:
+    RefuseCoordinationEvent() : ExcdsEvent(FLIGHT_PLAN_CHECK_EXISTS) {};
+
+    static const char* Name() { return "REFUSE_COORD"; }
+protected:
+    void ExecuteEvent(sio::event&, EuroScopePlugIn::CFlightPlan) override;
+};
@@ -0,0 +1,10 @@
+#include "RefuseHandoffEvent.h"
+#include "sio_client.h"
+
+void RefuseHandoffEvent::ExecuteEvent(sio::event& event, EuroScopePlugIn::CFlightPlan flightPlan)
+{
+	flightPlan.RefuseHandoff();
+
+	// Tell EXCDS the change is done
+	SendModified(event);
+}
@@ -0,0 +1,13 @@
+#pragma once
+#include "ExcdsEvent.h"
+
+class RefuseHandoffEvent :
+    public ExcdsEvent
+{
+public:
+    RefuseHandoffEvent() : ExcdsEvent(FLIGHT_PLAN_CHECK_EXISTS) {};
+
+    static const char* Name() { return "REFUSE_HANDOFF"; }
+protected:
+    void ExecuteEvent(sio::event&, EuroScopePlugIn::CFlightPlan) override;
+};
@@ -0,0 +1,50 @@
+#include "RouteDataRequestEvent.h"
+#include "sio_client.h"
+
+void RouteDataRequestEvent::ExecuteEvent(sio::event& event, EuroScopePlugIn::CFlightPlan flightPlan)
+{
+	sio::message::ptr response = sio::object_message::create();
+	response->get_map()["callsign"] = sio::string_message::create(flightPlan.GetCallsign());
+
+	sio::message::ptr arrayMessage = sio::array_message::create();
+	EuroScopePlugIn::CFlightPlanExtractedRoute route = flightPlan.GetExtractedRoute();
+
+	// Start from whichever is further along, the point we were sent direct to or the closest one
+	int directTo = route.GetPointsAssignedIndex();
+	int closestTo = route.GetPointsCalculatedIndex();
+	int highest = directTo > closestTo ? directTo : closestTo;
+
+	for (int i = highest; i < route.GetPointsNumber(); i++) {
+		sio::message::ptr msg = sio::object_message::create();
+		msg->get_map()["point"] = sio::string_message::create(route.GetPointName(i));
+		msg->get_map()["lat"] = sio::double_message::create(route.GetPointPosition(i).m_Latitude);
+		msg->get_map()["long"] = sio::double_message::create(route.GetPointPosition(i).m_Longitude);
+
+		arrayMessage->get_vector().push_back(msg);
+
+		if (route.GetPointDistanceInMinutes(i) > flightPlan.GetSectorExitMinutes())
+			break;
+	}
+
+	double lat = 0;
+	double lon = 0;
+
+	if (flightPlan.GetCorrelatedRadarTarget().IsValid())
+	{
+		lat = flightPlan.GetCorrelatedRadarTarget().GetPosition().GetPosition().m_Latitude;
+		lon = flightPlan.GetCorrelatedRadarTarget().GetPosition().GetPosition().m_Longitude;
+	}
+	else if (flightPlan.GetFPTrackPosition().IsValid())
+	{
+		lat = flightPlan.GetFPTrackPosition().GetPosition().m_Latitude;
+		lon = flightPlan.GetFPTrackPosition().GetPosition().m_Longitude;
+	}
+
+	response->get_map()["lat"] = sio::double_message::create(lat);
+	response->get_map()["long"] = sio::double_message::create(lon);
+
+	response->get_map()["route"] = arrayMessage;
+	CEXCDSBridge::Emit("ROUTE_DATA", response);
+
+	SendDone(event);
+}
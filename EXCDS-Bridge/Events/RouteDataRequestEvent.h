@@ -0,0 +1,13 @@
+#pragma once
+#include "ExcdsEvent.h"
+
+class RouteDataRequestEvent :
+    public ExcdsEvent
+{
+public:
+    RouteDataRequestEvent() : ExcdsEvent(FLIGHT_PLAN_CHECK_EXISTS) {};
+
+    static const char* Name() { return "REQUEST_ROUTE_DATA"; }
+protected:
+    void ExecuteEvent(sio::event&, EuroScopePlugIn::CFlightPlan) override;
+};
@@ -0,0 +1,33 @@
+#include "RouteUpdateEvent.h"
+#include "sio_client.h"
+
+/**
+* Event payload:
+*
+* {
+*	"callsign": "AAL123",
+*	"value": "DCT YOW J538 YXU"
+* }
+*/
+
+RouteUpdateEvent::RouteUpdateEvent()
+{
+	_schema.String("value", &RouteUpdatePayload::value);
+}
+
+void RouteUpdateEvent::ExecuteEvent(sio::event& event, EuroScopePlugIn::CFlightPlan flightPlan, const RouteUpdatePayload& payload)
+{
+	bool isAssigned = flightPlan.GetFlightPlanData().SetRoute(payload.value.c_str());
+
+	if (!isAssigned) {
+		SendNotModified(event, "Unknown reason.");
+
+		CEXCDSBridge::SendEuroscopeMessage(flightPlan.GetCallsign(), "Cannot modify.", "UNKNOWN");
+		return;
+	}
+
+	Amend(flightPlan);
+
+	// Tell EXCDS the change is done
+	SendModified(event);
+}
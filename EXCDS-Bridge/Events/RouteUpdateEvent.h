@@ -0,0 +1,18 @@
+#pragma once
+#include "TypedExcdsEvent.h"
+
+struct RouteUpdatePayload
+{
+    std::string value;
+};
+
+class RouteUpdateEvent :
+    public TypedExcdsEvent<RouteUpdatePayload>
+{
+public:
+    RouteUpdateEvent();
+
+    static const char* Name() { return "UPDATE_ROUTE"; }
+protected:
+    void ExecuteEvent(sio::event&, EuroScopePlugIn::CFlightPlan, const RouteUpdatePayload&) override;
+};
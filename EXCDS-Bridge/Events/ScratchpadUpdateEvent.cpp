@@ -1,5 +1,6 @@
 #include "ScratchpadUpdateEvent.h"
 #include "../Response/ExcdsResponse.h"
+#include "../Diagnostics/Metrics.h"
 #include "sio_client.h"
 
 /**
@@ -11,16 +12,20 @@
 * }
 */
 
-void ScratchpadUpdateEvent::ExecuteEvent(sio::event& event, EuroScopePlugIn::CFlightPlan flightPlan)
+ScratchpadUpdateEvent::ScratchpadUpdateEvent()
 {
 	// The value to set the scratchpad to
-    std::string value = GetMessageValue(event)["value"]->get_string();
+	_schema.String("value", &ScratchpadUpdatePayload::value);
+}
 
+void ScratchpadUpdateEvent::ExecuteEvent(sio::event& event, EuroScopePlugIn::CFlightPlan flightPlan, const ScratchpadUpdatePayload& payload)
+{
 	bool isAssigned = false;
 	try {
-		isAssigned = flightPlan.GetControllerAssignedData().SetScratchPadString(value.c_str());
+		isAssigned = flightPlan.GetControllerAssignedData().SetScratchPadString(payload.value.c_str());
 	}
 	catch (...) {
+		Metrics::CountException("ScratchpadUpdateEvent", "EXCDS Error: Update scratchpad error");
 		SendNotModified(event, "Exception thrown when attempting to modify scratchpad.");
 
 		CEXCDSBridge::SendEuroscopeMessage(flightPlan.GetCallsign(), SCRCHPD_STRNG_NOT_SET);
@@ -1,9 +1,18 @@
 #pragma once
-#include "ExcdsEvent.h"
+#include "TypedExcdsEvent.h"
+
+struct ScratchpadUpdatePayload
+{
+    std::string value;
+};
+
 class ScratchpadUpdateEvent :
-    public ExcdsEvent
+    public TypedExcdsEvent<ScratchpadUpdatePayload>
 {
 public:
-    void ExecuteEvent(sio::event&, EuroScopePlugIn::CFlightPlan) override;
-};
+    ScratchpadUpdateEvent();
 
+    static const char* Name() { return "UPDATE_SCRATCHPAD"; }
+protected:
+    void ExecuteEvent(sio::event&, EuroScopePlugIn::CFlightPlan, const ScratchpadUpdatePayload&) override;
+};
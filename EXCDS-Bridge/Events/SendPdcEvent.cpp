@@ -0,0 +1,29 @@
+#include "SendPdcEvent.h"
+#include "../MessageHandler.h"
+#include "sio_client.h"
+
+/**
+* Event payload:
+*
+* {
+*	"callsign": "AAL123",
+*	"value": "PDC text."
+* }
+*/
+
+SendPdcEvent::SendPdcEvent()
+	: TypedExcdsEvent(FLIGHT_PLAN_CHECK_NONE)
+{
+	// Sent to the pilot whether or not we have their flight plan
+	_schema
+		.String("callsign", &SendPdcPayload::callsign)
+		.String("value", &SendPdcPayload::value);
+}
+
+void SendPdcEvent::ExecuteEvent(sio::event& event, EuroScopePlugIn::CFlightPlan flightPlan, const SendPdcPayload& payload)
+{
+	MessageHandler::SendChatMessage(payload.callsign, payload.value);
+
+	// Tell EXCDS the change is done
+	SendModified(event);
+}
@@ -0,0 +1,19 @@
+#pragma once
+#include "TypedExcdsEvent.h"
+
+struct SendPdcPayload
+{
+    std::string callsign;
+    std::string value;
+};
+
+class SendPdcEvent :
+    public TypedExcdsEvent<SendPdcPayload>
+{
+public:
+    SendPdcEvent();
+
+    static const char* Name() { return "SEND_PDC"; }
+protected:
+    void ExecuteEvent(sio::event&, EuroScopePlugIn::CFlightPlan, const SendPdcPayload&) override;
+};
@@ -0,0 +1,50 @@
+#include "SpeedUpdateEvent.h"
+#include "sio_client.h"
+
+/**
+* Event payload:
+*
+* {
+*	"callsign": "AAL123",
+*	"id": "...",
+*	"assignedMach": 78,
+*	"assignedSpeed": 0,
+*	"filedSpeed": 0
+* }
+*/
+
+SpeedUpdateEvent::SpeedUpdateEvent()
+{
+	_schema
+		.String("id", &SpeedUpdatePayload::id, false)
+		.Integer("assignedMach", &SpeedUpdatePayload::assignedMach)
+		.Integer("assignedSpeed", &SpeedUpdatePayload::assignedSpeed)
+		.Integer("filedSpeed", &SpeedUpdatePayload::filedSpeed);
+}
+
+void SpeedUpdateEvent::ExecuteEvent(sio::event& event, EuroScopePlugIn::CFlightPlan flightPlan, const SpeedUpdatePayload& payload)
+{
+	// Assign either a speed or mach, if provided
+	bool isAssigned = false;
+	if (payload.assignedMach > 0) {
+		isAssigned = flightPlan.GetControllerAssignedData().SetAssignedMach(payload.assignedMach);
+	}
+	else if (payload.assignedSpeed > 0) {
+		isAssigned = flightPlan.GetControllerAssignedData().SetAssignedSpeed(payload.assignedSpeed);
+	}
+
+	// Assign the filed speed, if provided
+	if (payload.filedSpeed > 0) {
+		isAssigned = flightPlan.GetFlightPlanData().SetTrueAirspeed(payload.filedSpeed);
+	}
+
+	if (!isAssigned) {
+		SendNotModified(event, "Unknown reason.");
+
+		CEXCDSBridge::SendEuroscopeMessage(flightPlan.GetCallsign(), "Cannot modify.", "UNKNOWN");
+		return;
+	}
+
+	// Tell EXCDS the change is done
+	SendModified(event);
+}
@@ -0,0 +1,24 @@
+#pragma once
+#include "TypedExcdsEvent.h"
+
+/**
+* Speeds of 0 are left as they are. A mach number takes the place of an assigned speed.
+*/
+struct SpeedUpdatePayload
+{
+    std::string id;
+    int assignedMach = 0;
+    int assignedSpeed = 0;
+    int filedSpeed = 0;
+};
+
+class SpeedUpdateEvent :
+    public TypedExcdsEvent<SpeedUpdatePayload>
+{
+public:
+    SpeedUpdateEvent();
+
+    static const char* Name() { return "UPDATE_SPEED"; }
+protected:
+    void ExecuteEvent(sio::event&, EuroScopePlugIn::CFlightPlan, const SpeedUpdatePayload&) override;
+};
@@ -0,0 +1,39 @@
+#include "SquawkUpdateEvent.h"
+#include "../MessageHandler.h"
+#include "../Surveillance/SquawkIndex.h"
+#include "sio_client.h"
+
+/**
+* Event payload:
+*
+* {
+*	"callsign": "AAL123",
+*	"prefix": "02"
+* }
+*/
+
+SquawkUpdateEvent::SquawkUpdateEvent()
+{
+	// The first two digits of the code, the rest is picked from what is free
+	_schema.String("prefix", &SquawkUpdatePayload::prefix);
+}
+
+void SquawkUpdateEvent::ExecuteEvent(sio::event& event, EuroScopePlugIn::CFlightPlan flightPlan, const SquawkUpdatePayload& payload)
+{
+	std::string newCode = MessageHandler::SquawkGenerator(payload.prefix);
+
+	bool isAssigned = flightPlan.GetControllerAssignedData().SetSquawk(newCode.c_str());
+
+	if (!isAssigned) {
+		SendNotModified(event, "Unknown reason.");
+
+		CEXCDSBridge::SendEuroscopeMessage(flightPlan.GetCallsign(), "Cannot modify.", "UNKNOWN");
+		return;
+	}
+
+	// Taken straight away, so the next allocation does not wait for EuroScope to report it
+	SquawkIndex::GetInstance()->UpdateAssigned(flightPlan.GetCallsign(), newCode);
+
+	// Tell EXCDS the change is done
+	SendModified(event);
+}
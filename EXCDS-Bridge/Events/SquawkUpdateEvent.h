@@ -0,0 +1,18 @@
+#pragma once
+#include "TypedExcdsEvent.h"
+
+struct SquawkUpdatePayload
+{
+    std::string prefix;
+};
+
+class SquawkUpdateEvent :
+    public TypedExcdsEvent<SquawkUpdatePayload>
+{
+public:
+    SquawkUpdateEvent();
+
+    static const char* Name() { return "UPDATE_SQUAWK"; }
+protected:
+    void ExecuteEvent(sio::event&, EuroScopePlugIn::CFlightPlan, const SquawkUpdatePayload&) override;
+};
@@ -0,0 +1,37 @@
+#include "StatusUpdateEvent.h"
+#include "../MessageHandler.h"
+#include "sio_client.h"
+
+/**
+* Event payload:
+*
+* {
+*	"callsign": "AAL123",
+*	"status": "TXRL",
+*	"departure_time": "1430"
+* }
+*/
+
+StatusUpdateEvent::StatusUpdateEvent()
+{
+	_schema
+		.String("status", &StatusUpdatePayload::status)
+		.String("departure_time", &StatusUpdatePayload::departureTime);
+}
+
+void StatusUpdateEvent::ExecuteEvent(sio::event& event, EuroScopePlugIn::CFlightPlan flightPlan, const StatusUpdatePayload& payload)
+{
+	bool success = MessageHandler::StatusAssign(payload.status, flightPlan, payload.departureTime);
+
+	Amend(flightPlan);
+
+	if (!success) {
+		SendNotModified(event, "Unknown reason.");
+
+		CEXCDSBridge::SendEuroscopeMessage(flightPlan.GetCallsign(), "Cannot modify.", "UNKNOWN");
+		return;
+	}
+
+	// Tell EXCDS the change is done
+	SendModified(event);
+}
@@ -0,0 +1,19 @@
+#pragma once
+#include "TypedExcdsEvent.h"
+
+struct StatusUpdatePayload
+{
+    std::string status;
+    std::string departureTime;
+};
+
+class StatusUpdateEvent :
+    public TypedExcdsEvent<StatusUpdatePayload>
+{
+public:
+    StatusUpdateEvent();
+
+    static const char* Name() { return "UPDATE_STATUS"; }
+protected:
+    void ExecuteEvent(sio::event&, EuroScopePlugIn::CFlightPlan, const StatusUpdatePayload&) override;
+};
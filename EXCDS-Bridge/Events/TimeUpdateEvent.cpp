@@ -0,0 +1,34 @@
+#include "TimeUpdateEvent.h"
+#include "sio_client.h"
+
+/**
+* Event payload:
+*
+* {
+*	"callsign": "AAL123",
+*	"time": "1432"
+* }
+*/
+
+TimeUpdateEvent::TimeUpdateEvent()
+{
+	_schema.String("time", &TimeUpdatePayload::time);
+}
+
+void TimeUpdateEvent::ExecuteEvent(sio::event& event, EuroScopePlugIn::CFlightPlan flightPlan, const TimeUpdatePayload& payload)
+{
+	// EuroScope only takes an actual departure time from an aircraft that has departed
+	flightPlan.GetControllerAssignedData().SetScratchPadString("DEPA");
+	bool isAssigned = flightPlan.GetFlightPlanData().SetActualDepartureTime(payload.time.c_str());
+	flightPlan.GetControllerAssignedData().SetScratchPadString("");
+
+	if (!isAssigned) {
+		SendNotModified(event, "Unknown reason.");
+
+		CEXCDSBridge::SendEuroscopeMessage(flightPlan.GetCallsign(), "Cannot modify.", "UNKNOWN");
+		return;
+	}
+
+	// Tell EXCDS the change is done
+	SendModified(event);
+}
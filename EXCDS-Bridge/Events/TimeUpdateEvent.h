@@ -0,0 +1,18 @@
+#pragma once
+#include "TypedExcdsEvent.h"
+
+struct TimeUpdatePayload
+{
+    std::string time;
+};
+
+class TimeUpdateEvent :
+    public TypedExcdsEvent<TimeUpdatePayload>
+{
+public:
+    TimeUpdateEvent();
+
+    static const char* Name() { return "UPDATE_TIME"; }
+protected:
+    void ExecuteEvent(sio::event&, EuroScopePlugIn::CFlightPlan, const TimeUpdatePayload&) override;
+};
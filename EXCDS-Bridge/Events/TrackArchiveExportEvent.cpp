@@ -0,0 +1,70 @@
+#include <ctime>
+
+#include "TrackArchiveExportEvent.h"
+#include "../ApiHelper.h"
+#include "../Surveillance/TrackArchive.h"
+#include "sio_client.h"
+
+/**
+* Event payload, every field optional:
+*
+* {
+*	"file": "tracks.csv",
+*	"from": 1700000000,
+*	"to": 1700003600
+* }
+*
+* A relative path is taken from the plugin's folder. The ack holds "success", the "path" written and the number of
+* "points", with a "reason" when the file could not be written.
+*/
+
+TrackArchiveExportEvent::TrackArchiveExportEvent()
+	: TypedExcdsEvent(FLIGHT_PLAN_CHECK_NONE)
+{
+	// Writing a file is for EXCDS to ask for, not for storms or batches
+	_localDispatch = false;
+
+	_schema
+		.String("file", &TrackArchiveExportPayload::file, false)
+		.Integer("from", &TrackArchiveExportPayload::from, false)
+		.Integer("to", &TrackArchiveExportPayload::to, false);
+}
+
+void TrackArchiveExportEvent::ExecuteEvent(sio::event& event, EuroScopePlugIn::CFlightPlan flightPlan, const TrackArchiveExportPayload& payload)
+{
+	if (payload.from > payload.to)
+	{
+		SendInvalid(event, { "Field 'from' must not be after 'to'." });
+		return;
+	}
+
+	std::string path;
+	if (!payload.file.empty())
+	{
+		path = ApiHelper::ResolvePluginPath(payload.file);
+	}
+	else
+	{
+		char buf[32];
+		struct tm newTime;
+		time_t t = time(0);
+
+		localtime_s(&newTime, &t);
+		std::strftime(buf, 32, "%Y%m%d-%H%M%S", &newTime);
+		path = ApiHelper::ResolvePluginPath("EXCDS-Bridge-tracks-" + std::string(buf) + ".csv");
+	}
+
+	// Not given is everything after the start, rather than up to the year 2038
+	int64_t to = payload.to == INT_MAX ? INT64_MAX : payload.to;
+
+	size_t points = 0;
+	bool exported = TrackArchive::GetInstance()->Export(path, payload.from, to, points);
+
+	_response->get_map()["success"] = sio::bool_message::create(exported);
+	_response->get_map()["path"] = sio::string_message::create(path);
+	_response->get_map()["points"] = sio::int_message::create(points);
+	if (!exported)
+		_response->get_map()["reason"] = sio::string_message::create("Could not open the export file");
+
+	SendResult(event);
+}
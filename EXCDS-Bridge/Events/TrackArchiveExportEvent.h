@@ -0,0 +1,25 @@
+#pragma once
+#include <climits>
+#include "TypedExcdsEvent.h"
+
+/**
+* Without a file, the archive is written next to the plugin under a name with the current time. Without times, every
+* archived point is written. Times are seconds since the epoch.
+*/
+struct TrackArchiveExportPayload
+{
+    std::string file;
+    int from = 0;
+    int to = INT_MAX;
+};
+
+class TrackArchiveExportEvent :
+    public TypedExcdsEvent<TrackArchiveExportPayload>
+{
+public:
+    TrackArchiveExportEvent();
+
+    static const char* Name() { return "EXPORT_TRACK_ARCHIVE"; }
+protected:
+    void ExecuteEvent(sio::event&, EuroScopePlugIn::CFlightPlan, const TrackArchiveExportPayload&) override;
+};
@@ -0,0 +1,110 @@
+#include "TrackArchiveQueryEvent.h"
+#include "../Surveillance/TrackArchive.h"
+#include "sio_client.h"
+
+/**
+* Event payload, with either the callsigns or both times:
+*
+* {
+*	"callsigns": ["AAL123", "ACA456"],
+*	"from": 1700000000,
+*	"to": 1700003600
+* }
+*
+* The ack holds one track per target with points in the range under "tracks", in the same columns as
+* REQUEST_TRACK_HISTORY, with times in seconds. When the points would go over MAX_POINTS, the track that reaches it
+* is cut short at the oldest points that fit, the targets after it are not read at all and "truncated" is true.
+* "resume" then lists each of those targets with the time to query it again from:
+*
+*	"resume": [{ "callsign": "AAL123", "from": 1700001800 }]
+*/
+
+TrackArchiveQueryEvent::TrackArchiveQueryEvent()
+	: TypedExcdsEvent(FLIGHT_PLAN_CHECK_NONE)
+{
+	_schema
+		.Array("callsigns", &TrackArchiveQueryPayload::callsigns, false)
+		.Integer("from", &TrackArchiveQueryPayload::from, false)
+		.Integer("to", &TrackArchiveQueryPayload::to, false);
+}
+
+void TrackArchiveQueryEvent::ExecuteEvent(sio::event& event, EuroScopePlugIn::CFlightPlan flightPlan, const TrackArchiveQueryPayload& payload)
+{
+	if (payload.from > payload.to)
+	{
+		SendInvalid(event, { "Field 'from' must not be after 'to'." });
+		return;
+	}
+
+	// The whole archive is for EXPORT_TRACK_ARCHIVE
+	bool bounded = payload.from > 0 && payload.to < INT_MAX && payload.to - payload.from <= MAX_SPAN;
+	if (!payload.callsigns && !bounded)
+	{
+		SendInvalid(event, { "Field 'callsigns', or 'from' and 'to' at most " + std::to_string(MAX_SPAN) + " seconds apart, must be given." });
+		return;
+	}
+
+	TrackArchive* archive = TrackArchive::GetInstance();
+	std::vector<std::string> callsigns;
+
+	if (payload.callsigns)
+	{
+		for (const sio::message::ptr& callsign : payload.callsigns->get_vector())
+		{
+			if (!callsign || callsign->get_flag() != sio::message::flag_string)
+			{
+				SendInvalid(event, { "Field 'callsigns' must be an array of strings." });
+				return;
+			}
+
+			callsigns.push_back(callsign->get_string());
+		}
+	}
+	else
+	{
+		callsigns = archive->GetCallsigns();
+	}
+
+	sio::message::ptr tracks = sio::array_message::create();
+	sio::message::ptr resume = sio::array_message::create();
+	size_t points = 0;
+
+	for (const std::string& callsign : callsigns)
+	{
+		int64_t resumeFrom = payload.from;
+		bool truncated = points >= MAX_POINTS;
+
+		// Once the ack is full the remaining targets are not decoded, only listed to be asked for again
+		if (!truncated)
+		{
+			// Targets without points in the range are left out
+			sio::message::ptr track = archive->ToMessage(callsign, payload.from, payload.to, MAX_POINTS - points, truncated);
+
+			if (track)
+			{
+				const std::vector<sio::message::ptr>& times = track->get_map()["time"]->get_vector();
+
+				tracks->get_vector().push_back(track);
+				points += times.size();
+
+				// Points sharing the last second may have been cut, so that second is asked for again
+				resumeFrom = times.back()->get_int();
+			}
+		}
+
+		if (truncated)
+		{
+			sio::message::ptr entry = sio::object_message::create();
+			entry->get_map()["callsign"] = sio::string_message::create(callsign);
+			entry->get_map()["from"] = sio::int_message::create(resumeFrom);
+
+			resume->get_vector().push_back(entry);
+		}
+	}
+
+	_response->get_map()["tracks"] = tracks;
+	_response->get_map()["count"] = sio::int_message::create(tracks->get_vector().size());
+	_response->get_map()["truncated"] = sio::bool_message::create(!resume->get_vector().empty());
+	_response->get_map()["resume"] = resume;
+	SendResult(event);
+}
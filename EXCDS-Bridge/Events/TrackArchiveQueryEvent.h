@@ -0,0 +1,32 @@
+#pragma once
+#include <climits>
+#include "TypedExcdsEvent.h"
+
+/**
+* Without callsigns, every archived target is sent, and both times must be given at most MAX_SPAN apart. Times are
+* seconds since the epoch.
+*/
+struct TrackArchiveQueryPayload
+{
+    sio::message::ptr callsigns;
+    int from = 0;
+    int to = INT_MAX;
+};
+
+class TrackArchiveQueryEvent :
+    public TypedExcdsEvent<TrackArchiveQueryPayload>
+{
+public:
+    TrackArchiveQueryEvent();
+
+    /**
+    * Points in one ack. A larger query is cut short and marked truncated; EXPORT_TRACK_ARCHIVE is the way to get
+    * everything.
+    */
+    static const size_t MAX_POINTS = 20000;
+    static const int MAX_SPAN = 3600;
+
+    static const char* Name() { return "QUERY_TRACK_ARCHIVE"; }
+protected:
+    void ExecuteEvent(sio::event&, EuroScopePlugIn::CFlightPlan, const TrackArchiveQueryPayload&) override;
+};
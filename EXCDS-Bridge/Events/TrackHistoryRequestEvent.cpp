@@ -0,0 +1,67 @@
+#include "TrackHistoryRequestEvent.h"
+#include "../Surveillance/TrackHistory.h"
+#include "sio_client.h"
+
+/**
+* Event payload, with every field optional:
+*
+* {
+*	"callsigns": ["AAL123", "ACA456"],
+*	"count": 10
+* }
+*
+* The ack holds one trail per target under "tracks", each with the newest "count" points, or all of them, oldest first.
+*/
+
+TrackHistoryRequestEvent::TrackHistoryRequestEvent()
+	: TypedExcdsEvent(FLIGHT_PLAN_CHECK_NONE)
+{
+	_schema
+		.Array("callsigns", &TrackHistoryRequestPayload::callsigns, false)
+		.Integer("count", &TrackHistoryRequestPayload::count, false);
+}
+
+void TrackHistoryRequestEvent::ExecuteEvent(sio::event& event, EuroScopePlugIn::CFlightPlan flightPlan, const TrackHistoryRequestPayload& payload)
+{
+	if (payload.count < 0)
+	{
+		SendInvalid(event, { "Field 'count' must not be negative." });
+		return;
+	}
+
+	TrackHistory* history = TrackHistory::GetInstance();
+	std::vector<std::string> callsigns;
+
+	if (payload.callsigns)
+	{
+		for (const sio::message::ptr& callsign : payload.callsigns->get_vector())
+		{
+			if (!callsign || callsign->get_flag() != sio::message::flag_string)
+			{
+				SendInvalid(event, { "Field 'callsigns' must be an array of strings." });
+				return;
+			}
+
+			callsigns.push_back(callsign->get_string());
+		}
+	}
+	else
+	{
+		callsigns = history->GetCallsigns();
+	}
+
+	size_t count = payload.count > 0 ? payload.count : TrackHistory::LENGTH;
+
+	sio::message::ptr tracks = sio::array_message::create();
+	for (const std::string& callsign : callsigns)
+	{
+		// Targets without a history are left out
+		sio::message::ptr track = history->ToMessage(callsign, count);
+		if (track)
+			tracks->get_vector().push_back(track);
+	}
+
+	_response->get_map()["tracks"] = tracks;
+	_response->get_map()["count"] = sio::int_message::create(tracks->get_vector().size());
+	SendResult(event);
+}
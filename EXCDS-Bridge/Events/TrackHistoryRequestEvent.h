@@ -0,0 +1,22 @@
+#pragma once
+#include "TypedExcdsEvent.h"
+
+/**
+* Without callsigns, every target with a history is sent.
+*/
+struct TrackHistoryRequestPayload
+{
+    sio::message::ptr callsigns;
+    int count = 0;
+};
+
+class TrackHistoryRequestEvent :
+    public TypedExcdsEvent<TrackHistoryRequestPayload>
+{
+public:
+    TrackHistoryRequestEvent();
+
+    static const char* Name() { return "REQUEST_TRACK_HISTORY"; }
+protected:
+    void ExecuteEvent(sio::event&, EuroScopePlugIn::CFlightPlan, const TrackHistoryRequestPayload&) override;
+};
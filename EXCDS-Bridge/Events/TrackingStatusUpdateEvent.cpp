@@ -0,0 +1,36 @@
+#include "TrackingStatusUpdateEvent.h"
+#include "sio_client.h"
+
+/**
+* Event payload:
+*
+* {
+*	"callsign": "AAL123",
+*	"assumed": true
+* }
+*/
+
+TrackingStatusUpdateEvent::TrackingStatusUpdateEvent()
+{
+	_schema.Boolean("assumed", &TrackingStatusUpdatePayload::assumed);
+}
+
+void TrackingStatusUpdateEvent::ExecuteEvent(sio::event& event, EuroScopePlugIn::CFlightPlan flightPlan, const TrackingStatusUpdatePayload& payload)
+{
+	bool isAssigned;
+
+	if (payload.assumed)
+		isAssigned = flightPlan.StartTracking();
+	else
+		isAssigned = flightPlan.EndTracking();
+
+	if (!isAssigned) {
+		SendNotModified(event, "Unknown reason.");
+
+		CEXCDSBridge::SendEuroscopeMessage(flightPlan.GetCallsign(), "Cannot modify.", "UNKNOWN");
+		return;
+	}
+
+	// Tell EXCDS the change is done
+	SendModified(event);
+}
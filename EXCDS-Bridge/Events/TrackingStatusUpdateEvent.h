@@ -0,0 +1,18 @@
+#pragma once
+#include "TypedExcdsEvent.h"
+
+struct TrackingStatusUpdatePayload
+{
+    bool assumed = false;
+};
+
+class TrackingStatusUpdateEvent :
+    public TypedExcdsEvent<TrackingStatusUpdatePayload>
+{
+public:
+    TrackingStatusUpdateEvent();
+
+    static const char* Name() { return "UPDATE_TRACKING_STATUS"; }
+protected:
+    void ExecuteEvent(sio::event&, EuroScopePlugIn::CFlightPlan, const TrackingStatusUpdatePayload&) override;
+};
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "ExcdsEvent.h"
+#include "EventSchema.h"
+
+/**
+* An event whose payload is decoded into a Payload struct before it is executed.
+*
+* Derived events declare their fields on _schema in their constructor. A payload that does not match the schema is
+* acknowledged as not modified, with the reasons in the ack, and the event is not executed.
+*/
+template <typename Payload>
+class TypedExcdsEvent :
+    public ExcdsEvent
+{
+public:
+    TypedExcdsEvent() {};
+    TypedExcdsEvent(FlightPlanCheck flightPlanCheck) : ExcdsEvent(flightPlanCheck) {};
+protected:
+    EventSchema<Payload> _schema;
+
+    /**
+    * Called with the decoded payload once it has been validated.
+    */
+    virtual void ExecuteEvent(sio::event&, EuroScopePlugIn::CFlightPlan, const Payload&) = 0;
+
+    void ExecuteEvent(sio::event& event, EuroScopePlugIn::CFlightPlan flightPlan) override
+    {
+        Payload payload;
+        std::vector<std::string> errors;
+
+        if (!_schema.Decode(event.get_message(), payload, errors))
+        {
+            SendInvalid(event, errors);
+            return;
+        }
+
+        ExecuteEvent(event, flightPlan, payload);
+    }
+};
@@ -8,8 +8,19 @@
 #include <Windows.h>
 
 #include "ApiHelper.h"
+#include "Airspace/ControllerRoster.h"
 #include "EuroScopePlugIn.h"
 #include "CEXCDSBridge.h"
+#include "Diagnostics/CommandTracer.h"
+#include "Diagnostics/Metrics.h"
+#include "Diagnostics/Profiler.h"
+#include "Replay/SessionRecorder.h"
+#include "Replay/SessionReplayer.h"
+#include "Simulation/TrafficGenerator.h"
+#include "Simulation/LoopbackSocket.h"
+#include "Simulation/LoadTest.h"
+#include "Events/AmendmentCoalescer.h"
+#include "Surveillance/SquawkIndex.h"
 
 #include "MessageHandler.h"
 
@@ -25,43 +36,10 @@ using namespace sio;
 * ---------------------------
 */
 
-typedef std::tuple < std::string, EuroScopePlugIn::CPosition> EstimatePosn;
 std::vector <EstimatePosn> estimates;
 
 #pragma region Update_Methods
 
-void MessageHandler::UpdatePositions(sio::event& e)
-{
-	try {
-		typedef std::tuple <std::string, std::string, std::string> pos;
-		// Send the positions as a JSON formatted tuple array | 0 is name, 1 is lat, 2 is lon
-		std::vector<message::ptr> positions = e.get_message()->get_map()["positions"]->get_vector();
-
-		estimates.clear();
-
-		// Loop through the positions and update them
-		for (message::ptr position : positions) {
-			std::string name = position->get_map()["name"]->get_string();
-			std::string lat = position->get_map()["lat"]->get_string();
-			std::string lon = position->get_map()["lon"]->get_string();
-
-			OutputDebugString(name.c_str());
-			OutputDebugString(" | ");
-			OutputDebugString(lat.c_str());
-			OutputDebugString(" | ");
-			OutputDebugString(lon.c_str());
-			OutputDebugString("\n");
-
-			EuroScopePlugIn::CPosition pos;
-			pos.LoadFromStrings(lon.c_str(), lat.c_str());
-			estimates.push_back(std::make_tuple(name, pos));
-		}
-	}
-	catch (...) {
-		OutputDebugString("Failed to update positions.");
-	}
-}
-
 struct handleData {
     unsigned long process_id;
     HWND window_handle;
@@ -93,493 +71,36 @@ HWND findMainWindow(unsigned long process_id)
     return data.window_handle;
 }
 
-void MessageHandler::SendPDC(sio::event& e)
+void MessageHandler::SetEstimatePositions(const std::vector<EstimatePosn>& positions)
 {
-	try {
-		// Get aircraft data from EXCDS
-		std::string callsign = e.get_message()->get_map()["callsign"]->get_string();
-		std::string value = e.get_message()->get_map()["value"]->get_string();
-
-		// Init Response
-		message::ptr response = object_message::create();
-
-		bool isAssigned = false;
-
-		// Get all windows with the specified title		
-		HWND mainWindow = findMainWindow(GetCurrentProcessId());
-
-		// If the window isn't active, but is visible (not minimized)
-		// - Select the window
-		// - .chat
-		// - Select back
-
-		// If minimized:
-		// - Move it to a random x,y location (negative)
-		// - Open it
-		// - send the chat
-		// - minimize and put back where it was
-
-		SetForegroundWindow(mainWindow);
-		std::string pdcTarget = ".chat " + callsign;
-		MessageHandler::SendKeyboardString(pdcTarget);
-		MessageHandler::SendKeyboardPresses({ ENTER });
-		MessageHandler::SendKeyboardString(value);
-		MessageHandler::SendKeyboardPresses({ ENTER });
-
-		// Tell EXCDS the change is done
-		response->get_map()["modified"] = bool_message::create(true);
-		e.put_ack_message(response);
-	}
-	catch (...) {
-		CEXCDSBridge::SendEuroscopeMessage("PDC WARNING", "Failed to send", "UNKNOWN");
-		OutputDebugString("EXCDS Error: Private message send error");
-	}
+	estimates = positions;
 }
 
-void MessageHandler::HandoffTarget(sio::event& e)
-{
-	try {
-
-		// Get aircraft data from EXCDS
-		std::string callsign = e.get_message()->get_map()["callsign"]->get_string();
-		std::string cjs = e.get_message()->get_map()["cjs"]->get_string();
-
-		// Init Response
-		message::ptr response = object_message::create();
-		response->get_map()["callsign"] = string_message::create(callsign);
-
-		EuroScopePlugIn::CFlightPlan fp = CEXCDSBridge::GetInstance()->FlightPlanSelect(callsign.c_str());
-		EuroScopePlugIn::CController nextController = CEXCDSBridge::GetInstance()->ControllerSelectByPositionId(cjs.c_str());
-
-		// Is the flight plan valid?
-		if (!FlightPlanChecks(fp, response, e)) {
-			return;
-		}
-
-		if (!nextController.IsValid()) {
-			CEXCDSBridge::SendEuroscopeMessage(callsign.c_str(), "Cannot handoff", "UNKNOWN");
-			return;
-		}
-
-		bool isAssigned = fp.InitiateHandoff(nextController.GetCallsign());
-
-		if (!isAssigned) {
-			e.put_ack_message(NotModified(response, "Cound not handoff target."));
-
-			CEXCDSBridge::SendEuroscopeMessage(callsign.c_str(), "Cannot modify.", "UNKNOWN");
-			return;
-		}
-
-		// Tell EXCDS the change is done
-		response->get_map()["modified"] = bool_message::create(true);
-		e.put_ack_message(response);
-	} catch (...) {
-		OutputDebugString("EXCDS Error: Handoff target error");
-	}
-}
-
-void MessageHandler::RefuseHandoff(sio::event& e)
-{
-	try {
-	// Get aircraft data from EXCDS
-	std::string callsign = e.get_message()->get_map()["callsign"]->get_string();
-
-	EuroScopePlugIn::CFlightPlan fp = CEXCDSBridge::GetInstance()->FlightPlanSelect(callsign.c_str());
-
-	// Is the flight plan valid?
-	if (!fp.IsValid()) {
-		return;
-	}
-
-	fp.RefuseHandoff();
-	}
-	catch (...) {
-		OutputDebugString("EXCDS Error: Refuse handoff error");
-	}
-}
-
-void MessageHandler::AcceptHandoff(sio::event& e)
-{
-	try {
-	// Get aircraft data from EXCDS
-	std::string callsign = e.get_message()->get_map()["callsign"]->get_string();
-
-	EuroScopePlugIn::CFlightPlan fp = CEXCDSBridge::GetInstance()->FlightPlanSelect(callsign.c_str());
-
-	// Is the flight plan valid?
-	if (!fp.IsValid()) {
-		return;
-	}
-
-	fp.AcceptHandoff();
-	}
-	catch (...) {
-		OutputDebugString("EXCDS Error: Accept handoff error");
-	}
-}
-
-void MessageHandler::RefuseCoordination(sio::event& e)
-{
-	try {
-	// Get aircraft data from EXCDS
-	std::string callsign = e.get_message()->get_map()["callsign"]->get_string();
-
-	EuroScopePlugIn::CFlightPlan fp = CEXCDSBridge::GetInstance()->FlightPlanSelect(callsign.c_str());
-
-	// Is the flight plan valid?
-	if (!fp.IsValid()) {
-		return;
-	}
-
-	fp.RefuseCoordination();
-	}
-	catch (...) {
-		OutputDebugString("EXCDS Error: Refuse coordination error");
-	}
-}
-
-void MessageHandler::AcceptCoordination(sio::event& e)
-{
-	try {
-	// Get aircraft data from EXCDS
-	std::string callsign = e.get_message()->get_map()["callsign"]->get_string();
-
-	EuroScopePlugIn::CFlightPlan fp = CEXCDSBridge::GetInstance()->FlightPlanSelect(callsign.c_str());
-
-	// Is the flight plan valid?
-	if (!fp.IsValid()) {
-		return;
-	}
-
-	fp.AcceptCoordination();
-	}
-	catch (...) {
-		OutputDebugString("EXCDS Error: Accept coordination error");
-	}
-}
-
-void MessageHandler::CorrelateTarget(sio::event& e)
-{
-	try {
-	// Get aircraft data from EXCDS
-	std::string callsign = e.get_message()->get_map()["callsign"]->get_string();
-	std::string id = e.get_message()->get_map()["id"]->get_string();
-
-	EuroScopePlugIn::CFlightPlan fp = CEXCDSBridge::GetInstance()->FlightPlanSelect(callsign.c_str());
-	EuroScopePlugIn::CRadarTarget rt = CEXCDSBridge::GetInstance()->RadarTargetSelect(id.c_str());
-
-	// Is the flight plan valid?
-	if (!fp.IsValid() || !rt.IsValid()) {
-		return;
-	}
-
-	fp.CorrelateWithRadarTarget(rt);
-	}
-	catch (...) {
-		OutputDebugString("EXCDS Error: Correlate target error");
-	}
-}
-
-void MessageHandler::DecorrelateTarget(sio::event& e)
-{
-	try {
-	// Get aircraft data from EXCDS
-	std::string callsign = e.get_message()->get_map()["callsign"]->get_string();
-
-	EuroScopePlugIn::CRadarTarget rt = CEXCDSBridge::GetInstance()->RadarTargetSelect(callsign.c_str());
-
-	// Is the flight plan valid?
-	if (!rt.IsValid()) {
-		return;
-	}
-
-	rt.Uncorrelate();
-	}
-	catch (...) {
-		OutputDebugString("EXCDS Error: Decorrelate target error");
-	}
-}
-
-void MessageHandler::UpdateScratchPad(sio::event& e)
-{
-	try {
-
-		// Get aircraft data from EXCDS
-		std::string callsign = e.get_message()->get_map()["callsign"]->get_string();
-		std::string value = e.get_message()->get_map()["value"]->get_string();
-
-		// Init Response
-		message::ptr response = object_message::create();
-		response->get_map()["callsign"] = string_message::create(callsign);
-
-		EuroScopePlugIn::CFlightPlan fp = CEXCDSBridge::GetInstance()->FlightPlanSelect(callsign.c_str());
-
-		// Is the flight plan valid?
-		if (!FlightPlanChecks(fp, response, e)) {
-			return;
-		}
-
-		bool isAssigned = false;
-
-		try {
-			isAssigned = fp.GetControllerAssignedData().SetScratchPadString(value.c_str());
-		}
-		catch (...) {
-			CEXCDSBridge::SendEuroscopeMessage(callsign.c_str(), "Cannot modify scrathpad.", "UNKNOWN");
-		}
-
-		if (!isAssigned) {
-			e.put_ack_message(NotModified(response, "Unknown reason."));
-
-			CEXCDSBridge::SendEuroscopeMessage(callsign.c_str(), "Cannot modify.", "UNKNOWN");
-			return;
-		}
-
-		// Tell EXCDS the change is done
-		response->get_map()["modified"] = bool_message::create(true);
-		e.put_ack_message(response);
-	}
-	catch (...) {
-		OutputDebugString("EXCDS Error: Update scratchpad error");
-	}
-}
-
-void MessageHandler::UpdateRoute(sio::event& e)
-{
-	try {
-	// Get aircraft data from EXCDS
-	std::string callsign = e.get_message()->get_map()["callsign"]->get_string();
-	std::string value = e.get_message()->get_map()["value"]->get_string();
-
-	// Init Response
-	message::ptr response = object_message::create();
-	response->get_map()["callsign"] = string_message::create(callsign);
-
-	EuroScopePlugIn::CFlightPlan fp = CEXCDSBridge::GetInstance()->FlightPlanSelect(callsign.c_str());
-
-	// Is the flight plan valid?
-	if (!FlightPlanChecks(fp, response, e)) {
-		return;
-	}
-
-	bool isAssigned = fp.GetFlightPlanData().SetRoute(value.c_str());
-
-	if (!isAssigned) {
-		e.put_ack_message(NotModified(response, "Unknown reason."));
-
-		CEXCDSBridge::SendEuroscopeMessage(callsign.c_str(), "Cannot modify.", "UNKNOWN");
-		return;
-	}
-
-	fp.GetFlightPlanData().AmendFlightPlan();
-
-	// Tell EXCDS the change is done
-	response->get_map()["modified"] = bool_message::create(true);
-	e.put_ack_message(response);
-	}
-	catch (...) {
-		OutputDebugString("EXCDS Error: Update route error");
-	}
-}
-
-void MessageHandler::UpdateDepartureTime(sio::event& e)
-{
-	try {
-	// Get aircraft data from EXCDS
-	std::string callsign = e.get_message()->get_map()["callsign"]->get_string();
-	std::string value = e.get_message()->get_map()["value"]->get_string();
-
-	// Init Response
-	message::ptr response = object_message::create();
-	response->get_map()["callsign"] = string_message::create(callsign);
-
-	EuroScopePlugIn::CFlightPlan fp = CEXCDSBridge::GetInstance()->FlightPlanSelect(callsign.c_str());
-
-	// Is the flight plan valid?
-	if (!FlightPlanChecks(fp, response, e)) {
-		return;
-	}
-
-	bool isAssigned = fp.GetFlightPlanData().SetEstimatedDepartureTime(value.c_str());
-
-	if (!isAssigned) {
-		e.put_ack_message(NotModified(response, "Unknown reason."));
-
-		CEXCDSBridge::SendEuroscopeMessage(callsign.c_str(), "Cannot modify.", "UNKNOWN");
-		return;
-	}
-
-	fp.GetFlightPlanData().AmendFlightPlan();
-
-	// Tell EXCDS the change is done
-	response->get_map()["modified"] = bool_message::create(true);
-	e.put_ack_message(response);
-	}
-	catch (...) {
-		OutputDebugString("EXCDS Error: Update departure time error");
-	}
-}
-
-void MessageHandler::UpdateAltitude(sio::event& e)
-{
-	try {
-		// Get aircraft data from EXCDS
-		std::string id = e.get_message()->get_map()["id"]->get_string();
-		std::string callsign = e.get_message()->get_map()["callsign"]->get_string();
-		int cleared = e.get_message()->get_map()["cleared"]->get_int();
-		int final = e.get_message()->get_map()["final"]->get_int();
-		int coordinated = e.get_message()->get_map()["coordinated"]->get_int();
-		// Reported altitude, goes to strip annotations for situ
-		std::string reported = e.get_message()->get_map()["reported"]->get_string();
-		int enterCoordinated = e.get_message()->get_map()["enter"]->get_int();
-		if (!enterCoordinated) enterCoordinated = -1;
-
-		// Init Response
-		message::ptr response = object_message::create();
-		response->get_map()["callsign"] = string_message::create(callsign);
-
-		EuroScopePlugIn::CFlightPlan fp = CEXCDSBridge::GetInstance()->FlightPlanSelect(callsign.c_str());
-
-		// Is the flight plan valid?
-		if (!FlightPlanChecks(fp, response, e)) {
-			return;
-		}
-		if (cleared != -1)
-			fp.GetControllerAssignedData().SetClearedAltitude(cleared);
-		
-		if (final != -1) {
-			fp.GetFlightPlanData().SetFinalAltitude(final);
-			fp.GetControllerAssignedData().SetFinalAltitude(final);
-		}
-		
-		if (coordinated > 0)
-			fp.InitiateCoordination(fp.GetCoordinatedNextController(), fp.GetNextCopxPointName(), coordinated);
-		if (reported != "")
-			fp.GetControllerAssignedData().SetFlightStripAnnotation(8, reported.c_str());
-		if (enterCoordinated != -1)
-			fp.InitiateCoordination(fp.GetTrackingControllerId(), fp.GetEntryCoordinationPointName(), enterCoordinated);
-
-		fp.GetFlightPlanData().AmendFlightPlan();
-
-		// Tell EXCDS the change is done
-		response->get_map()["modified"] = bool_message::create(true);
-		e.put_ack_message(response);
-	}
-	catch (...) {
-		CEXCDSBridge::SendEuroscopeMessage("ALT WARNING", "Cannot modify.", "UNKNOWN");
-		OutputDebugString("EXCDS Error: Update altitude error");
-	}
-}
-
-void MessageHandler::UpdateSpeed(sio::event& e)
-{
-	try {
-	// Get aircraft data from EXCDS
-	std::string id = e.get_message()->get_map()["id"]->get_string();
-	std::string callsign = e.get_message()->get_map()["callsign"]->get_string();
-	int assignedMach = e.get_message()->get_map()["assignedMach"]->get_int();
-	int assignedSpeed = e.get_message()->get_map()["assignedSpeed"]->get_int();
-	int filedSpeed = e.get_message()->get_map()["filedSpeed"]->get_int();
-
-	// Unused for now 
-	//std::string ifrString = e.get_message()->get_map()["ifrString"]->get_string();
-
-	// Init Response
-	message::ptr response = object_message::create();
-	response->get_map()["callsign"] = string_message::create(callsign);
-
-	EuroScopePlugIn::CFlightPlan fp = CEXCDSBridge::GetInstance()->FlightPlanSelect(callsign.c_str());
-
-	// Is the flight plan valid?
-	if (!FlightPlanChecks(fp, response, e)) {
-		return;
-	}
-
-	// Assign either a speed or mach, if provided
-	bool isAssigned = false;
-	if (assignedMach > 0) {
-		isAssigned = fp.GetControllerAssignedData().SetAssignedMach(assignedMach);
-	}
-	else if (assignedSpeed > 0) {
-		isAssigned = fp.GetControllerAssignedData().SetAssignedSpeed(assignedSpeed);
-	}
-
-	// Assign the filed speed, if provided
-	if (filedSpeed > 0) {
-		isAssigned = fp.GetFlightPlanData().SetTrueAirspeed(filedSpeed);
-	}
-
-	if (!isAssigned) {
-		e.put_ack_message(NotModified(response, "Unknown reason."));
-
-		CEXCDSBridge::SendEuroscopeMessage(callsign.c_str(), "Cannot modify.", "UNKNOWN");
-		return;
-	}
-
-	// Tell EXCDS the change is done
-	response->get_map()["modified"] = bool_message::create(true);
-	e.put_ack_message(response);
-	}
-	catch (...) {
-		OutputDebugString("EXCDS Error: Update speed error");
-	}
-}
-
-void MessageHandler::UpdateFlightPlan(sio::event& e)
+/*
+* Sends a private message by typing it into EuroScope, as there is no API for it.
+*/
+void MessageHandler::SendChatMessage(const std::string& callsign, const std::string& text)
 {
-	try {
-		// Get aircraft data from EXCDS
-		std::string callsign = e.get_message()->get_map()["callsign"]->get_string();
-		std::string flightRules = e.get_message()->get_map()["flight_rules"]->get_string();
-		std::string acType = e.get_message()->get_map()["aircraft_type"]->get_string();
-		std::string origin = e.get_message()->get_map()["origin"]->get_string();
-		std::string destination = e.get_message()->get_map()["destination"]->get_string();
-		int altitude = e.get_message()->get_map()["altitude"]->get_int();
-		int speed = e.get_message()->get_map()["speed"]->get_int();
-		std::string etehours = e.get_message()->get_map()["etehours"]->get_string();
-		std::string eteminutes = e.get_message()->get_map()["eteminutes"]->get_string();
-		std::string etd = e.get_message()->get_map()["etd"]->get_string();
-		std::string route = e.get_message()->get_map()["route"]->get_string();
-		std::string remarks = e.get_message()->get_map()["remarks"]->get_string();
-		std::string scratchpad = e.get_message()->get_map()["scratchpad"]->get_string();
-
-		// Init Response
-		message::ptr response = object_message::create();
-		response->get_map()["callsign"] = string_message::create(callsign);
-
-		EuroScopePlugIn::CFlightPlan fp = CEXCDSBridge::GetInstance()->FlightPlanSelect(callsign.c_str());
-
-		// Is the flight plan valid?
-		if (!FlightPlanChecks(fp, response, e)) {
-			return;
-		}
-
-		// Assign data
-		fp.GetFlightPlanData().SetAircraftInfo(acType.c_str());
-		fp.GetFlightPlanData().SetOrigin(origin.c_str());
-		fp.GetFlightPlanData().SetDestination(destination.c_str());
-		fp.GetFlightPlanData().SetFinalAltitude(altitude);
-		fp.GetControllerAssignedData().SetFinalAltitude(altitude);
-		fp.GetFlightPlanData().SetTrueAirspeed(speed);
-		fp.GetFlightPlanData().SetEnrouteHours(etehours.c_str());
-		fp.GetFlightPlanData().SetEnrouteMinutes(eteminutes.c_str());
-		fp.GetFlightPlanData().SetRoute(route.c_str());
-		fp.GetFlightPlanData().SetEstimatedDepartureTime(etd.c_str());
-		fp.GetFlightPlanData().SetRemarks(remarks.c_str());
-		fp.GetControllerAssignedData().SetScratchPadString(scratchpad.c_str());
-
-		if (strcmp(flightRules.c_str(), "I") == 0 || strcmp(flightRules.c_str(), "V") == 0)
-			fp.GetFlightPlanData().SetPlanType(flightRules.c_str());
+	// Get all windows with the specified title
+	HWND mainWindow = findMainWindow(GetCurrentProcessId());
 
+	// If the window isn't active, but is visible (not minimized)
+	// - Select the window
+	// - .chat
+	// - Select back
 
-		fp.GetFlightPlanData().AmendFlightPlan();
+	// If minimized:
+	// - Move it to a random x,y location (negative)
+	// - Open it
+	// - send the chat
+	// - minimize and put back where it was
 
-		response->get_map()["modified"] = bool_message::create(true);
-		e.put_ack_message(response);
-	}
-	catch (...) {
-		OutputDebugString("EXCDS Error: Update Flight Plan error");
-	}
+	SetForegroundWindow(mainWindow);
+	std::string chatTarget = ".chat " + callsign;
+	MessageHandler::SendKeyboardString(chatTarget);
+	MessageHandler::SendKeyboardPresses({ ENTER });
+	MessageHandler::SendKeyboardString(text);
+	MessageHandler::SendKeyboardPresses({ ENTER });
 }
 
 void MessageHandler::UpdateEstimate(sio::event& e)
@@ -607,99 +128,20 @@ void MessageHandler::UpdateEstimate(sio::event& e)
 	fp.GetControllerAssignedData().SetFlightStripAnnotation(6, vor.c_str());
 	fp.GetControllerAssignedData().SetFlightStripAnnotation(7, "");
 
-	fp.GetFlightPlanData().AmendFlightPlan();
+	AmendmentCoalescer::GetInstance()->Request(fp.GetCallsign());
 
 	//if (!isAssigned) {
 	//	e.put_ack_message(NotModified(response, "Unknown reason."));
 
 	//	CEXCDSBridge::SendEuroscopeMessage(callsign.c_str(), "Cannot modify.", "UNKNOWN");
-	//	return;
-	//}
-
-	response->get_map()["modified"] = bool_message::create(true);
-	e.put_ack_message(response);
-	}
-	catch (...) {
-		OutputDebugString("EXCDS Error: Update estimate error");
-	}
-}
-
-void MessageHandler::UpdateAircraftStatus(sio::event& e)
-{
-	try {
-		// Parse data from EXCDS
-		std::string callsign = e.get_message()->get_map()["callsign"]->get_string();
-		std::string status = e.get_message()->get_map()["status"]->get_string();
-		std::string departureTime = e.get_message()->get_map()["departure_time"]->get_string();
-
-		// Init Response
-		message::ptr response = object_message::create();
-		response->get_map()["callsign"] = string_message::create(callsign);
-
-		EuroScopePlugIn::CFlightPlan fp = CEXCDSBridge::GetInstance()->FlightPlanSelect(callsign.c_str());
-
-		// Is the flight plan valid?
-		if (!FlightPlanChecks(fp, response, e)) {
-			return;
-		}
-
-		bool success = MessageHandler::StatusAssign(status, fp, departureTime);
-
-		fp.GetFlightPlanData().AmendFlightPlan();
-
-		if (success) {
-			response->get_map()["modified"] = bool_message::create(true);
-			e.put_ack_message(response);
-		}
-		else {
-			e.put_ack_message(NotModified(response, "Unknown reason."));
-
-			CEXCDSBridge::SendEuroscopeMessage(callsign.c_str(), "Cannot modify.", "UNKNOWN");
-		}
-	}
-	catch (...) {
-		OutputDebugString("EXCDS Error: Update Aircraft Status error");
-	}
-}
-
-void MessageHandler::UpdateTrackingStatus(sio::event& e)
-{
-	try {
-		// Get aircraft data from EXCDS
-		std::string callsign = e.get_message()->get_map()["callsign"]->get_string();
-		bool assumed = e.get_message()->get_map()["assumed"]->get_bool();
-
-		// Init Response
-		message::ptr response = object_message::create();
-		response->get_map()["callsign"] = string_message::create(callsign);
-
-		EuroScopePlugIn::CFlightPlan fp = CEXCDSBridge::GetInstance()->FlightPlanSelect(callsign.c_str());
-
-		// Is the flight plan valid?
-		if (!FlightPlanChecks(fp, response, e)) {
-			return;
-		}
-
-		bool isAssigned;
-
-		if (assumed)
-			isAssigned = fp.StartTracking();
-		else
-			isAssigned = fp.EndTracking();
-
-		if (!isAssigned) {
-			e.put_ack_message(NotModified(response, "Unknown reason."));
-
-			CEXCDSBridge::SendEuroscopeMessage(callsign.c_str(), "Cannot modify.", "UNKNOWN");
-			return;
-		}
+	//	return;
+	//}
 
-		// Tell EXCDS the change is done
-		response->get_map()["modified"] = bool_message::create(true);
-		e.put_ack_message(response);
+	response->get_map()["modified"] = bool_message::create(true);
+	e.put_ack_message(response);
 	}
 	catch (...) {
-		OutputDebugString("EXCDS Error: Update tracking status error");
+		Metrics::CountException("UpdateEstimate", "EXCDS Error: Update estimate error");
 	}
 }
 
@@ -758,7 +200,7 @@ void MessageHandler::PointoutTarget(sio::event& e)
 	MessageHandler::SendKeyboardPresses({ ENTER });
 	}
 	catch (...) {
-		OutputDebugString("EXCDS Error: Failed to pointout target");
+		Metrics::CountException("PointoutTarget", "EXCDS Error: Failed to pointout target");
 	}
 }
 
@@ -788,292 +230,352 @@ void MessageHandler::UpdateAnnotation(sio::event& e)
 	e.put_ack_message(response);
 	}
 	catch (...) {
-		OutputDebugString("EXCDS Error: Update annotation error");
+		Metrics::CountException("UpdateAnnotation", "EXCDS Error: Update annotation error");
 	}
 }
 
-void MessageHandler::UpdateSquawk(sio::event& e)
-{
-	try {
-		// Get aircraft data from EXCDS
-		std::string callsign = e.get_message()->get_map()["callsign"]->get_string();
-		std::string prefix = e.get_message()->get_map()["prefix"]->get_string();
+#pragma endregion
 
-		// Init Response
-		message::ptr response = object_message::create();
-		response->get_map()["callsign"] = string_message::create(callsign);
+/**
+* ---------------------------
+* Requesting methods
+*
+* For EXCDS to ask for information.
+* ---------------------------
+*/
 
-		EuroScopePlugIn::CFlightPlan fp = CEXCDSBridge::GetInstance()->FlightPlanSelect(callsign.c_str());
+#pragma region Request_Methods
 
-		// Is the flight plan valid?
-		if (!FlightPlanChecks(fp, response, e)) {
-			return;
-		}
+void MessageHandler::RequestCommandLatency(sio::event& e)
+{
+	try {
+		e.put_ack_message(CommandTracer::GetInstance()->GetLatencySummary());
+	}
+	catch (...) {
+		Metrics::CountException("RequestCommandLatency", "EXCDS Error: Failed to get command latency");
+	}
+}
 
-		bool isAssigned;
+void MessageHandler::RequestMetrics(sio::event& e)
+{
+	try {
+		const std::map<std::string, message::ptr>& payload = e.get_message()->get_map();
+		auto format = payload.find("format");
 
-		std::string newCode = SquawkGenerator(prefix);
+		if (format != payload.end() && format->second && format->second->get_string() == "text")
+			e.put_ack_message(string_message::create(Metrics::GetInstance()->ToText()));
+		else
+			e.put_ack_message(Metrics::GetInstance()->Snapshot());
+	}
+	catch (...) {
+		Metrics::CountException("RequestMetrics", "EXCDS Error: Failed to get metrics");
+	}
+}
 
-		OutputDebugString(newCode.c_str());
+void MessageHandler::StartRecording(sio::event& e)
+{
+	message::ptr response = object_message::create();
 
-		isAssigned = fp.GetControllerAssignedData().SetSquawk(newCode.c_str());
+	try {
+		const std::map<std::string, message::ptr>& payload = e.get_message()->get_map();
+		auto file = payload.find("file");
 
-		if (!isAssigned) {
-			e.put_ack_message(NotModified(response, "Unknown reason."));
+		std::string path;
+		if (file != payload.end() && file->second && !file->second->get_string().empty())
+		{
+			path = ApiHelper::ResolvePluginPath(file->second->get_string());
+		}
+		else
+		{
+			char buf[32];
+			struct tm newTime;
+			time_t t = time(0);
 
-			CEXCDSBridge::SendEuroscopeMessage(callsign.c_str(), "Cannot modify.", "UNKNOWN");
-			return;
+			localtime_s(&newTime, &t);
+			std::strftime(buf, 32, "%Y%m%d-%H%M%S", &newTime);
+			path = ApiHelper::ResolvePluginPath("EXCDS-Bridge-session-" + std::string(buf) + ".excdsrec");
 		}
 
-		// Tell EXCDS the change is done
-		response->get_map()["modified"] = bool_message::create(true);
-		e.put_ack_message(response);
+		bool started = SessionRecorder::GetInstance()->Start(path);
+
+		response->get_map()["success"] = bool_message::create(started);
+		response->get_map()["path"] = string_message::create(path);
+		if (!started)
+			response->get_map()["reason"] = string_message::create("Could not open the recording file");
 	}
 	catch (...) {
-		OutputDebugString("EXCDS Error: Update squawk error");
+		Metrics::CountException("StartRecording", "EXCDS Error: Failed to start recording");
+		response->get_map()["success"] = bool_message::create(false);
 	}
+
+	e.put_ack_message(response);
 }
 
-void MessageHandler::UpdateDirectTo(sio::event& e)
+void MessageHandler::StopRecording(sio::event& e)
 {
-	try {
-	// Get aircraft data from EXCDS
-	std::string callsign = e.get_message()->get_map()["callsign"]->get_string();
-	int altitude = e.get_message()->get_map()["altitude"]->get_int();
-	std::string newDestination = e.get_message()->get_map()["new_destination"]->get_string();
-	std::string route = e.get_message()->get_map()["route"]->get_string();
+	SessionRecorder* recorder = SessionRecorder::GetInstance();
+	recorder->Stop();
 
-	// Init Response
 	message::ptr response = object_message::create();
-	response->get_map()["callsign"] = string_message::create(callsign);
+	response->get_map()["success"] = bool_message::create(true);
+	response->get_map()["records"] = int_message::create(recorder->GetRecordCount());
 
-	EuroScopePlugIn::CFlightPlan fp = CEXCDSBridge::GetInstance()->FlightPlanSelect(callsign.c_str());
+	e.put_ack_message(response);
+}
 
-	// Is the flight plan valid?
-	if (!FlightPlanChecks(fp, response, e)) {
-		return;
-	}
+void MessageHandler::StartReplay(sio::event& e)
+{
+	message::ptr response = object_message::create();
 
-	bool isAssigned = true;
+	try {
+		const std::map<std::string, message::ptr>& payload = e.get_message()->get_map();
+		auto file = payload.find("file");
+		auto speed = payload.find("speed");
 
-	if (strcmp(newDestination.c_str(), "") != 0)
-	{
-		fp.GetFlightPlanData().SetDestination(newDestination.c_str());
+		if (file == payload.end() || !file->second)
+		{
+			response->get_map()["success"] = bool_message::create(false);
+			response->get_map()["reason"] = string_message::create("No file given");
+		}
+		else if (CEXCDSBridge::IsLiveConnection())
+		{
+			response->get_map()["success"] = bool_message::create(false);
+			response->get_map()["reason"] = string_message::create("Replays are not allowed while connected to a shared session");
+		}
+		else
+		{
+			// 1 is real time, 0 is as fast as possible
+			double replaySpeed = speed != payload.end() && speed->second ? speed->second->get_double() : 1;
+			std::string path = ApiHelper::ResolvePluginPath(file->second->get_string());
 
-		MessageHandler::DirectTo(route, fp, true);
-	}
-	else if (route.substr(0, 3) == "DCT")
-	{
-		MessageHandler::DirectTo(route, fp, true);
+			bool started = SessionReplayer::GetInstance()->Start(path, replaySpeed);
+
+			response->get_map()["success"] = bool_message::create(started);
+			response->get_map()["path"] = string_message::create(path);
+			if (!started)
+				response->get_map()["reason"] = string_message::create("Could not open the session log, or a replay is already running");
+		}
 	}
-	else
-	{
-		fp.GetFlightPlanData().SetRoute(route.c_str());
+	catch (...) {
+		Metrics::CountException("StartReplay", "EXCDS Error: Failed to start replay");
+		response->get_map()["success"] = bool_message::create(false);
 	}
 
-	if (altitude > 0)
-		fp.GetControllerAssignedData().SetClearedAltitude(altitude);
-
-	fp.GetFlightPlanData().AmendFlightPlan();
+	e.put_ack_message(response);
+}
 
-	if (!isAssigned) {
-		e.put_ack_message(NotModified(response, "Unknown reason."));
+void MessageHandler::StopReplay(sio::event& e)
+{
+	SessionReplayer* replayer = SessionReplayer::GetInstance();
+	replayer->Stop();
 
-		CEXCDSBridge::SendEuroscopeMessage(callsign.c_str(), "Cannot modify.", "UNKNOWN");
-		return;
-	}
+	message::ptr response = object_message::create();
+	response->get_map()["success"] = bool_message::create(true);
+	response->get_map()["records"] = int_message::create(replayer->GetRecordCount());
 
-	// Tell EXCDS the change is done
-	response->get_map()["modified"] = bool_message::create(true);
 	e.put_ack_message(response);
-	}
-	catch (...) {
-		OutputDebugString("EXCDS Error: Update direct to error");
-	}
 }
 
-void MessageHandler::UpdateTime(sio::event& e)
+void MessageHandler::StartSyntheticTraffic(sio::event& e)
 {
-	try {
-	// Gate aircraft data from EXCDS
-	std::string callsign = e.get_message()->get_map()["callsign"]->get_string();
-	std::string time = e.get_message()->get_map()["time"]->get_string();
-
-	// Init Response
 	message::ptr response = object_message::create();
-	response->get_map()["callsign"] = string_message::create(callsign);
 
-	EuroScopePlugIn::CFlightPlan fp = CEXCDSBridge::GetInstance()->FlightPlanSelect(callsign.c_str());
+	try {
+		if (CEXCDSBridge::IsLiveConnection())
+		{
+			response->get_map()["success"] = bool_message::create(false);
+			response->get_map()["reason"] = string_message::create("Synthetic traffic is not allowed while connected to a shared session");
+		}
+		else
+		{
+			bool started = TrafficGenerator::GetInstance()->Start(TrafficProfile::FromMessage(e.get_message()));
 
-	// Is the flight plan valid?
-	if (!FlightPlanChecks(fp, response, e)) {
-		return;
+			response->get_map()["success"] = bool_message::create(started);
+			if (!started)
+				response->get_map()["reason"] = string_message::create("Synthetic traffic is already running");
+		}
 	}
-
-	fp.GetControllerAssignedData().SetScratchPadString("DEPA");
-	bool isAssigned = fp.GetFlightPlanData().SetActualDepartureTime(time.c_str());
-	fp.GetControllerAssignedData().SetScratchPadString("");
-
-	if (!isAssigned) {
-		e.put_ack_message(NotModified(response, "Unknown reason."));
-
-		CEXCDSBridge::SendEuroscopeMessage(callsign.c_str(), "Cannot modify.", "UNKNOWN");
-		return;
+	catch (...) {
+		Metrics::CountException("StartSyntheticTraffic", "EXCDS Error: Failed to start synthetic traffic");
+		response->get_map()["success"] = bool_message::create(false);
 	}
 
-	// Tell EXCDS the change is done
-	response->get_map()["modified"] = bool_message::create(true);
 	e.put_ack_message(response);
-	}
-	catch (...) {
-		OutputDebugString("EXCDS Error: Update time error");
-	}
 }
 
-void MessageHandler::HandleNewFlightPlan(sio::event& e)
+void MessageHandler::StopSyntheticTraffic(sio::event& e)
 {
-	try {
-		// Gate aircraft data from EXCDS
-		std::string callsign = e.get_message()->get_map()["callsign"]->get_string();
-		std::string type = e.get_message()->get_map()["type"]->get_string();
-		std::string origin = e.get_message()->get_map()["origin"]->get_string();
-		std::string dest = e.get_message()->get_map()["dest"]->get_string();
-		std::string route = e.get_message()->get_map()["route"]->get_string();
-		std::string fpType = e.get_message()->get_map()["fpType"]->get_string();
-		int alt = e.get_message()->get_map()["alt"]->get_int();
-
-		// Init Response
-		message::ptr response = object_message::create();
-		response->get_map()["callsign"] = string_message::create(callsign);
+	TrafficGenerator* generator = TrafficGenerator::GetInstance();
+	generator->Stop();
 
-		EuroScopePlugIn::CFlightPlan fp = CEXCDSBridge::GetInstance()->FlightPlanSelect(callsign.c_str());
+	e.put_ack_message(generator->GetSummary());
+}
 
-		// Is the flight plan valid?
-		if (!FlightPlanChecks(fp, response, e)) {
-			return;
-		}
+void MessageHandler::StartLoopbackStorm(sio::event& e)
+{
+	message::ptr response = object_message::create();
 
-			fp.GetFlightPlanData().SetAircraftInfo(type.c_str());
-			fp.GetFlightPlanData().SetOrigin(origin.c_str());
-			fp.GetFlightPlanData().SetDestination(dest.c_str());
-			fp.GetFlightPlanData().SetRoute(route.c_str());
-			fp.GetFlightPlanData().SetPlanType(fpType.c_str());
-			fp.GetControllerAssignedData().SetClearedAltitude(0);
-			fp.GetFlightPlanData().SetFinalAltitude(alt);
-			fp.GetControllerAssignedData().SetFinalAltitude(alt);
+	try {
+		StormScript script = StormScript::FromMessage(e.get_message());
 
-			fp.GetFlightPlanData().AmendFlightPlan();
+		if (CEXCDSBridge::IsLiveConnection())
+		{
+			response->get_map()["success"] = bool_message::create(false);
+			response->get_map()["reason"] = string_message::create("Command storms are not allowed while connected to a shared session");
+		}
+		else if (!script.IsReadOnly() && script.callsigns.empty())
+		{
+			response->get_map()["success"] = bool_message::create(false);
+			response->get_map()["reason"] = string_message::create("Commands that change state need an explicit list of callsigns");
+		}
+		else
+		{
+			// Without a list, the read only requests run against the flight plans EuroScope has
+			if (script.callsigns.empty())
+			{
+				CEXCDSBridge* bridgeInstance = CEXCDSBridge::GetInstance();
 
-		//if (!isAssigned) {
-		//	e.put_ack_message(NotModified(response, "Unknown reason."));
+				for (EuroScopePlugIn::CFlightPlan fp = bridgeInstance->FlightPlanSelectFirst(); fp.IsValid(); fp = bridgeInstance->FlightPlanSelectNext(fp))
+					script.callsigns.push_back(fp.GetCallsign());
+			}
 
-		//	CEXCDSBridge::SendEuroscopeMessage(callsign.c_str(), "Cannot modify.", "UNKNOWN");
-		//	return;
-		//}
+			LoopbackSocket* loopback = LoopbackSocket::GetInstance();
+			loopback->StartCapture();
 
-		// Tell EXCDS the change is done
-		response->get_map()["modified"] = bool_message::create(true);
-		e.put_ack_message(response);
+			bool started = loopback->StartStorm(script);
+
+			response->get_map()["success"] = bool_message::create(started);
+			response->get_map()["callsigns"] = int_message::create(script.callsigns.size());
+			if (!started)
+				response->get_map()["reason"] = string_message::create("No commands or callsigns, or a storm is already running");
+		}
 	}
 	catch (...) {
-		OutputDebugString("EXCDS Error: Failed to create NEW FLIGHT PLAN");
+		Metrics::CountException("StartLoopbackStorm", "EXCDS Error: Failed to start command storm");
+		response->get_map()["success"] = bool_message::create(false);
 	}
-}
-
-#pragma endregion
-
-/**
-* ---------------------------
-* Requesting methods
-*
-* For EXCDS to ask for information.
-* ---------------------------
-*/
 
-#pragma region Request_Methods
+	e.put_ack_message(response);
+}
 
-void MessageHandler::RequestAirports(message::ptr response)
+void MessageHandler::StopLoopbackStorm(sio::event& e)
 {
-	CEXCDSBridge* bridgeInstance = CEXCDSBridge::GetInstance();
+	LoopbackSocket* loopback = LoopbackSocket::GetInstance();
+	loopback->StopStorm();
+	loopback->StopCapture();
 
-	// Get a list of controllers
-	EuroScopePlugIn::CController controller = bridgeInstance->ControllerSelectFirst();
-	sio::message::ptr controllers = sio::array_message::create();
+	e.put_ack_message(loopback->GetReport());
+}
 
-	while (controller.IsValid())
-	{
-		controllers->get_vector().push_back(string_message::create(controller.GetCallsign()));
+void MessageHandler::RequestLoopbackReport(sio::event& e)
+{
+	e.put_ack_message(LoopbackSocket::GetInstance()->GetReport());
+}
 
-		controller = bridgeInstance->ControllerSelectNext(controller);
-	}
+void MessageHandler::RunLoadTest(sio::event& e)
+{
+	message::ptr response = object_message::create();
 
-	// Get which airports are active
-	EuroScopePlugIn::CSectorElement airport = bridgeInstance->SectorFileElementSelectFirst(EuroScopePlugIn::SECTOR_ELEMENT_AIRPORT);
-	sio::message::ptr airports = sio::array_message::create();
+	try {
+		LoadTestConfig config = LoadTestConfig::FromMessage(e.get_message());
 
-	while (airport.IsValid())
-	{
-		// Check if the element is used as a departure (true) or arrival (false)
-		if (airport.IsElementActive(true) || airport.IsElementActive(false))
+		if (CEXCDSBridge::IsLiveConnection())
 		{
-			airports->get_vector().push_back(string_message::create(airport.GetAirportName()));
+			response->get_map()["success"] = bool_message::create(false);
+			response->get_map()["reason"] = string_message::create("Load tests are not allowed while connected to a shared session");
 		}
+		else if (config.includeStateChanging && config.callsigns.empty())
+		{
+			response->get_map()["success"] = bool_message::create(false);
+			response->get_map()["reason"] = string_message::create("Commands that change state need an explicit list of callsigns");
+		}
+		else
+		{
+			// Without a list, the read only requests run against the flight plans EuroScope has
+			if (config.callsigns.empty())
+			{
+				CEXCDSBridge* bridgeInstance = CEXCDSBridge::GetInstance();
 
-		airport = bridgeInstance->SectorFileElementSelectNext(airport, EuroScopePlugIn::SECTOR_ELEMENT_AIRPORT);
-	}
-}
-
-void MessageHandler::RequestAllAircraft(sio::event& e)
-{
-	try {
-		CEXCDSBridge* bridgeInstance = CEXCDSBridge::GetInstance();
-		EuroScopePlugIn::CFlightPlan flightPlan = bridgeInstance->FlightPlanSelectFirst();
+				for (EuroScopePlugIn::CFlightPlan fp = bridgeInstance->FlightPlanSelectFirst(); fp.IsValid(); fp = bridgeInstance->FlightPlanSelectNext(fp))
+					config.callsigns.push_back(fp.GetCallsign());
+			}
 
-		while (flightPlan.IsValid()) {
-			sio::message::ptr response = sio::object_message::create();
-			MessageHandler::PrepareFlightPlanDataResponse(flightPlan, response);
+			LoopbackSocket::GetInstance()->StartCapture();
 
-			bridgeInstance->GetSocket()->emit("SEND_ALL_FP_DATA", response);
+			bool started = LoadTest::GetInstance()->Start(config);
 
-			flightPlan = bridgeInstance->FlightPlanSelectNext(flightPlan);
+			response->get_map()["success"] = bool_message::create(started);
+			response->get_map()["callsigns"] = int_message::create(config.callsigns.size());
+			if (!started)
+				response->get_map()["reason"] = string_message::create("No callsigns, or a load test or storm is already running");
 		}
-
-		e.put_ack_message(bool_message::create(true));
 	}
 	catch (...) {
-		OutputDebugString("EXCDS Error: Failed to request all aircraft");
+		Metrics::CountException("RunLoadTest", "EXCDS Error: Failed to start load test");
+		response->get_map()["success"] = bool_message::create(false);
 	}
+
+	e.put_ack_message(response);
 }
 
-void MessageHandler::RequestAircraftByCallsign(sio::event& e)
+void MessageHandler::StopLoadTest(sio::event& e)
 {
-	try{
-	// Parse data from EXCDS
-	std::string callsign = e.get_message()->get_map()["callsign"]->get_string();
-	EuroScopePlugIn::CFlightPlan fp = CEXCDSBridge::GetInstance()->FlightPlanSelect(callsign.c_str());
+	LoadTest* loadTest = LoadTest::GetInstance();
+	loadTest->Stop();
+	LoopbackSocket::GetInstance()->StopCapture();
 
-	// Init Response
-	message::ptr response = object_message::create();
-	response->get_map()["callsign"] = string_message::create(callsign);
+	e.put_ack_message(loadTest->GetResults());
+}
 
-#if _DEBUG
-	CEXCDSBridge::GetInstance()->DisplayUserMessage("EXCDS Bridge [DEBUG]", "Data sent", std::string(std::string(fp.GetCallsign()) + " was sent.").c_str(), true, true, true, true, true);
-#endif
+void MessageHandler::RequestLoadTestResults(sio::event& e)
+{
+	e.put_ack_message(LoadTest::GetInstance()->GetResults());
+}
 
-	if (!fp.IsValid())
-	{
-		e.put_ack_message(NotModified(response, "Aircraft not found."));
+#ifndef EXCDS_LEAN
+void MessageHandler::RequestProfileTrace(sio::event& e)
+{
+	try {
+		size_t events = 0;
+		std::string path = Profiler::GetInstance()->DumpToFile(&events);
 
-		CEXCDSBridge::SendEuroscopeMessage(callsign.c_str(), "Cannot find aircraft.", "AC_NT_FND");
-		return;
-	}
+		message::ptr response = object_message::create();
+		response->get_map()["written"] = bool_message::create(!path.empty());
+		response->get_map()["path"] = string_message::create(path);
+		response->get_map()["events"] = int_message::create(events);
 
-	MessageHandler::PrepareFlightPlanDataResponse(fp, response);
-	CEXCDSBridge::GetSocket()->emit("SEND_FP_DATA", response);
-}
-catch (...) {
-	OutputDebugString("EXCDS Error: Failed to request a/c by callsign");
+		e.put_ack_message(response);
+	}
+	catch (...) {
+		Metrics::CountException("RequestProfileTrace", "EXCDS Error: Failed to write profile trace");
+	}
 }
+#endif
+
+/**
+* A controller by position ID or callsign, from the roster where it can. EuroScope's controller list is only searched
+* for a controller the roster has not seen yet.
+*/
+static bool FindController(const std::string& positionId, const std::string& callsign, RosterEntry& entry)
+{
+	ControllerRoster* roster = ControllerRoster::GetInstance();
+	if (!positionId.empty() && roster->FindByPositionId(positionId, entry)) return true;
+	if (!callsign.empty() && roster->Find(callsign, entry)) return true;
+
+	CEXCDSBridge* bridgeInstance = CEXCDSBridge::GetInstance();
+	EuroScopePlugIn::CController controller;
+	if (!positionId.empty())
+		controller = bridgeInstance->ControllerSelectByPositionId(positionId.c_str());
+	else if (!callsign.empty())
+		controller = bridgeInstance->ControllerSelect(callsign.c_str());
+
+	if (!controller.IsValid()) return false;
+
+	entry.callsign = controller.GetCallsign();
+	entry.cjs = controller.GetPositionId();
+	entry.frequency = controller.GetPrimaryFrequency();
+	entry.facility = controller.GetFacility();
+	return true;
 }
 
 void MessageHandler::PrepareFPTrackResponse(EuroScopePlugIn::CFlightPlan fp, message::ptr response)
@@ -1096,6 +598,10 @@ void MessageHandler::PrepareFPTrackResponse(EuroScopePlugIn::CFlightPlan fp, mes
 
 void MessageHandler::PrepareRadarTargetResponse(EuroScopePlugIn::CRadarTarget rt, message::ptr response)
 {
+	PROFILE_ZONE("PrepareRadarTargetResponse");
+	static MetricHistogram& serializeTime = Metrics::GetInstance()->Histogram("serialize.rt_data_us");
+	MetricTimer timer(serializeTime);
+
 #if _DEBUG
 	char buf[100];
 	struct tm newTime;
@@ -1214,6 +720,7 @@ void MessageHandler::PrepareRadarTargetResponse(EuroScopePlugIn::CRadarTarget rt
 		std::string reportedAltitude = "";
 		std::string clearedAltitude = "";
 		bool altitudeError = false;
+		int levelOff = -1;
 		int finalAltitude = 0;
 		std::string hocjs = "";
 		std::string assignedSpeed = "";
@@ -1263,19 +770,19 @@ void MessageHandler::PrepareRadarTargetResponse(EuroScopePlugIn::CRadarTarget rt
 		{
 			EuroScopePlugIn::CFlightPlan fp = rt.GetCorrelatedFlightPlan();
 			std::string remarks = fp.GetFlightPlanData().GetRemarks();
-			CEXCDSBridge* bridgeInstance = CEXCDSBridge::GetInstance();
 
 			ram = fp.GetRAMFlag();
 
 			cjs = fp.GetTrackingControllerId();
 
-			EuroScopePlugIn::CController trackingController = bridgeInstance->ControllerSelectByPositionId(fp.GetTrackingControllerId());
-			frequency = trackingController.GetPrimaryFrequency();
+			RosterEntry trackingController;
+			if (FindController(cjs, "", trackingController))
+				frequency = trackingController.frequency;
 
-			EuroScopePlugIn::CController nextController = bridgeInstance->ControllerSelect(fp.GetCoordinatedNextController());
-			if (nextController.IsValid())
+			RosterEntry nextController;
+			if (FindController("", fp.GetCoordinatedNextController(), nextController))
 			{
-				nextCjs = nextController.GetPositionId();
+				nextCjs = nextController.cjs;
 			}
 
 			if (fp.GetSectorExitMinutes() < 3 && fp.GetState() == EuroScopePlugIn::FLIGHT_PLAN_STATE_ASSUMED)
@@ -1323,14 +830,9 @@ void MessageHandler::PrepareRadarTargetResponse(EuroScopePlugIn::CRadarTarget rt
 
 			int alt = modec * 100;
 
-			if (alt > tempAlt + 200 || alt < tempAlt - 200) {
-				if (rt.GetVerticalSpeed() < 200 && rt.GetVerticalSpeed() > -200)
-					altitudeError = true;
-				if (alt < tempAlt - 200 && rt.GetVerticalSpeed() < -200)
-					altitudeError = true;
-				if (alt > tempAlt + 200 && rt.GetVerticalSpeed() > 200)
-					altitudeError = true;
-			}
+			// PublishRadarTarget sets level_off and clears the error while the filter sees the target on its way
+			if (alt > tempAlt + 200 || alt < tempAlt - 200)
+				altitudeError = true;
 			else
 				reachedAltitude = true;
 
@@ -1470,6 +972,7 @@ void MessageHandler::PrepareRadarTargetResponse(EuroScopePlugIn::CRadarTarget rt
 		response->get_map()["mods"]->get_map()["rnav"] = bool_message::create(RNAV);
 		response->get_map()["mods"]->get_map()["text"] = string_message::create(commType);
 		response->get_map()["mods"]->get_map()["reached_altitude"] = bool_message::create(reachedAltitude);
+		response->get_map()["mods"]->get_map()["level_off"] = int_message::create(levelOff);
 		response->get_map()["mods"]->get_map()["blink"] = bool_message::create(hoBlink);
 		response->get_map()["mods"]->get_map()["vfr"] = bool_message::create(isVfr);
 		response->get_map()["mods"]->get_map()["ident"] = bool_message::create(ident);
@@ -1510,76 +1013,7 @@ void MessageHandler::PrepareRadarTargetResponse(EuroScopePlugIn::CRadarTarget rt
 		response->get_map()["id"] = string_message::create(rt.GetSystemID());
 	}
 	catch (...) {
-		OutputDebugString("EXCDS Error: Failed radar target update");
-	}
-}
-
-void MessageHandler::PrepareRouteDataResponse(sio::event& e)
-{
-	try {
-		// Gate data from EXCDS
-		std::string callsign = e.get_message()->get_map()["callsign"]->get_string();
-
-		// Init Response
-		message::ptr response = object_message::create();
-		response->get_map()["callsign"] = string_message::create(callsign);
-
-		CEXCDSBridge* bridgeInstance = CEXCDSBridge::GetInstance();
-
-		EuroScopePlugIn::CFlightPlan fp = bridgeInstance->FlightPlanSelect(callsign.c_str());
-
-		// Is the flight plan valid?
-		if (!fp.IsValid()) {
-			return;
-		}
-
-		sio::message::ptr arrayMessage = sio::array_message::create();
-
-		int directTo = fp.GetExtractedRoute().GetPointsAssignedIndex();
-		int closestTo = fp.GetExtractedRoute().GetPointsCalculatedIndex();
-		int highest = 0;
-		if (directTo > closestTo)
-			highest = directTo;
-		else
-			highest = closestTo;
-
-		for (int i = highest; i < fp.GetExtractedRoute().GetPointsNumber(); i++) {
-			double lat = fp.GetExtractedRoute().GetPointPosition(i).m_Latitude;
-			double lon = fp.GetExtractedRoute().GetPointPosition(i).m_Longitude;
-
-			sio::message::ptr msg = sio::object_message::create();
-			msg->get_map()["point"] = string_message::create(fp.GetExtractedRoute().GetPointName(i));
-			msg->get_map()["lat"] = double_message::create(lat);
-			msg->get_map()["long"] = double_message::create(lon);
-
-			arrayMessage->get_vector().push_back(msg);
-
-			if (fp.GetExtractedRoute().GetPointDistanceInMinutes(i) > fp.GetSectorExitMinutes())
-				break;
-		}
-
-		double lat = 0;
-		double lon = 0;
-
-		if (fp.GetCorrelatedRadarTarget().IsValid())
-		{
-			lat = fp.GetCorrelatedRadarTarget().GetPosition().GetPosition().m_Latitude;
-			lon = fp.GetCorrelatedRadarTarget().GetPosition().GetPosition().m_Longitude;
-		}
-		else if (fp.GetFPTrackPosition().IsValid())
-		{
-			lat = fp.GetFPTrackPosition().GetPosition().m_Latitude;
-			lon = fp.GetFPTrackPosition().GetPosition().m_Longitude;
-		}
-
-		response->get_map()["lat"] = double_message::create(lat);
-		response->get_map()["long"] = double_message::create(lon);
-
-		response->get_map()["route"] = arrayMessage;
-		bridgeInstance->GetSocket()->emit("ROUTE_DATA", response);
-	}
-	catch (...) {
-		OutputDebugString("EXCDS Error: cannot get route data");
+		Metrics::CountException("PrepareRadarTargetResponse", "EXCDS Error: Failed radar target update");
 	}
 }
 
@@ -1602,6 +1036,10 @@ void MessageHandler::PrepareCDMResponse(EuroScopePlugIn::CFlightPlan fp, message
 
 void MessageHandler::PrepareFlightPlanDataResponse(EuroScopePlugIn::CFlightPlan fp, message::ptr response)
 {
+	PROFILE_ZONE("PrepareFlightPlanDataResponse");
+	static MetricHistogram& serializeTime = Metrics::GetInstance()->Histogram("serialize.fp_data_us");
+	MetricTimer timer(serializeTime);
+
 	if (!fp.IsValid()) {
 		CEXCDSBridge::SendEuroscopeMessage(fp.GetCallsign(), "Error: Flight plan not valid", "FP INVALID");
 		return;
@@ -1826,21 +1264,21 @@ void MessageHandler::PrepareFlightPlanDataResponse(EuroScopePlugIn::CFlightPlan
 		response->get_map()["controllerData"]->get_map()["controller_tracking_state"] = int_message::create(fpstate);
 
 		try {
-			CEXCDSBridge* bridgeInstance = CEXCDSBridge::GetInstance();
-			EuroScopePlugIn::CController trackingController = bridgeInstance->ControllerSelectByPositionId(fp.GetTrackingControllerId());
+			RosterEntry trackingController;
+			bool tracked = FindController(fp.GetTrackingControllerId(), "", trackingController);
 
-			EuroScopePlugIn::CController nextController = bridgeInstance->ControllerSelect(fp.GetCoordinatedNextController());
+			RosterEntry nextController;
 			std::string nextCtrlr = "";
-			if (nextController.IsValid()) nextCtrlr = nextController.GetPositionId();
+			if (FindController("", fp.GetCoordinatedNextController(), nextController)) nextCtrlr = nextController.cjs;
 			double frequency = 199.998;
-			if (trackingController.IsValid())
-				frequency = trackingController.GetPrimaryFrequency();
+			if (tracked)
+				frequency = trackingController.frequency;
 			response->get_map()["controllerData"]->get_map()["next_controller"] = string_message::create(nextCtrlr);
 			response->get_map()["controllerData"]->get_map()["freq"] = double_message::create(frequency);
-			response->get_map()["controllerData"]->get_map()["tracking_controller"] = string_message::create(trackingController.GetPositionId());
+			response->get_map()["controllerData"]->get_map()["tracking_controller"] = string_message::create(trackingController.cjs);
 		}
 		catch (...) {
-			OutputDebugString("EXCDS error getting controller data");
+			Metrics::CountException("PrepareFlightPlanDataResponse.Controllers", "EXCDS error getting controller data");
 		}
 
 		// Flight Plan Data
@@ -1972,6 +1410,8 @@ void MessageHandler::PrepareFlightPlanDataResponse(EuroScopePlugIn::CFlightPlan
 			response->get_map()["estimates"]->get_map()["arrival_fix"] = string_message::create(arrivalEstimateName);
 
 			if (strcmp(fp.GetFlightPlanData().GetPlanType(), "I") == 0) {
+				PROFILE_ZONE("Estimates");
+
 				response->get_map()["estimates"]->get_map()["enroute"] = object_message::create();
 				int closestBayDistance = 1000;
 				//int closestBayTime = 500;
@@ -2058,7 +1498,7 @@ void MessageHandler::PrepareFlightPlanDataResponse(EuroScopePlugIn::CFlightPlan
 	}
 	catch (...) {
 		CEXCDSBridge::SendEuroscopeMessage(fp.GetCallsign(), "Error: Flight plan not valid", "FP INVALID");
-		OutputDebugString("EXCDS Error: Problem with fp data aqcuisition");
+		Metrics::CountException("PrepareFlightPlanDataResponse", "EXCDS Error: Problem with fp data aqcuisition");
 	}
 }
 
@@ -2072,29 +1512,6 @@ void MessageHandler::PrepareFlightPlanDataResponse(EuroScopePlugIn::CFlightPlan
 * ---------------------------
 */
 
-void MessageHandler::RequestDirectTo(sio::event& e)
-{
-	// Parse data from EXCDS
-	std::string callsign = e.get_message()->get_map()["callsign"]->get_string();
-	EuroScopePlugIn::CFlightPlan fp = CEXCDSBridge::GetInstance()->FlightPlanSelect(callsign.c_str());
-
-	// Init Response
-	message::ptr response = object_message::create();
-	response->get_map()["callsign"] = string_message::create(callsign);
-
-#if _DEBUG
-	CEXCDSBridge::GetInstance()->DisplayUserMessage("EXCDS Bridge [DEBUG]", "Data sent", std::string(std::string(fp.GetCallsign()) + " was sent.").c_str(), true, true, true, true, true);
-#endif
-
-	if (!fp.IsValid())
-	{
-		e.put_ack_message(NotModified(response, "Aircraft not found."));
-
-		CEXCDSBridge::SendEuroscopeMessage(callsign.c_str(), "Cannot find aircraft.", "AC_NT_FND");
-		return;
-	}
-}
-
 /*
 * This is used to check if a callsign has a flight plan to modify, and we (the controller) are able to modify it.
 * Returns true if the flight plan is valid.
@@ -2123,6 +1540,8 @@ bool MessageHandler::FlightPlanChecks(EuroScopePlugIn::CFlightPlan fp, message::
 		return false;
 	}
 
+	CommandTracer::Mark(TRACE_DISPATCHED);
+
 	return true;
 }
 
@@ -2144,6 +1563,8 @@ message::ptr MessageHandler::NotModified(message::ptr response, std::string reas
 */
 std::string MessageHandler::AddRunwayToRoute(std::string runway, EuroScopePlugIn::CFlightPlan fp, bool departure)
 {
+	PROFILE_ZONE("AddRunwayToRoute");
+
 	std::string route = fp.GetFlightPlanData().GetRoute();
 #if _DEBUG
 	CEXCDSBridge::GetInstance()->DisplayUserMessage("EXCDS Bridge [DEBUG]", std::string("ROUTE (" + std::string(fp.GetCallsign()) + ")").c_str(), route.c_str(), true, true, true, true, true);
@@ -2276,7 +1697,7 @@ void MessageHandler::DirectTo(std::string waypoint, EuroScopePlugIn::CFlightPlan
 			std::string newRouteString = presentPosition + waypoint.substr(4);
 			fp.GetFlightPlanData().SetRoute(newRouteString.c_str());
 		}
-		fp.GetFlightPlanData().AmendFlightPlan();
+		AmendmentCoalescer::GetInstance()->Request(fp.GetCallsign());
 	}
 }
 
@@ -2399,6 +1820,8 @@ void MessageHandler::MissedApproach(EuroScopePlugIn::CFlightPlan fp)
 
 std::string MessageHandler::SquawkGenerator(std::string squawkPrefix)
 {
+	PROFILE_ZONE("SquawkGenerator");
+
 	std::string transponder;
 
 	for (int i = 1; i <= 77; i++)
@@ -2407,7 +1830,12 @@ std::string MessageHandler::SquawkGenerator(std::string squawkPrefix)
 		squawkSuffix.insert(squawkSuffix.begin(), 2 - squawkSuffix.length(), '0'); // Add a leading 0 if it's 1 digit
 		transponder = squawkPrefix + squawkSuffix;
 
-		bool valid = true;
+		// Neither assigned to nor sent by any aircraft
+		if (SquawkIndex::GetInstance()->IsInUse(transponder)) continue;
+
+		// The index only knows the flight plans EuroScope has told it about, so the code is checked against all of
+		// them before it is handed out. Any that has it is indexed, and the next code is tried.
+		bool assigned = false;
 		for (
 			EuroScopePlugIn::CFlightPlan fp = CEXCDSBridge::GetInstance()->FlightPlanSelectFirst();
 			fp.IsValid();
@@ -2415,12 +1843,13 @@ std::string MessageHandler::SquawkGenerator(std::string squawkPrefix)
 			) {
 
 			if (strcmp(fp.GetControllerAssignedData().GetSquawk(), transponder.c_str()) == 0) {
-				valid = false;
+				SquawkIndex::GetInstance()->UpdateAssigned(fp.GetCallsign(), transponder);
+				assigned = true;
 				break;
 			}
 		}
 
-		if (valid) {
+		if (!assigned) {
 			return transponder;
 		}
 	}
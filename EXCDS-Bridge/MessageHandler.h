@@ -1,53 +1,54 @@
 #pragma once
+#include <tuple>
 #include "EuroScopePlugIn.h"
 
+typedef std::tuple < std::string, EuroScopePlugIn::CPosition> EstimatePosn;
+
+/**
+* Commands from EXCDS are events under Events/. What is left here are the bridge's own diagnostics events, and the
+* helpers the events share.
+*/
 class MessageHandler
 {
 public:
-	void UpdateAltitude(sio::event&);
-	void UpdatePositions(sio::event& e);
-	void SendKeyboardPresses(std::vector<WORD> message);
-	void SendKeyboardString(const std::string str);
-	void SendPDC(sio::event& e);
-	void HandoffTarget(sio::event& e);
-	void RefuseHandoff(sio::event& e);
-	void AcceptHandoff(sio::event& e);
-	void RefuseCoordination(sio::event& e);
-	void AcceptCoordination(sio::event& e);
-	void CorrelateTarget(sio::event& e);
-	void DecorrelateTarget(sio::event& e);
-	void UpdateScratchPad(sio::event&);
-	void UpdateRoute(sio::event& e);
-	void UpdateDepartureTime(sio::event& e);
-	void UpdateSpeed(sio::event&);
-	void UpdateFlightPlan(sio::event&);
-	void UpdateAircraftStatus(sio::event&);
-	void UpdateTrackingStatus(sio::event&);
+	static void SendKeyboardPresses(std::vector<WORD> message);
+	static void SendKeyboardString(const std::string str);
+	static void SendChatMessage(const std::string& callsign, const std::string& text);
 	void PointoutTarget(sio::event& e);
 	void UpdateAnnotation(sio::event& e);
-	void UpdateSquawk(sio::event& e);
 	void UpdateEstimate(sio::event&);
-	void UpdateDirectTo(sio::event&);
-	void UpdateTime(sio::event& e);
-	void HandleNewFlightPlan(sio::event& e);
 
-	static void RequestAirports(sio::message::ptr response);
-	void RequestAllAircraft(sio::event&);
-	void RequestAircraftByCallsign(sio::event&);
+	static void SetEstimatePositions(const std::vector<EstimatePosn>& positions);
+	static std::string SquawkGenerator(std::string);
+	static void DirectTo(std::string waypoint, EuroScopePlugIn::CFlightPlan fp, bool newRoute);
+	static bool StatusAssign(std::string status, EuroScopePlugIn::CFlightPlan fp, std::string departureTime);
+
+	void RequestCommandLatency(sio::event&);
+	void RequestMetrics(sio::event&);
+	void StartRecording(sio::event&);
+	void StopRecording(sio::event&);
+	void StartReplay(sio::event&);
+	void StopReplay(sio::event&);
+	void StartSyntheticTraffic(sio::event&);
+	void StopSyntheticTraffic(sio::event&);
+	void StartLoopbackStorm(sio::event&);
+	void StopLoopbackStorm(sio::event&);
+	void RequestLoopbackReport(sio::event&);
+	void RunLoadTest(sio::event&);
+	void StopLoadTest(sio::event&);
+	void RequestLoadTestResults(sio::event&);
+#ifndef EXCDS_LEAN
+	void RequestProfileTrace(sio::event&);
+#endif
 	void PrepareFPTrackResponse(EuroScopePlugIn::CFlightPlan fp, sio::message::ptr response);
 	static void PrepareFlightPlanDataResponse(EuroScopePlugIn::CFlightPlan fp, sio::message::ptr response);
 	static void PrepareRadarTargetResponse(EuroScopePlugIn::CRadarTarget rt, sio::message::ptr response);
-	void PrepareRouteDataResponse(sio::event& e);
 	void PrepareCDMResponse(EuroScopePlugIn::CFlightPlan fp, sio::message::ptr response);
-	void RequestDirectTo(sio::event&);
 
 private:
 	bool MessageHandler::FlightPlanChecks(EuroScopePlugIn::CFlightPlan fp, sio::message::ptr response, sio::event& e);
 	sio::message::ptr NotModified(sio::message::ptr response, std::string reason);
-	std::string AddRunwayToRoute(std::string runway, EuroScopePlugIn::CFlightPlan fp, bool departure = true);
-	static std::string SquawkGenerator(std::string);
-	void ForceFlightPlanRefresh(EuroScopePlugIn::CFlightPlan fp);
-	void DirectTo(std::string waypoint, EuroScopePlugIn::CFlightPlan fp, bool newRoute);
-	bool StatusAssign(std::string status, EuroScopePlugIn::CFlightPlan fp, std::string departureTime);
-	void MissedApproach(EuroScopePlugIn::CFlightPlan fp);
-};
\ No newline at end of file
+	static std::string AddRunwayToRoute(std::string runway, EuroScopePlugIn::CFlightPlan fp, bool departure = true);
+	static void ForceFlightPlanRefresh(EuroScopePlugIn::CFlightPlan fp);
+	static void MissedApproach(EuroScopePlugIn::CFlightPlan fp);
+};
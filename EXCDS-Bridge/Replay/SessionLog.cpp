@@ -0,0 +1,367 @@
+#include <cstring>
+
+#include "SessionLog.h"
+
+static const char SESSION_LOG_MAGIC[8] = { 'E', 'X', 'C', 'D', 'S', 'R', 'E', 'C' };
+static const uint8_t SESSION_LOG_VERSION = 2;
+
+// Version 1 logs have no target altitude in their radar samples
+static const uint8_t SESSION_LOG_TARGET_ALTITUDE_VERSION = 2;
+
+// Deeper messages than this are treated as a damaged log
+static const int MAX_MESSAGE_DEPTH = 32;
+
+bool SessionLogWriter::Open(const std::string& path)
+{
+	_file.open(path, std::ios::binary | std::ios::trunc);
+	if (!_file.is_open()) return false;
+
+	_file.write(SESSION_LOG_MAGIC, sizeof(SESSION_LOG_MAGIC));
+	_file.put(SESSION_LOG_VERSION);
+	_lastTimestamp = 0;
+
+	return _file.good();
+}
+
+void SessionLogWriter::Close()
+{
+	if (_file.is_open())
+		_file.close();
+}
+
+void SessionLogWriter::Write(const SessionRecord& record)
+{
+	if (!_file.is_open()) return;
+
+	_buffer.clear();
+	_buffer.push_back(record.type);
+
+	uint64_t timestamp = record.timestamp < _lastTimestamp ? _lastTimestamp : record.timestamp;
+	WriteVarint(timestamp - _lastTimestamp);
+	_lastTimestamp = timestamp;
+
+	switch (record.type)
+	{
+	case RECORD_RADAR:
+		WriteSample(record.sample);
+		WriteMessage(record.message);
+		break;
+	case RECORD_FLIGHT_PLAN:
+	case RECORD_CHAT:
+	case RECORD_PLANE_INFO:
+		WriteMessage(record.message);
+		break;
+	case RECORD_DISCONNECT:
+		WriteString(record.callsign);
+		break;
+	case RECORD_TIMER:
+		WriteSigned(record.counter);
+		break;
+	}
+
+	_file.write(_buffer.data(), _buffer.size());
+
+	// The timer fires once a second, so at most a second of the session is lost if EuroScope goes down
+	if (record.type == RECORD_TIMER)
+		_file.flush();
+}
+
+void SessionLogWriter::WriteVarint(uint64_t value)
+{
+	while (value >= 0x80)
+	{
+		_buffer.push_back(static_cast<char>((value & 0x7F) | 0x80));
+		value >>= 7;
+	}
+
+	_buffer.push_back(static_cast<char>(value));
+}
+
+void SessionLogWriter::WriteSigned(int64_t value)
+{
+	WriteVarint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+}
+
+void SessionLogWriter::WriteDouble(double value)
+{
+	char bytes[sizeof(double)];
+	memcpy(bytes, &value, sizeof(double));
+	_buffer.append(bytes, sizeof(double));
+}
+
+void SessionLogWriter::WriteString(const std::string& value)
+{
+	WriteVarint(value.size());
+	_buffer.append(value);
+}
+
+void SessionLogWriter::WriteMessage(const sio::message::ptr& message)
+{
+	if (!message)
+	{
+		_buffer.push_back(static_cast<char>(sio::message::flag_null));
+		return;
+	}
+
+	_buffer.push_back(static_cast<char>(message->get_flag()));
+
+	switch (message->get_flag())
+	{
+	case sio::message::flag_integer:
+		WriteSigned(message->get_int());
+		break;
+	case sio::message::flag_double:
+		WriteDouble(message->get_double());
+		break;
+	case sio::message::flag_string:
+		WriteString(message->get_string());
+		break;
+	case sio::message::flag_binary:
+		WriteString(message->get_binary() ? *message->get_binary() : std::string());
+		break;
+	case sio::message::flag_boolean:
+		_buffer.push_back(message->get_bool() ? 1 : 0);
+		break;
+	case sio::message::flag_array:
+		WriteVarint(message->get_vector().size());
+		for (const auto& item : message->get_vector())
+			WriteMessage(item);
+		break;
+	case sio::message::flag_object:
+		WriteVarint(message->get_map().size());
+		for (const auto& item : message->get_map())
+		{
+			WriteString(item.first);
+			WriteMessage(item.second);
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+void SessionLogWriter::WriteSample(const RadarSample& sample)
+{
+	WriteString(sample.callsign);
+	WriteString(sample.systemId);
+	WriteString(sample.squawk);
+	WriteDouble(sample.latitude);
+	WriteDouble(sample.longitude);
+	WriteSigned(sample.altitude);
+	WriteSigned(sample.groundSpeed);
+	WriteSigned(sample.verticalSpeed);
+	WriteSigned(sample.heading);
+	_buffer.push_back(sample.correlated ? 1 : 0);
+	WriteSigned(sample.targetAltitude);
+}
+
+bool SessionLogReader::Open(const std::string& path)
+{
+	_file.open(path, std::ios::binary);
+	if (!_file.is_open()) return false;
+
+	char magic[sizeof(SESSION_LOG_MAGIC)];
+	_file.read(magic, sizeof(magic));
+
+	if (!_file.good() || memcmp(magic, SESSION_LOG_MAGIC, sizeof(magic)) != 0)
+		return false;
+
+	_lastTimestamp = 0;
+
+	int version = _file.get();
+	if (version < 1 || version > SESSION_LOG_VERSION) return false;
+
+	_version = static_cast<uint8_t>(version);
+	return true;
+}
+
+bool SessionLogReader::Read(SessionRecord& record)
+{
+	int type = _file.get();
+	if (type == EOF) return false;
+
+	uint64_t delta = 0;
+	if (!ReadVarint(delta)) return false;
+
+	_lastTimestamp += delta;
+
+	record = SessionRecord();
+	record.type = static_cast<SessionRecordType>(type);
+	record.timestamp = _lastTimestamp;
+
+	switch (record.type)
+	{
+	case RECORD_RADAR:
+		return ReadSample(record.sample) && ReadMessage(record.message);
+	case RECORD_FLIGHT_PLAN:
+	case RECORD_CHAT:
+	case RECORD_PLANE_INFO:
+		return ReadMessage(record.message);
+	case RECORD_DISCONNECT:
+		return ReadString(record.callsign);
+	case RECORD_TIMER:
+		return ReadInt(record.counter);
+	default:
+		return false;
+	}
+}
+
+bool SessionLogReader::ReadVarint(uint64_t& value)
+{
+	value = 0;
+
+	for (int shift = 0; shift < 64; shift += 7)
+	{
+		int byte = _file.get();
+		if (byte == EOF) return false;
+
+		value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+		if (!(byte & 0x80)) return true;
+	}
+
+	return false;
+}
+
+bool SessionLogReader::ReadSigned(int64_t& value)
+{
+	uint64_t raw = 0;
+	if (!ReadVarint(raw)) return false;
+
+	value = static_cast<int64_t>(raw >> 1) ^ -static_cast<int64_t>(raw & 1);
+	return true;
+}
+
+bool SessionLogReader::ReadInt(int& value)
+{
+	int64_t raw = 0;
+	if (!ReadSigned(raw)) return false;
+
+	value = static_cast<int>(raw);
+	return true;
+}
+
+bool SessionLogReader::ReadDouble(double& value)
+{
+	char bytes[sizeof(double)];
+	_file.read(bytes, sizeof(double));
+	if (!_file.good()) return false;
+
+	memcpy(&value, bytes, sizeof(double));
+	return true;
+}
+
+bool SessionLogReader::ReadString(std::string& value)
+{
+	uint64_t length = 0;
+	if (!ReadVarint(length) || length > (1 << 24)) return false;
+
+	value.resize(static_cast<size_t>(length));
+	if (length > 0)
+		_file.read(&value[0], length);
+
+	return _file.good();
+}
+
+bool SessionLogReader::ReadMessage(sio::message::ptr& message, int depth)
+{
+	if (depth > MAX_MESSAGE_DEPTH) return false;
+
+	int flag = _file.get();
+	if (flag == EOF) return false;
+
+	switch (flag)
+	{
+	case sio::message::flag_integer:
+	{
+		int64_t value = 0;
+		if (!ReadSigned(value)) return false;
+		message = sio::int_message::create(value);
+		return true;
+	}
+	case sio::message::flag_double:
+	{
+		double value = 0;
+		if (!ReadDouble(value)) return false;
+		message = sio::double_message::create(value);
+		return true;
+	}
+	case sio::message::flag_string:
+	{
+		std::string value;
+		if (!ReadString(value)) return false;
+		message = sio::string_message::create(value);
+		return true;
+	}
+	case sio::message::flag_binary:
+	{
+		std::string value;
+		if (!ReadString(value)) return false;
+		message = sio::binary_message::create(std::make_shared<const std::string>(value));
+		return true;
+	}
+	case sio::message::flag_boolean:
+	{
+		int value = _file.get();
+		if (value == EOF) return false;
+		message = sio::bool_message::create(value != 0);
+		return true;
+	}
+	case sio::message::flag_array:
+	{
+		uint64_t count = 0;
+		if (!ReadVarint(count)) return false;
+
+		message = sio::array_message::create();
+		for (uint64_t i = 0; i < count; i++)
+		{
+			sio::message::ptr item;
+			if (!ReadMessage(item, depth + 1)) return false;
+			message->get_vector().push_back(item);
+		}
+		return true;
+	}
+	case sio::message::flag_object:
+	{
+		uint64_t count = 0;
+		if (!ReadVarint(count)) return false;
+
+		message = sio::object_message::create();
+		for (uint64_t i = 0; i < count; i++)
+		{
+			std::string key;
+			sio::message::ptr item;
+			if (!ReadString(key) || !ReadMessage(item, depth + 1)) return false;
+			message->get_map()[key] = item;
+		}
+		return true;
+	}
+	case sio::message::flag_null:
+		message = sio::null_message::create();
+		return true;
+	default:
+		return false;
+	}
+}
+
+bool SessionLogReader::ReadSample(RadarSample& sample)
+{
+	bool valid = ReadString(sample.callsign)
+		&& ReadString(sample.systemId)
+		&& ReadString(sample.squawk)
+		&& ReadDouble(sample.latitude)
+		&& ReadDouble(sample.longitude)
+		&& ReadInt(sample.altitude)
+		&& ReadInt(sample.groundSpeed)
+		&& ReadInt(sample.verticalSpeed)
+		&& ReadInt(sample.heading);
+	if (!valid) return false;
+
+	int correlated = _file.get();
+	if (correlated == EOF) return false;
+
+	sample.correlated = correlated != 0;
+
+	if (_version < SESSION_LOG_TARGET_ALTITUDE_VERSION) return true;
+
+	return ReadInt(sample.targetAltitude);
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <sio_client.h>
+
+#include "../Surveillance/RadarSample.h"
+
+enum SessionRecordType : uint8_t {
+    RECORD_RADAR = 1,
+    RECORD_FLIGHT_PLAN,
+    RECORD_DISCONNECT,
+    RECORD_CHAT,
+    RECORD_PLANE_INFO,
+    RECORD_TIMER
+};
+
+/**
+* One EuroScope callback as the bridge saw it.
+*
+* Radar records carry the sample and the radar target message sent to EXCDS; flight plan, chat and plane information
+* records carry the message only. Disconnects carry the callsign and timer records the counter.
+*/
+struct SessionRecord
+{
+    SessionRecordType type = RECORD_TIMER;
+
+    /**
+    * Milliseconds since the recording started
+    */
+    uint64_t timestamp = 0;
+
+    RadarSample sample;
+    sio::message::ptr message;
+    std::string callsign;
+    int counter = 0;
+};
+
+/**
+* Session logs are a header ("EXCDSREC" and a version byte) followed by records. Each record is its type, the
+* milliseconds since the previous record and its payload. Integers are LEB128 varints (zigzag encoded if signed),
+* doubles are stored as their 8 raw bytes and strings are length prefixed. Messages are stored as a tree of
+* type-tagged values.
+*/
+class SessionLogWriter
+{
+public:
+    bool Open(const std::string& path);
+    void Close();
+    bool IsOpen() const { return _file.is_open(); }
+
+    void Write(const SessionRecord& record);
+private:
+    void WriteVarint(uint64_t value);
+    void WriteSigned(int64_t value);
+    void WriteDouble(double value);
+    void WriteString(const std::string& value);
+    void WriteMessage(const sio::message::ptr& message);
+    void WriteSample(const RadarSample& sample);
+
+    std::ofstream _file;
+    std::string _buffer;
+    uint64_t _lastTimestamp = 0;
+};
+
+class SessionLogReader
+{
+public:
+    bool Open(const std::string& path);
+
+    /**
+    * Reads the next record. Returns false at the end of the log or if the rest of it is damaged.
+    */
+    bool Read(SessionRecord& record);
+private:
+    bool ReadVarint(uint64_t& value);
+    bool ReadSigned(int64_t& value);
+    bool ReadInt(int& value);
+    bool ReadDouble(double& value);
+    bool ReadString(std::string& value);
+    bool ReadMessage(sio::message::ptr& message, int depth = 0);
+    bool ReadSample(RadarSample& sample);
+
+    std::ifstream _file;
+    uint64_t _lastTimestamp = 0;
+    uint8_t _version = 0;
+};
@@ -0,0 +1,112 @@
+#include "SessionRecorder.h"
+
+SessionRecorder* SessionRecorder::GetInstance()
+{
+	static SessionRecorder recorder;
+	return &recorder;
+}
+
+bool SessionRecorder::Start(const std::string& path)
+{
+	std::lock_guard<std::mutex> guard(_lock);
+
+	_writer.Close();
+	if (!_writer.Open(path))
+	{
+		_writer.Close();
+		_recording = false;
+		return false;
+	}
+
+	_start = std::chrono::steady_clock::now();
+	_records = 0;
+	_recording = true;
+
+	return true;
+}
+
+void SessionRecorder::Stop()
+{
+	std::lock_guard<std::mutex> guard(_lock);
+
+	_recording = false;
+	_writer.Close();
+}
+
+void SessionRecorder::RecordRadar(const RadarSample& sample, const sio::message::ptr& message)
+{
+	if (!IsRecording()) return;
+
+	SessionRecord record;
+	record.type = RECORD_RADAR;
+	record.sample = sample;
+	record.message = message;
+
+	Write(record);
+}
+
+void SessionRecorder::RecordFlightPlan(const sio::message::ptr& message)
+{
+	if (!IsRecording()) return;
+
+	SessionRecord record;
+	record.type = RECORD_FLIGHT_PLAN;
+	record.message = message;
+
+	Write(record);
+}
+
+void SessionRecorder::RecordDisconnect(const std::string& callsign)
+{
+	if (!IsRecording()) return;
+
+	SessionRecord record;
+	record.type = RECORD_DISCONNECT;
+	record.callsign = callsign;
+
+	Write(record);
+}
+
+void SessionRecorder::RecordChat(const sio::message::ptr& message)
+{
+	if (!IsRecording()) return;
+
+	SessionRecord record;
+	record.type = RECORD_CHAT;
+	record.message = message;
+
+	Write(record);
+}
+
+void SessionRecorder::RecordPlaneInfo(const sio::message::ptr& message)
+{
+	if (!IsRecording()) return;
+
+	SessionRecord record;
+	record.type = RECORD_PLANE_INFO;
+	record.message = message;
+
+	Write(record);
+}
+
+void SessionRecorder::RecordTimer(int counter)
+{
+	if (!IsRecording()) return;
+
+	SessionRecord record;
+	record.type = RECORD_TIMER;
+	record.counter = counter;
+
+	Write(record);
+}
+
+void SessionRecorder::Write(SessionRecord& record)
+{
+	std::lock_guard<std::mutex> guard(_lock);
+	if (!_recording) return;
+
+	record.timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - _start).count();
+
+	_writer.Write(record);
+	_records++;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <sio_client.h>
+
+#include "SessionLog.h"
+
+/**
+* Records the EuroScope callbacks the bridge receives into a session log, so a session can be replayed later.
+*
+* When not recording, every Record call is a single atomic load.
+*/
+class SessionRecorder
+{
+public:
+    static SessionRecorder* GetInstance();
+
+    bool Start(const std::string& path);
+    void Stop();
+    bool IsRecording() const { return _recording.load(std::memory_order_relaxed); }
+    unsigned long long GetRecordCount() const { return _records; }
+
+    void RecordRadar(const RadarSample& sample, const sio::message::ptr& message);
+    void RecordFlightPlan(const sio::message::ptr& message);
+    void RecordDisconnect(const std::string& callsign);
+    void RecordChat(const sio::message::ptr& message);
+    void RecordPlaneInfo(const sio::message::ptr& message);
+    void RecordTimer(int counter);
+private:
+    void Write(SessionRecord& record);
+
+    std::atomic<bool> _recording{ false };
+    std::mutex _lock;
+    SessionLogWriter _writer;
+    std::chrono::steady_clock::time_point _start;
+    unsigned long long _records = 0;
+};
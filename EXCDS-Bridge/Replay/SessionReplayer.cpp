@@ -0,0 +1,115 @@
+#include <chrono>
+
+#include "SessionReplayer.h"
+#include "SessionLog.h"
+#include "../CEXCDSBridge.h"
+#include "../Diagnostics/Metrics.h"
+
+// Longest single sleep, so a stop request is picked up quickly even across long gaps in the log
+static const std::chrono::milliseconds MAX_SLEEP(100);
+
+SessionReplayer* SessionReplayer::GetInstance()
+{
+	static SessionReplayer replayer;
+	return &replayer;
+}
+
+SessionReplayer::~SessionReplayer()
+{
+	Stop();
+}
+
+bool SessionReplayer::Start(const std::string& path, double speed)
+{
+	std::lock_guard<std::mutex> guard(_lock);
+
+	if (_running) return false;
+
+	// Check the log before handing it to the thread, so a bad path is reported to the caller
+	SessionLogReader reader;
+	if (!reader.Open(path)) return false;
+
+	if (_thread.joinable())
+		_thread.join();
+
+	_stopRequested = false;
+	_running = true;
+	_records = 0;
+	_thread = std::thread(&SessionReplayer::Run, this, path, speed);
+
+	return true;
+}
+
+void SessionReplayer::Stop()
+{
+	std::lock_guard<std::mutex> guard(_lock);
+
+	_stopRequested = true;
+	if (_thread.joinable())
+		_thread.join();
+}
+
+void SessionReplayer::Run(std::string path, double speed)
+{
+	MetricCounter& replayed = Metrics::GetInstance()->Counter("replay.records");
+
+	SessionLogReader reader;
+	SessionRecord record;
+
+	reader.Open(path);
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	// Radar returns are stamped from the start of the replay at the times they were recorded, whatever the speed
+	double replayStart = RadarSample::Now();
+
+	while (!_stopRequested && reader.Read(record))
+	{
+		if (speed > 0)
+		{
+			std::chrono::steady_clock::time_point due = start + std::chrono::microseconds(static_cast<long long>(record.timestamp * 1000 / speed));
+
+			while (!_stopRequested && std::chrono::steady_clock::now() < due)
+			{
+				std::chrono::steady_clock::duration remaining = due - std::chrono::steady_clock::now();
+				std::this_thread::sleep_for(remaining < MAX_SLEEP ? remaining : std::chrono::steady_clock::duration(MAX_SLEEP));
+			}
+
+			if (_stopRequested) break;
+		}
+
+		try {
+			switch (record.type)
+			{
+			case RECORD_RADAR:
+				record.sample.synthetic = true;
+				record.sample.time = replayStart + record.timestamp / 1000.0;
+				CEXCDSBridge::PublishRadarTarget(record.sample, record.message);
+				break;
+			case RECORD_FLIGHT_PLAN:
+				CEXCDSBridge::PublishFlightPlan(record.message, true);
+				break;
+			case RECORD_DISCONNECT:
+				CEXCDSBridge::PublishDisconnect(record.callsign);
+				break;
+			case RECORD_CHAT:
+				CEXCDSBridge::Emit("SEND_CHAT_DATA", record.message);
+				break;
+			case RECORD_PLANE_INFO:
+				CEXCDSBridge::Emit("SEND_PLANE_DATA", record.message);
+				break;
+			case RECORD_TIMER:
+				// The live timer keeps ticking the streams while a replay runs, ticking them again would run them twice
+				break;
+			}
+		}
+		catch (...) {
+			Metrics::CountException("SessionReplayer", "EXCDS Error: Failed to replay session record");
+		}
+
+		_records++;
+		replayed.Increment();
+	}
+
+	_running = false;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/**
+* Plays a session log back into the bridge on a background thread.
+*
+* Radar and flight plan records go through the same paths as live updates (CEXCDSBridge::PublishRadarTarget and
+* PublishFlightPlan), timer records are skipped as the live timer keeps running and everything else is emitted to
+* EXCDS as it was recorded. The log can be played in
+* real time, N times faster, or as fast as the bridge can take it (speed 0).
+*/
+class SessionReplayer
+{
+public:
+    static SessionReplayer* GetInstance();
+
+    ~SessionReplayer();
+
+    bool Start(const std::string& path, double speed);
+    void Stop();
+    bool IsReplaying() const { return _running.load(); }
+    unsigned long long GetRecordCount() const { return _records.load(); }
+private:
+    void Run(std::string path, double speed);
+
+    std::mutex _lock;
+    std::thread _thread;
+    std::atomic<bool> _running{ false };
+    std::atomic<bool> _stopRequested{ false };
+    std::atomic<unsigned long long> _records{ 0 };
+};
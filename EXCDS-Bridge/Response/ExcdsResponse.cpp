@@ -14,6 +14,8 @@ std::string ExcdsResponse::GetCode()
         return "SCRCHPD_STRNG_NOT_SET";
     case ExcdsResponseType::SCRCHPD_NOT_MODIFIED:
         return "SCRCHPD_NOT_MODIFIED";
+    case ExcdsResponseType::DCT_UNKNOWN_FIX:
+        return "DCT_UNKN_FIX";
     default:
         return "UNKNOWN";
     }
@@ -33,6 +35,8 @@ std::string ExcdsResponse::GetExcdsMessage()
         return "Cannot set scratchpad string.";
     case ExcdsResponseType::SCRCHPD_NOT_MODIFIED:
         return "Scratchpad not modified.";
+    case ExcdsResponseType::DCT_UNKNOWN_FIX:
+        return "Direct to point is not in the sector file.";
     default:
         return "Unknown response.";
     }
@@ -21,6 +21,11 @@ enum ExcdsResponseType {
     SCRCHPD_STRNG_NOT_SET,
     SCRCHPD_NOT_MODIFIED,
 
+    /**
+    * DirectToUpdateEvent response types
+    */
+    DCT_UNKNOWN_FIX,
+
     UNKNOWN
 };
 
@@ -0,0 +1,305 @@
+#include <algorithm>
+#include <ctime>
+#include <fstream>
+
+#include "LoadTest.h"
+#include "../ApiHelper.h"
+#include "../CEXCDSBridge.h"
+#include "../Diagnostics/Metrics.h"
+
+/**
+* How often each command turns up in a busy session, relative to the others. Only the requests that read from
+* EuroScope run by default. Commands that change anything, like altitudes, routes, tracking or squawks, or that send
+* messages to pilots, only take part if asked for with an explicit list of callsigns. UPDATE_POSITIONS is never in
+* the mix, as it replaces the estimate positions for every aircraft.
+*/
+struct MixWeight
+{
+    const char* eventName;
+    double weight;
+};
+
+static const MixWeight COMMAND_MIX[] = {
+	{ "REQUEST_FP_DATA_CALLSIGN", 15 },
+	{ "REQUEST_ROUTE_DATA", 10 },
+	{ "QUERY_FP", 2 },
+	{ "REQUEST_DIRECT_TO", 1 },
+	{ "REQUEST_ALL_FP_DATA", 0.2 },
+	{ "REQUEST_CTRLR_DATA", 0.2 },
+	{ "REQUEST_AIRPORT_DATA", 0.2 },
+	{ "REQUEST_TRACK_HISTORY", 0.2 },
+	{ "UPDATE_ALTITUDE", 25 },
+	{ "UPDATE_SCRATCHPAD", 15 },
+	{ "HANDOFF_TARGET", 8 },
+	{ "ACCEPT_HANDOFF", 8 },
+	{ "UPDATE_SPEED", 5 },
+	{ "UPDATE_SQUAWK", 4 },
+	{ "UPDATE_STATUS", 3 },
+	{ "UPDATE_DEPARTURE_TIME", 2 },
+	{ "UPDATE_TIME", 2 },
+	{ "UPDATE_TRACKING_STATUS", 2 },
+	{ "UPDATE_DIRECT", 2 },
+	{ "REFUSE_HANDOFF", 1 },
+	{ "ACCEPT_COORD", 1 },
+	{ "REFUSE_COORD", 1 },
+	{ "CORRELATE_TARGET", 1 },
+	{ "UPDATE_ROUTE", 1 },
+	{ "UPDATE_FLIGHT_PLAN", 1 },
+	{ "NEW_FLIGHT_PLAN", 0.5 },
+	{ "DECORRELATE_TARGET", 0.5 },
+	{ "SEND_PDC", 0.5 },
+};
+
+// A step is saturated when less than this share of the offered rate gets through
+static const double SATURATED_THROUGHPUT = 0.95;
+
+// Saturated steps to run before giving up
+static const int SATURATED_STEPS = 2;
+
+LoadTestConfig LoadTestConfig::FromMessage(const sio::message::ptr& message)
+{
+	LoadTestConfig config;
+	if (!message || message->get_flag() != sio::message::flag_object) return config;
+
+	const std::map<std::string, sio::message::ptr>& payload = message->get_map();
+
+	auto number = [&payload](const char* key, double fallback)
+	{
+		auto value = payload.find(key);
+		if (value == payload.end() || !value->second) return fallback;
+		if (value->second->get_flag() != sio::message::flag_integer && value->second->get_flag() != sio::message::flag_double) return fallback;
+
+		return value->second->get_double();
+	};
+
+	config.startRate = number("start_rate", config.startRate);
+	config.growth = number("growth", config.growth);
+	config.maxRate = number("max_rate", config.maxRate);
+	config.stepSeconds = number("step_seconds", config.stepSeconds);
+
+	auto stateChanging = payload.find("include_state_changing");
+	if (stateChanging != payload.end() && stateChanging->second && stateChanging->second->get_flag() == sio::message::flag_boolean)
+		config.includeStateChanging = stateChanging->second->get_bool();
+
+	auto callsigns = payload.find("callsigns");
+	if (callsigns != payload.end() && callsigns->second && callsigns->second->get_flag() == sio::message::flag_array)
+	{
+		for (const auto& callsign : callsigns->second->get_vector())
+			config.callsigns.push_back(callsign->get_string());
+	}
+
+	if (config.startRate <= 0) config.startRate = 1;
+	if (config.growth <= 1) config.growth = 2;
+	if (config.stepSeconds <= 0) config.stepSeconds = 1;
+
+	return config;
+}
+
+LoadTest* LoadTest::GetInstance()
+{
+	static LoadTest loadTest;
+	return &loadTest;
+}
+
+LoadTest::~LoadTest()
+{
+	Stop();
+}
+
+bool LoadTest::Start(const LoadTestConfig& config)
+{
+	std::lock_guard<std::mutex> guard(_lock);
+
+	if (_running || config.callsigns.empty() || LoopbackSocket::GetInstance()->IsStormRunning()) return false;
+
+	if (_thread.joinable())
+		_thread.join();
+
+	_stopRequested = false;
+	_running = true;
+	_thread = std::thread(&LoadTest::Run, this, config);
+
+	return true;
+}
+
+void LoadTest::Stop()
+{
+	std::lock_guard<std::mutex> guard(_lock);
+
+	_stopRequested = true;
+	LoopbackSocket::GetInstance()->StopStorm();
+
+	if (_thread.joinable())
+		_thread.join();
+}
+
+sio::message::ptr LoadTest::GetResults()
+{
+	std::lock_guard<std::mutex> guard(_resultsLock);
+
+	if (!_results)
+	{
+		sio::message::ptr empty = sio::object_message::create();
+		empty->get_map()["running"] = sio::bool_message::create(_running);
+		return empty;
+	}
+
+	return _results;
+}
+
+StormScript LoadTest::BuildMix(const LoadTestConfig& config, double rate, std::vector<std::string>& skipped)
+{
+	std::vector<std::string> registered = CEXCDSBridge::GetRegisteredEvents();
+	std::vector<const MixWeight*> mix;
+	double totalWeight = 0;
+
+	skipped.clear();
+
+	for (const MixWeight& entry : COMMAND_MIX)
+	{
+		if (!config.includeStateChanging && !StormScript::IsReadOnly(entry.eventName)) continue;
+
+		if (std::find(registered.begin(), registered.end(), entry.eventName) == registered.end())
+		{
+			skipped.push_back(entry.eventName);
+			continue;
+		}
+
+		mix.push_back(&entry);
+		totalWeight += entry.weight;
+	}
+
+	// Handlers that were registered without a place in the mix have no payload to drive them with
+	for (const std::string& eventName : registered)
+	{
+		bool inMix = false;
+		for (const MixWeight& entry : COMMAND_MIX)
+			inMix = inMix || eventName == entry.eventName;
+
+		if (!inMix)
+			skipped.push_back(eventName);
+	}
+
+	StormScript script;
+	script.duration = config.stepSeconds;
+	script.callsigns = config.callsigns;
+
+	for (const MixWeight* entry : mix)
+	{
+		StormCommand command;
+		command.eventName = entry->eventName;
+		command.rate = rate * entry->weight / totalWeight;
+		command.payload = StormScript::DefaultPayload(entry->eventName);
+
+		script.commands.push_back(command);
+	}
+
+	return script;
+}
+
+void LoadTest::Run(LoadTestConfig config)
+{
+	LoopbackSocket* loopback = LoopbackSocket::GetInstance();
+
+	sio::message::ptr results = sio::object_message::create();
+	sio::message::ptr steps = sio::array_message::create();
+	std::vector<std::string> skipped;
+
+	char startedAt[32];
+	struct tm newTime;
+	time_t t = time(0);
+
+	localtime_s(&newTime, &t);
+	std::strftime(startedAt, sizeof(startedAt), "%Y-%m-%dT%H:%M:%S", &newTime);
+
+	results->get_map()["started_at"] = sio::string_message::create(startedAt);
+	results->get_map()["start_rate"] = sio::double_message::create(config.startRate);
+	results->get_map()["growth"] = sio::double_message::create(config.growth);
+	results->get_map()["step_seconds"] = sio::double_message::create(config.stepSeconds);
+	results->get_map()["include_state_changing"] = sio::bool_message::create(config.includeStateChanging);
+	results->get_map()["callsigns"] = sio::int_message::create(config.callsigns.size());
+	results->get_map()["steps"] = steps;
+
+	double queueingOnset = -1;
+	double maxSustained = 0;
+	int saturatedSteps = 0;
+
+	try {
+		for (double rate = config.startRate; rate <= config.maxRate && !_stopRequested; rate *= config.growth)
+		{
+			StormScript script = BuildMix(config, rate, skipped);
+			if (script.commands.empty() || !loopback->StartStorm(script)) break;
+
+			loopback->WaitForStorm();
+			if (_stopRequested) break;
+
+			StormTotals totals = loopback->GetTotals();
+			double achieved = totals.elapsedMs > 0 ? totals.sent * 1000.0 / totals.elapsedMs : 0;
+
+			// Either the bridge cannot keep up, or commands are waiting on the ones before them
+			bool saturated = achieved < rate * SATURATED_THROUGHPUT || totals.p50 > 1000000 / rate;
+
+			sio::message::ptr step = sio::object_message::create();
+			step->get_map()["offered_rate"] = sio::double_message::create(rate);
+			step->get_map()["achieved_rate"] = sio::double_message::create(achieved);
+			step->get_map()["sent"] = sio::int_message::create(totals.sent);
+			step->get_map()["acked"] = sio::int_message::create(totals.acked);
+			step->get_map()["lost"] = sio::int_message::create(totals.lost);
+			step->get_map()["p50_us"] = sio::int_message::create(totals.p50);
+			step->get_map()["p99_us"] = sio::int_message::create(totals.p99);
+			step->get_map()["p999_us"] = sio::int_message::create(totals.p999);
+			step->get_map()["max_us"] = sio::int_message::create(totals.max);
+			step->get_map()["saturated"] = sio::bool_message::create(saturated);
+			step->get_map()["commands"] = loopback->GetReport()->get_map()["commands"];
+
+			steps->get_vector().push_back(step);
+
+			if (!saturated)
+				maxSustained = std::max(maxSustained, achieved);
+			else if (queueingOnset < 0)
+				queueingOnset = rate;
+
+			results->get_map()["max_sustained_rate"] = sio::double_message::create(maxSustained);
+			results->get_map()["queueing_onset_rate"] = queueingOnset < 0 ? sio::null_message::create() : sio::double_message::create(queueingOnset);
+
+			// The results keep growing here, so readers get a copy of them as they stand
+			sio::message::ptr snapshot = ApiHelper::CopyMessage(results);
+			{
+				std::lock_guard<std::mutex> guard(_resultsLock);
+				_results = snapshot;
+			}
+
+			if (saturated && ++saturatedSteps >= SATURATED_STEPS) break;
+		}
+	}
+	catch (...) {
+		Metrics::CountException("LoadTest", "EXCDS Error: Load test failed");
+	}
+
+	sio::message::ptr skippedMessage = sio::array_message::create();
+	for (const std::string& eventName : skipped)
+		skippedMessage->get_vector().push_back(sio::string_message::create(eventName));
+
+	results->get_map()["skipped_events"] = skippedMessage;
+	results->get_map()["max_sustained_rate"] = sio::double_message::create(maxSustained);
+	results->get_map()["queueing_onset_rate"] = queueingOnset < 0 ? sio::null_message::create() : sio::double_message::create(queueingOnset);
+	results->get_map()["stopped"] = sio::bool_message::create(_stopRequested.load());
+
+	char fileTime[32];
+	std::strftime(fileTime, sizeof(fileTime), "%Y%m%d-%H%M%S", &newTime);
+	std::string path = ApiHelper::ResolvePluginPath("EXCDS-Bridge-loadtest-" + std::string(fileTime) + ".json");
+
+	std::ofstream file(path, std::ios::trunc);
+	if (file.is_open())
+	{
+		file << ApiHelper::ToJson(results);
+		results->get_map()["file"] = sio::string_message::create(path);
+	}
+
+	{
+		std::lock_guard<std::mutex> guard(_resultsLock);
+		_results = results;
+	}
+
+	_running = false;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sio_client.h>
+
+#include "LoopbackSocket.h"
+
+struct LoadTestConfig
+{
+    /**
+    * Commands per second of the first step, multiplied by growth for every following step up to maxRate
+    */
+    double startRate = 10;
+    double growth = 2;
+    double maxRate = 5000;
+
+    /**
+    * Seconds each step runs for
+    */
+    double stepSeconds = 5;
+
+    /**
+    * Also drive the handlers that change flight plans, tracking or squawks, or send messages to pilots. Only
+    * accepted together with an explicit list of callsigns.
+    */
+    bool includeStateChanging = false;
+
+    std::vector<std::string> callsigns;
+
+    /**
+    * Reads a config from a RUN_LOAD_TEST payload. Anything not given keeps its default.
+    */
+    static LoadTestConfig FromMessage(const sio::message::ptr& message);
+};
+
+/**
+* Finds how many commands per second the bridge can apply before acks start lagging.
+*
+* The test runs a series of loopback storms at increasing rates, each a weighted mix of the commands registered in
+* bind_events that resembles a busy session. A step is saturated when the bridge cannot keep up with the offered
+* rate, or when the median ack takes longer than the gap between commands, which means commands have started
+* waiting for each other. The rate of the first saturated step is reported as the onset of queueing. The test stops
+* after two saturated steps, and the results are written as JSON next to the plugin DLL.
+*/
+class LoadTest
+{
+public:
+    static LoadTest* GetInstance();
+
+    ~LoadTest();
+
+    bool Start(const LoadTestConfig& config);
+    void Stop();
+    bool IsRunning() const { return _running.load(); }
+
+    sio::message::ptr GetResults();
+private:
+    void Run(LoadTestConfig config);
+    static StormScript BuildMix(const LoadTestConfig& config, double rate, std::vector<std::string>& skipped);
+
+    std::mutex _lock;
+    std::thread _thread;
+    std::atomic<bool> _running{ false };
+    std::atomic<bool> _stopRequested{ false };
+
+    /**
+    * The last results published by Run. Never changed once published, Run builds its own and swaps in a copy.
+    */
+    std::mutex _resultsLock;
+    sio::message::ptr _results;
+};
@@ -0,0 +1,464 @@
+#include "LoopbackSocket.h"
+#include "../CEXCDSBridge.h"
+#include "../Diagnostics/Metrics.h"
+
+// Longest single sleep, so a stop request is picked up quickly
+static const std::chrono::milliseconds MAX_SLEEP(100);
+
+// Recent emits included in the report
+static const size_t REPORTED_EMITS = 100;
+
+// Handlers that only read from EuroScope, and what a storm runs when no commands are given
+static const char* READ_ONLY_EVENTS[] = {
+	"REQUEST_FP_DATA_CALLSIGN",
+	"REQUEST_ROUTE_DATA",
+	"REQUEST_ALL_FP_DATA",
+	"REQUEST_CTRLR_DATA",
+	"REQUEST_AIRPORT_DATA",
+	"QUERY_FP",
+	"REQUEST_TRACK_HISTORY",
+	"REQUEST_DIRECT_TO",
+};
+
+StormScript StormScript::FromMessage(const sio::message::ptr& message)
+{
+	StormScript script;
+	if (!message || message->get_flag() != sio::message::flag_object) return script;
+
+	const std::map<std::string, sio::message::ptr>& payload = message->get_map();
+
+	auto duration = payload.find("duration");
+	if (duration != payload.end() && duration->second)
+		script.duration = duration->second->get_double();
+
+	auto callsigns = payload.find("callsigns");
+	if (callsigns != payload.end() && callsigns->second && callsigns->second->get_flag() == sio::message::flag_array)
+	{
+		for (const auto& callsign : callsigns->second->get_vector())
+			script.callsigns.push_back(callsign->get_string());
+	}
+
+	auto commands = payload.find("commands");
+	if (commands != payload.end() && commands->second && commands->second->get_flag() == sio::message::flag_array)
+	{
+		for (const auto& item : commands->second->get_vector())
+		{
+			const std::map<std::string, sio::message::ptr>& fields = item->get_map();
+			StormCommand command;
+
+			auto eventName = fields.find("event");
+			if (eventName == fields.end() || !eventName->second) continue;
+			command.eventName = eventName->second->get_string();
+
+			auto rate = fields.find("rate");
+			if (rate != fields.end() && rate->second)
+				command.rate = rate->second->get_double();
+
+			auto commandPayload = fields.find("payload");
+			command.payload = commandPayload != fields.end() && commandPayload->second && commandPayload->second->get_flag() == sio::message::flag_object
+				? commandPayload->second
+				: DefaultPayload(command.eventName);
+
+			if (command.rate > 0 && command.payload)
+				script.commands.push_back(command);
+		}
+	}
+
+	if (commands == payload.end())
+	{
+		for (const char* eventName : READ_ONLY_EVENTS)
+		{
+			StormCommand command;
+			command.eventName = eventName;
+			command.payload = DefaultPayload(eventName);
+
+			script.commands.push_back(command);
+		}
+	}
+
+	return script;
+}
+
+bool StormScript::IsReadOnly(const std::string& eventName)
+{
+	for (const char* readOnly : READ_ONLY_EVENTS)
+	{
+		if (eventName == readOnly) return true;
+	}
+
+	return false;
+}
+
+bool StormScript::IsReadOnly() const
+{
+	for (const StormCommand& command : commands)
+	{
+		if (!IsReadOnly(command.eventName)) return false;
+	}
+
+	return true;
+}
+
+sio::message::ptr StormScript::DefaultPayload(const std::string& eventName)
+{
+	sio::message::ptr payload = sio::object_message::create();
+
+	std::map<std::string, sio::message::ptr>& fields = payload->get_map();
+
+	// Values are chosen to leave the flight plan as it is where the handler allows it
+	if (eventName == "UPDATE_ALTITUDE")
+	{
+		fields["id"] = sio::string_message::create("storm");
+		fields["cleared"] = sio::int_message::create(-1);
+		fields["final"] = sio::int_message::create(-1);
+		fields["coordinated"] = sio::int_message::create(-1);
+		fields["reported"] = sio::string_message::create("");
+	}
+	else if (eventName == "HANDOFF_TARGET")
+	{
+		fields["cjs"] = sio::string_message::create("");
+	}
+	else if (eventName == "UPDATE_SQUAWK")
+	{
+		fields["prefix"] = sio::string_message::create("02");
+	}
+	else if (eventName == "UPDATE_SCRATCHPAD" || eventName == "UPDATE_DEPARTURE_TIME" || eventName == "UPDATE_ROUTE" || eventName == "SEND_PDC")
+	{
+		fields["value"] = sio::string_message::create("");
+	}
+	else if (eventName == "UPDATE_TIME")
+	{
+		fields["time"] = sio::string_message::create("");
+	}
+	else if (eventName == "UPDATE_SPEED")
+	{
+		fields["id"] = sio::string_message::create("storm");
+		fields["assignedMach"] = sio::int_message::create(0);
+		fields["assignedSpeed"] = sio::int_message::create(0);
+		fields["filedSpeed"] = sio::int_message::create(0);
+		fields["ifrString"] = sio::string_message::create("");
+	}
+	else if (eventName == "UPDATE_STATUS")
+	{
+		fields["status"] = sio::string_message::create("");
+		fields["departure_time"] = sio::string_message::create("");
+	}
+	else if (eventName == "UPDATE_TRACKING_STATUS")
+	{
+		fields["assumed"] = sio::bool_message::create(true);
+	}
+	else if (eventName == "UPDATE_DIRECT")
+	{
+		fields["altitude"] = sio::int_message::create(0);
+		fields["new_destination"] = sio::string_message::create("");
+		fields["route"] = sio::string_message::create("");
+	}
+	else if (eventName == "CORRELATE_TARGET")
+	{
+		fields["id"] = sio::string_message::create("");
+	}
+	else if (eventName == "UPDATE_POSITIONS")
+	{
+		// The positions are shared by every aircraft, any default would replace the ones EXCDS set
+		return nullptr;
+	}
+	else if (eventName == "UPDATE_FLIGHT_PLAN" || eventName == "NEW_FLIGHT_PLAN")
+	{
+		fields["aircraft_type"] = sio::string_message::create("A320");
+		fields["type"] = sio::string_message::create("A320");
+		fields["altitude"] = sio::int_message::create(35000);
+		fields["alt"] = sio::int_message::create(35000);
+		fields["origin"] = sio::string_message::create("CYUL");
+		fields["destination"] = sio::string_message::create("CYYZ");
+		fields["dest"] = sio::string_message::create("CYYZ");
+		fields["route"] = sio::string_message::create("DCT");
+		fields["remarks"] = sio::string_message::create("");
+		fields["scratchpad"] = sio::string_message::create("");
+		fields["flight_rules"] = sio::string_message::create("I");
+		fields["fpType"] = sio::string_message::create("I");
+		fields["etd"] = sio::string_message::create("");
+		fields["etehours"] = sio::string_message::create("1");
+		fields["eteminutes"] = sio::string_message::create("0");
+		fields["speed"] = sio::int_message::create(450);
+	}
+
+	return payload;
+}
+
+LoopbackSocket* LoopbackSocket::GetInstance()
+{
+	static LoopbackSocket loopback;
+	return &loopback;
+}
+
+LoopbackSocket::~LoopbackSocket()
+{
+	StopStorm();
+}
+
+void LoopbackSocket::StartCapture()
+{
+	std::lock_guard<std::mutex> guard(_captureLock);
+
+	_captured.clear();
+	_emitTotals.clear();
+	_captureStart = std::chrono::steady_clock::now();
+	_capturing = true;
+}
+
+void LoopbackSocket::StopCapture()
+{
+	_capturing = false;
+}
+
+void LoopbackSocket::OnEmit(const std::string& eventName, size_t bytes)
+{
+	if (!IsCapturing()) return;
+
+	std::lock_guard<std::mutex> guard(_captureLock);
+
+	CapturedEmit emit;
+	emit.time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - _captureStart).count();
+	emit.eventName = eventName;
+	emit.bytes = bytes;
+
+	_captured.push_back(emit);
+	if (_captured.size() > MAX_CAPTURED)
+		_captured.pop_front();
+
+	EmitTotals& totals = _emitTotals[eventName];
+	totals.count++;
+	totals.bytes += bytes;
+}
+
+bool LoopbackSocket::StartStorm(const StormScript& script)
+{
+	std::lock_guard<std::mutex> guard(_stormLock);
+
+	if (_stormRunning || script.commands.empty() || script.callsigns.empty()) return false;
+
+	if (_thread.joinable())
+		_thread.join();
+
+	{
+		std::lock_guard<std::mutex> statsGuard(_statsLock);
+		_stats.clear();
+		_totalLatency.Reset();
+	}
+
+	_stopRequested = false;
+	_stormRunning = true;
+	_stormElapsedMs = 0;
+	_thread = std::thread(&LoopbackSocket::RunStorm, this, script);
+
+	return true;
+}
+
+void LoopbackSocket::StopStorm()
+{
+	_stopRequested = true;
+	WaitForStorm();
+}
+
+void LoopbackSocket::WaitForStorm()
+{
+	std::lock_guard<std::mutex> guard(_stormLock);
+
+	if (_thread.joinable())
+		_thread.join();
+}
+
+LoopbackSocket::CommandStats& LoopbackSocket::GetStats(const std::string& eventName)
+{
+	std::lock_guard<std::mutex> guard(_statsLock);
+
+	std::unique_ptr<CommandStats>& stats = _stats[eventName];
+	if (!stats) stats.reset(new CommandStats());
+
+	return *stats;
+}
+
+void LoopbackSocket::RunStorm(StormScript script)
+{
+	std::vector<CommandStats*> stats;
+	std::vector<double> due;
+
+	for (const auto& command : script.commands)
+	{
+		stats.push_back(&GetStats(command.eventName));
+		due.push_back(0);
+	}
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	long long duration = static_cast<long long>(script.duration * 1000000);
+	size_t nextCallsign = 0;
+
+	while (!_stopRequested)
+	{
+		// The command that is due first goes next
+		size_t index = 0;
+		for (size_t i = 1; i < due.size(); i++)
+		{
+			if (due[i] < due[index])
+				index = i;
+		}
+
+		if (due[index] >= duration) break;
+
+		std::chrono::steady_clock::time_point scheduled = start + std::chrono::microseconds(static_cast<long long>(due[index]));
+
+		while (!_stopRequested && std::chrono::steady_clock::now() < scheduled)
+		{
+			std::chrono::steady_clock::duration remaining = scheduled - std::chrono::steady_clock::now();
+			std::this_thread::sleep_for(remaining < MAX_SLEEP ? remaining : std::chrono::steady_clock::duration(MAX_SLEEP));
+		}
+
+		if (_stopRequested) break;
+
+		const StormCommand& command = script.commands[index];
+
+		// Handlers may add keys to the payload, so every command gets its own copy
+		sio::message::ptr payload = sio::object_message::create();
+		payload->get_map() = command.payload->get_map();
+		payload->get_map()["callsign"] = sio::string_message::create(script.callsigns[nextCallsign++ % script.callsigns.size()]);
+
+		LocalEvent event(command.eventName, payload);
+		bool handled = false;
+
+		try {
+			handled = CEXCDSBridge::DispatchLocalEvent(event);
+		}
+		catch (...) {
+			Metrics::CountException("LoopbackSocket", "EXCDS Error: Storm command failed");
+		}
+
+		uint64_t latency = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - scheduled).count();
+
+		stats[index]->sent++;
+		if (handled && event.get_ack_message().size() > 0)
+		{
+			stats[index]->acked++;
+			stats[index]->latency.Record(latency);
+			_totalLatency.Record(latency);
+		}
+		else
+		{
+			stats[index]->lost++;
+		}
+
+		due[index] += 1000000 / command.rate;
+		_stormElapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	_stormRunning = false;
+}
+
+sio::message::ptr LoopbackSocket::Summarize(const LatencyHistogram& histogram)
+{
+	sio::message::ptr summary = sio::object_message::create();
+
+	summary->get_map()["count"] = sio::int_message::create(histogram.GetCount());
+	summary->get_map()["mean_us"] = sio::double_message::create(histogram.GetMean());
+	summary->get_map()["p50_us"] = sio::int_message::create(histogram.GetPercentile(50));
+	summary->get_map()["p90_us"] = sio::int_message::create(histogram.GetPercentile(90));
+	summary->get_map()["p99_us"] = sio::int_message::create(histogram.GetPercentile(99));
+	summary->get_map()["p999_us"] = sio::int_message::create(histogram.GetPercentile(99.9));
+	summary->get_map()["max_us"] = sio::int_message::create(histogram.GetMax());
+
+	return summary;
+}
+
+StormTotals LoopbackSocket::GetTotals()
+{
+	StormTotals totals;
+
+	{
+		std::lock_guard<std::mutex> guard(_statsLock);
+
+		for (const auto& stats : _stats)
+		{
+			totals.sent += stats.second->sent;
+			totals.acked += stats.second->acked;
+			totals.lost += stats.second->lost;
+		}
+	}
+
+	totals.elapsedMs = _stormElapsedMs;
+	totals.p50 = _totalLatency.GetPercentile(50);
+	totals.p99 = _totalLatency.GetPercentile(99);
+	totals.p999 = _totalLatency.GetPercentile(99.9);
+	totals.max = _totalLatency.GetMax();
+
+	return totals;
+}
+
+sio::message::ptr LoopbackSocket::GetReport()
+{
+	sio::message::ptr report = sio::object_message::create();
+	sio::message::ptr commands = sio::object_message::create();
+
+	unsigned long long sent = 0;
+	unsigned long long acked = 0;
+	unsigned long long lost = 0;
+
+	{
+		std::lock_guard<std::mutex> guard(_statsLock);
+
+		for (const auto& stats : _stats)
+		{
+			sio::message::ptr msg = Summarize(stats.second->latency);
+			msg->get_map()["sent"] = sio::int_message::create(stats.second->sent);
+			msg->get_map()["acked"] = sio::int_message::create(stats.second->acked);
+			msg->get_map()["lost"] = sio::int_message::create(stats.second->lost);
+
+			commands->get_map()[stats.first] = msg;
+
+			sent += stats.second->sent;
+			acked += stats.second->acked;
+			lost += stats.second->lost;
+		}
+	}
+
+	long long elapsedMs = _stormElapsedMs;
+
+	report->get_map()["running"] = sio::bool_message::create(_stormRunning);
+	report->get_map()["elapsed_ms"] = sio::int_message::create(elapsedMs);
+	report->get_map()["sent"] = sio::int_message::create(sent);
+	report->get_map()["acked"] = sio::int_message::create(acked);
+	report->get_map()["lost"] = sio::int_message::create(lost);
+	report->get_map()["commands_per_second"] = sio::double_message::create(elapsedMs > 0 ? sent * 1000.0 / elapsedMs : 0);
+	report->get_map()["latency"] = Summarize(_totalLatency);
+	report->get_map()["commands"] = commands;
+
+	sio::message::ptr emitted = sio::object_message::create();
+	sio::message::ptr recent = sio::array_message::create();
+
+	{
+		std::lock_guard<std::mutex> guard(_captureLock);
+
+		for (const auto& totals : _emitTotals)
+		{
+			sio::message::ptr msg = sio::object_message::create();
+			msg->get_map()["count"] = sio::int_message::create(totals.second.count);
+			msg->get_map()["bytes"] = sio::int_message::create(totals.second.bytes);
+
+			emitted->get_map()[totals.first] = msg;
+		}
+
+		size_t first = _captured.size() > REPORTED_EMITS ? _captured.size() - REPORTED_EMITS : 0;
+		for (size_t i = first; i < _captured.size(); i++)
+		{
+			sio::message::ptr msg = sio::object_message::create();
+			msg->get_map()["t_us"] = sio::int_message::create(_captured[i].time);
+			msg->get_map()["event"] = sio::string_message::create(_captured[i].eventName);
+			msg->get_map()["bytes"] = sio::int_message::create(_captured[i].bytes);
+
+			recent->get_vector().push_back(msg);
+		}
+	}
+
+	report->get_map()["emitted"] = emitted;
+	report->get_map()["recent_emits"] = recent;
+
+	return report;
+}
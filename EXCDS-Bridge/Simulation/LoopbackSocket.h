@@ -0,0 +1,154 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sio_client.h>
+
+#include "../Diagnostics/LatencyHistogram.h"
+#include "../Events/LocalEvent.h"
+
+/**
+* One command in a storm: the event, how many per second to send, and the payload to send it with. The callsign
+* is filled in for every command from the storm's callsign list.
+*/
+struct StormCommand
+{
+    std::string eventName;
+    double rate = 10;
+    sio::message::ptr payload;
+};
+
+struct StormScript
+{
+    std::vector<StormCommand> commands;
+    std::vector<std::string> callsigns;
+
+    /**
+    * Seconds to run for
+    */
+    double duration = 10;
+
+    /**
+    * Reads a script from a START_LOOPBACK_STORM payload:
+    * { "duration": 10, "callsigns": [...], "commands": [{ "event": "UPDATE_ALTITUDE", "rate": 50, "payload": {...} }] }
+    * Commands without a payload get a default with every field the handler reads, leaving the flight plan as it is
+    * wherever the handler allows it. UPDATE_POSITIONS has no default, as any payload replaces the estimate positions
+    * for everyone, so it is left out unless a payload is given. Without commands, the storm runs the read only requests.
+    */
+    static StormScript FromMessage(const sio::message::ptr& message);
+    /**
+    * nullptr for a command that cannot be run safely without a payload of its own
+    */
+    static sio::message::ptr DefaultPayload(const std::string& eventName);
+
+    /**
+    * Whether the handler only reads from EuroScope. Anything else, even with a default payload, can change flight
+    * plans or allocate squawks, and is only stormed against an explicit list of callsigns.
+    */
+    static bool IsReadOnly(const std::string& eventName);
+    bool IsReadOnly() const;
+};
+
+/**
+* Totals of the current or last storm, latencies in microseconds.
+*/
+struct StormTotals
+{
+    unsigned long long sent = 0;
+    unsigned long long acked = 0;
+    unsigned long long lost = 0;
+    long long elapsedMs = 0;
+
+    uint64_t p50 = 0;
+    uint64_t p99 = 0;
+    uint64_t p999 = 0;
+    uint64_t max = 0;
+};
+
+/**
+* Stand-in for the EXCDS end of the socket, embedded in the bridge so the socket side can be tested without EXCDS.
+*
+* While capturing, every event the bridge emits is recorded with its time and size. A storm fires scripted commands
+* straight into the handlers registered in bind_events at fixed rates from its own thread, and measures how long
+* each one took to be acknowledged, counted from when it was due to be sent so that queueing shows up as latency.
+* Commands that return without an ack are counted as lost.
+*/
+class LoopbackSocket
+{
+public:
+    static LoopbackSocket* GetInstance();
+
+    ~LoopbackSocket();
+
+    void StartCapture();
+    void StopCapture();
+    bool IsCapturing() const { return _capturing.load(std::memory_order_relaxed); }
+
+    /**
+    * Called by CEXCDSBridge::Emit for every event sent to EXCDS.
+    */
+    void OnEmit(const std::string& eventName, size_t bytes);
+
+    bool StartStorm(const StormScript& script);
+    void StopStorm();
+    bool IsStormRunning() const { return _stormRunning.load(); }
+
+    /**
+    * Blocks until the current storm finishes.
+    */
+    void WaitForStorm();
+
+    sio::message::ptr GetReport();
+    StormTotals GetTotals();
+private:
+    static const size_t MAX_CAPTURED = 4096;
+
+    struct CapturedEmit
+    {
+        long long time;
+        std::string eventName;
+        size_t bytes;
+    };
+
+    struct EmitTotals
+    {
+        unsigned long long count = 0;
+        unsigned long long bytes = 0;
+    };
+
+    struct CommandStats
+    {
+        // Written by the storm thread while reports read them
+        std::atomic<unsigned long long> sent{ 0 };
+        std::atomic<unsigned long long> acked{ 0 };
+        std::atomic<unsigned long long> lost{ 0 };
+        LatencyHistogram latency;
+    };
+
+    void RunStorm(StormScript script);
+    CommandStats& GetStats(const std::string& eventName);
+    static sio::message::ptr Summarize(const LatencyHistogram& histogram);
+
+    std::chrono::steady_clock::time_point _captureStart;
+    std::atomic<bool> _capturing{ false };
+    std::mutex _captureLock;
+    std::deque<CapturedEmit> _captured;
+    std::map<std::string, EmitTotals> _emitTotals;
+
+    std::mutex _stormLock;
+    std::thread _thread;
+    std::atomic<bool> _stormRunning{ false };
+    std::atomic<bool> _stopRequested{ false };
+    std::atomic<long long> _stormElapsedMs{ 0 };
+
+    std::mutex _statsLock;
+    std::map<std::string, std::unique_ptr<CommandStats>> _stats;
+    LatencyHistogram _totalLatency;
+};
@@ -0,0 +1,420 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+#include "TrafficGenerator.h"
+#include "../CEXCDSBridge.h"
+#include "../Diagnostics/Metrics.h"
+
+static const double PI = 3.14159265358979323846;
+
+// Longest single sleep, so a stop request is picked up quickly
+static const std::chrono::milliseconds MAX_SLEEP(100);
+
+// Aircraft leave the cruise altitude to arrive at this altitude over the destination
+static const int ARRIVAL_ALTITUDE = 2000;
+
+static const char* AIRPORTS[] = { "CYUL", "CYOW", "CYYZ", "CYQB", "CYHU", "CYMX", "KBOS", "KJFK", "KBTV", "CYHZ" };
+
+static double ReadNumber(const std::map<std::string, sio::message::ptr>& payload, const char* key, double fallback)
+{
+	auto value = payload.find(key);
+	if (value == payload.end() || !value->second) return fallback;
+
+	if (value->second->get_flag() == sio::message::flag_integer || value->second->get_flag() == sio::message::flag_double)
+		return value->second->get_double();
+
+	return fallback;
+}
+
+TrafficProfile TrafficProfile::FromMessage(const sio::message::ptr& message)
+{
+	TrafficProfile profile;
+	if (!message || message->get_flag() != sio::message::flag_object) return profile;
+
+	const std::map<std::string, sio::message::ptr>& payload = message->get_map();
+
+	double aircraft = ReadNumber(payload, "aircraft", profile.aircraft);
+	profile.aircraft = static_cast<int>(std::max(0.0, std::min(aircraft, static_cast<double>(TrafficProfile::MAX_AIRCRAFT))));
+	profile.minRouteLength = ReadNumber(payload, "min_route_length", profile.minRouteLength);
+	profile.maxRouteLength = ReadNumber(payload, "max_route_length", profile.maxRouteLength);
+	profile.ifrFraction = ReadNumber(payload, "ifr_fraction", profile.ifrFraction);
+	profile.trackedFraction = ReadNumber(payload, "tracked_fraction", profile.trackedFraction);
+	profile.handoffFraction = ReadNumber(payload, "handoff_fraction", profile.handoffFraction);
+	profile.minCruiseAltitude = static_cast<int>(ReadNumber(payload, "min_cruise_altitude", profile.minCruiseAltitude));
+	profile.maxCruiseAltitude = static_cast<int>(ReadNumber(payload, "max_cruise_altitude", profile.maxCruiseAltitude));
+	profile.centerLatitude = ReadNumber(payload, "lat", profile.centerLatitude);
+	profile.centerLongitude = ReadNumber(payload, "lon", profile.centerLongitude);
+	profile.radius = ReadNumber(payload, "radius", profile.radius);
+	profile.speed = ReadNumber(payload, "speed", profile.speed);
+	profile.sweepSeconds = static_cast<int>(ReadNumber(payload, "sweep_seconds", profile.sweepSeconds));
+	profile.duration = static_cast<int>(ReadNumber(payload, "duration", profile.duration));
+	profile.seed = static_cast<unsigned int>(ReadNumber(payload, "seed", profile.seed));
+
+	if (profile.sweepSeconds < 1) profile.sweepSeconds = 1;
+	if (profile.maxRouteLength < profile.minRouteLength) profile.maxRouteLength = profile.minRouteLength;
+	if (profile.maxCruiseAltitude < profile.minCruiseAltitude) profile.maxCruiseAltitude = profile.minCruiseAltitude;
+
+	return profile;
+}
+
+TrafficGenerator* TrafficGenerator::GetInstance()
+{
+	static TrafficGenerator generator;
+	return &generator;
+}
+
+TrafficGenerator::~TrafficGenerator()
+{
+	Stop();
+}
+
+bool TrafficGenerator::Start(const TrafficProfile& profile)
+{
+	std::lock_guard<std::mutex> guard(_lock);
+
+	if (_running) return false;
+
+	if (_thread.joinable())
+		_thread.join();
+
+	_stopRequested = false;
+	_running = true;
+	_simulatedSeconds = 0;
+	_updates = 0;
+	_elapsedMs = 0;
+	_thread = std::thread(&TrafficGenerator::Run, this, profile);
+
+	return true;
+}
+
+void TrafficGenerator::Stop()
+{
+	std::lock_guard<std::mutex> guard(_lock);
+
+	_stopRequested = true;
+	if (_thread.joinable())
+		_thread.join();
+}
+
+sio::message::ptr TrafficGenerator::GetSummary()
+{
+	sio::message::ptr summary = sio::object_message::create();
+
+	long long elapsedMs = _elapsedMs;
+	unsigned long long updates = _updates;
+
+	summary->get_map()["running"] = sio::bool_message::create(_running);
+	summary->get_map()["simulated_seconds"] = sio::int_message::create(_simulatedSeconds);
+	summary->get_map()["updates"] = sio::int_message::create(updates);
+	summary->get_map()["elapsed_ms"] = sio::int_message::create(elapsedMs);
+	summary->get_map()["updates_per_second"] = sio::double_message::create(elapsedMs > 0 ? updates * 1000.0 / elapsedMs : 0);
+
+	return summary;
+}
+
+void TrafficGenerator::Run(TrafficProfile profile)
+{
+	MetricCounter& published = Metrics::GetInstance()->Counter("synthetic.updates");
+	MetricHistogram& sweepTime = Metrics::GetInstance()->Histogram("synthetic.sweep_us");
+
+	std::mt19937 random(profile.seed);
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	try {
+		std::vector<Aircraft> traffic(profile.aircraft);
+
+		for (int i = 0; i < profile.aircraft; i++)
+		{
+			Spawn(traffic[i], i, profile, random);
+
+			// Spread the first aircraft over the whole flight so every phase is present from the start
+			std::uniform_real_distribution<double> progress(0, 1);
+			double flown = progress(random) * traffic[i].routeLength;
+			while (flown > 0 && traffic[i].remaining > 1)
+			{
+				Advance(traffic[i], 60);
+				flown -= traffic[i].groundSpeed / 60.0;
+			}
+
+			CEXCDSBridge::PublishFlightPlan(BuildFlightPlanMessage(traffic[i]), true);
+		}
+
+		long long simulated = 0;
+
+		// Samples are stamped with the simulated time, so the filters see sweeps the right distance apart at any speed
+		double simulatedStart = RadarSample::Now();
+
+		while (!_stopRequested && (profile.duration == 0 || simulated < profile.duration))
+		{
+			{
+				MetricTimer timer(sweepTime);
+
+				for (int i = 0; i < profile.aircraft; i++)
+				{
+					Aircraft& aircraft = traffic[i];
+					Advance(aircraft, profile.sweepSeconds);
+
+					if (aircraft.remaining <= 0)
+					{
+						CEXCDSBridge::PublishDisconnect(aircraft.callsign);
+						Spawn(aircraft, i, profile, random);
+						CEXCDSBridge::PublishFlightPlan(BuildFlightPlanMessage(aircraft), true);
+					}
+
+					CEXCDSBridge::PublishRadarTarget(ToSample(aircraft, simulatedStart + simulated + profile.sweepSeconds), BuildRadarMessage(aircraft));
+				}
+			}
+
+			simulated += profile.sweepSeconds;
+
+			_simulatedSeconds = simulated;
+			_updates += profile.aircraft;
+			published.Increment(profile.aircraft);
+			_elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+			if (profile.speed > 0)
+			{
+				std::chrono::steady_clock::time_point due = start + std::chrono::microseconds(static_cast<long long>(simulated * 1000000 / profile.speed));
+
+				while (!_stopRequested && std::chrono::steady_clock::now() < due)
+				{
+					std::chrono::steady_clock::duration remaining = due - std::chrono::steady_clock::now();
+					std::this_thread::sleep_for(remaining < MAX_SLEEP ? remaining : std::chrono::steady_clock::duration(MAX_SLEEP));
+				}
+			}
+		}
+
+		// The generated flight plans are in the traffic and squawk indexes, and must not outlive the run
+		for (const Aircraft& aircraft : traffic)
+			CEXCDSBridge::PublishDisconnect(aircraft.callsign);
+	}
+	catch (...) {
+		Metrics::CountException("TrafficGenerator", "EXCDS Error: Synthetic traffic generator failed");
+	}
+
+	_elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+	_running = false;
+}
+
+void TrafficGenerator::Spawn(Aircraft& aircraft, int index, const TrafficProfile& profile, std::mt19937& random)
+{
+	std::uniform_real_distribution<double> unit(0, 1);
+	std::uniform_real_distribution<double> routeLength(profile.minRouteLength, profile.maxRouteLength);
+	std::uniform_int_distribution<int> airport(0, sizeof(AIRPORTS) / sizeof(AIRPORTS[0]) - 1);
+
+	char buf[16];
+
+	aircraft = Aircraft();
+	aircraft.ifr = unit(random) < profile.ifrFraction;
+
+	snprintf(buf, sizeof(buf), "%s%04d", aircraft.ifr ? "SYN" : "CSY", index);
+	aircraft.callsign = buf;
+	snprintf(buf, sizeof(buf), "SYN%d", index);
+	aircraft.systemId = buf;
+
+	if (aircraft.ifr)
+	{
+		// Discrete codes, in octal
+		snprintf(buf, sizeof(buf), "%04o", 01001 + index % 03000);
+		aircraft.squawk = buf;
+
+		aircraft.tracked = unit(random) < profile.trackedFraction;
+		aircraft.handoff = aircraft.tracked && unit(random) < profile.handoffFraction;
+
+		std::uniform_int_distribution<int> flightLevel(profile.minCruiseAltitude / 1000, profile.maxCruiseAltitude / 1000);
+		aircraft.cruiseAltitude = flightLevel(random) * 1000;
+		aircraft.cruiseSpeed = 380 + static_cast<int>(unit(random) * 100);
+	}
+	else
+	{
+		aircraft.squawk = "1200";
+
+		std::uniform_int_distribution<int> altitude(3, 9);
+		aircraft.cruiseAltitude = altitude(random) * 1000 + 500;
+		aircraft.cruiseSpeed = 100 + static_cast<int>(unit(random) * 40);
+	}
+
+	aircraft.origin = AIRPORTS[airport(random)];
+	aircraft.destination = AIRPORTS[airport(random)];
+
+	// Anywhere inside the circle, not bunched up in the middle
+	double bearing = unit(random) * 2 * PI;
+	double distance = profile.radius * sqrt(unit(random));
+
+	aircraft.latitude = profile.centerLatitude + distance * cos(bearing) / 60;
+	aircraft.longitude = profile.centerLongitude + distance * sin(bearing) / (60 * cos(profile.centerLatitude * PI / 180));
+	aircraft.track = unit(random) * 360;
+
+	aircraft.phase = PHASE_CLIMB;
+	aircraft.altitude = ARRIVAL_ALTITUDE;
+	aircraft.groundSpeed = aircraft.ifr ? 180 : aircraft.cruiseSpeed;
+	aircraft.routeLength = routeLength(random);
+	aircraft.remaining = aircraft.routeLength;
+}
+
+void TrafficGenerator::Advance(Aircraft& aircraft, double seconds)
+{
+	// 3 miles for every thousand feet to lose
+	double descentDistance = (aircraft.altitude - ARRIVAL_ALTITUDE) * 3 / 1000;
+
+	if (aircraft.phase != PHASE_DESCENT && aircraft.remaining <= descentDistance)
+		aircraft.phase = PHASE_DESCENT;
+
+	switch (aircraft.phase)
+	{
+	case PHASE_CLIMB:
+		aircraft.verticalSpeed = aircraft.ifr ? 2000 : 700;
+		aircraft.altitude += aircraft.verticalSpeed * seconds / 60;
+
+		if (aircraft.altitude >= aircraft.cruiseAltitude)
+		{
+			aircraft.altitude = aircraft.cruiseAltitude;
+			aircraft.phase = PHASE_CRUISE;
+		}
+		break;
+	case PHASE_CRUISE:
+		aircraft.verticalSpeed = 0;
+		break;
+	case PHASE_DESCENT:
+		// Arrive at the bottom of the descent over the destination
+		aircraft.verticalSpeed = aircraft.remaining > 0
+			? -static_cast<int>((aircraft.altitude - ARRIVAL_ALTITUDE) / (aircraft.remaining / aircraft.groundSpeed * 60))
+			: 0;
+		aircraft.altitude += aircraft.verticalSpeed * seconds / 60;
+
+		if (aircraft.altitude < ARRIVAL_ALTITUDE)
+			aircraft.altitude = ARRIVAL_ALTITUDE;
+		break;
+	}
+
+	// Accelerate with altitude, slow down in the descent
+	if (aircraft.ifr)
+	{
+		double climb = aircraft.cruiseAltitude > ARRIVAL_ALTITUDE ? aircraft.cruiseAltitude - ARRIVAL_ALTITUDE : 1;
+		double fraction = (aircraft.altitude - ARRIVAL_ALTITUDE) / climb;
+		aircraft.groundSpeed = 180 + static_cast<int>((aircraft.cruiseSpeed - 180) * fraction);
+	}
+
+	double distance = aircraft.groundSpeed * seconds / 3600;
+
+	aircraft.latitude += distance * cos(aircraft.track * PI / 180) / 60;
+	aircraft.longitude += distance * sin(aircraft.track * PI / 180) / (60 * cos(aircraft.latitude * PI / 180));
+	aircraft.remaining -= distance;
+}
+
+RadarSample TrafficGenerator::ToSample(const Aircraft& aircraft, double time)
+{
+	RadarSample sample;
+
+	sample.callsign = aircraft.callsign;
+	sample.systemId = aircraft.systemId;
+	sample.squawk = aircraft.squawk;
+	sample.latitude = aircraft.latitude;
+	sample.longitude = aircraft.longitude;
+	sample.altitude = static_cast<int>(aircraft.altitude);
+	sample.groundSpeed = aircraft.groundSpeed;
+	sample.verticalSpeed = aircraft.verticalSpeed;
+	sample.heading = static_cast<int>(aircraft.track);
+	sample.correlated = true;
+	sample.synthetic = true;
+	sample.time = time;
+
+	return sample;
+}
+
+sio::message::ptr TrafficGenerator::BuildRadarMessage(const Aircraft& aircraft)
+{
+	sio::message::ptr response = sio::object_message::create();
+	int modec = (static_cast<int>(aircraft.altitude) + 50) / 100;
+	bool reachedAltitude = aircraft.phase == PHASE_CRUISE;
+
+	response->get_map()["radar"] = sio::object_message::create();
+	response->get_map()["radar"]->get_map()["ssr"] = sio::string_message::create(aircraft.squawk);
+	response->get_map()["radar"]->get_map()["altitude"] = sio::int_message::create(modec);
+	response->get_map()["radar"]->get_map()["vertical_speed"] = sio::int_message::create(aircraft.verticalSpeed);
+	response->get_map()["radar"]->get_map()["ground_speed"] = sio::int_message::create(aircraft.groundSpeed);
+	response->get_map()["radar"]->get_map()["pps"] = sio::int_message::create(aircraft.ifr ? 1 : 11);
+	response->get_map()["radar"]->get_map()["radar_flags"] = sio::int_message::create(3);
+	response->get_map()["radar"]->get_map()["track"] = sio::int_message::create(static_cast<int>(aircraft.track));
+
+	response->get_map()["position"] = sio::object_message::create();
+	response->get_map()["position"]->get_map()["lat"] = sio::double_message::create(aircraft.latitude);
+	response->get_map()["position"]->get_map()["long"] = sio::double_message::create(aircraft.longitude);
+
+	int trackingState = EuroScopePlugIn::FLIGHT_PLAN_STATE_NON_CONCERNED;
+	if (aircraft.handoff)
+		trackingState = EuroScopePlugIn::FLIGHT_PLAN_STATE_TRANSFER_FROM_ME_INITIATED;
+	else if (aircraft.tracked)
+		trackingState = EuroScopePlugIn::FLIGHT_PLAN_STATE_ASSUMED;
+
+	response->get_map()["internal"] = sio::object_message::create();
+	response->get_map()["internal"]->get_map()["reported_gs"] = sio::int_message::create(aircraft.groundSpeed);
+	response->get_map()["internal"]->get_map()["controller_tracking_state"] = sio::int_message::create(trackingState);
+	response->get_map()["internal"]->get_map()["assignedSquawk"] = sio::string_message::create(aircraft.squawk);
+	response->get_map()["internal"]->get_map()["eta"] = sio::int_message::create(static_cast<int>(aircraft.remaining * 60 / aircraft.groundSpeed));
+
+	response->get_map()["mods"] = sio::object_message::create();
+	response->get_map()["mods"]->get_map()["reached_altitude"] = sio::bool_message::create(reachedAltitude);
+	response->get_map()["mods"]->get_map()["blink"] = sio::bool_message::create(aircraft.handoff);
+	response->get_map()["mods"]->get_map()["vfr"] = sio::bool_message::create(!aircraft.ifr);
+	response->get_map()["mods"]->get_map()["correlated"] = sio::bool_message::create(true);
+	response->get_map()["mods"]->get_map()["trackedByMe"] = sio::bool_message::create(aircraft.tracked);
+
+	response->get_map()["general"] = sio::object_message::create();
+	response->get_map()["general"]->get_map()["callsign"] = sio::string_message::create(aircraft.callsign);
+	response->get_map()["general"]->get_map()["handoff_cjs"] = sio::string_message::create(aircraft.handoff ? "SYN" : "");
+	response->get_map()["general"]->get_map()["ac_type"] = sio::string_message::create(aircraft.ifr ? "A320" : "C172");
+	response->get_map()["general"]->get_map()["destination"] = sio::string_message::create(aircraft.destination);
+	response->get_map()["general"]->get_map()["origin"] = sio::string_message::create(aircraft.origin);
+	response->get_map()["general"]->get_map()["distance"] = sio::int_message::create(static_cast<int>(aircraft.remaining));
+
+	response->get_map()["altitude"] = sio::object_message::create();
+	response->get_map()["altitude"]->get_map()["cleared"] = sio::string_message::create("C" + std::to_string(aircraft.cruiseAltitude / 100));
+	response->get_map()["altitude"]->get_map()["filed"] = sio::int_message::create(aircraft.cruiseAltitude / 100);
+
+	response->get_map()["points"] = sio::array_message::create();
+
+	response->get_map()["id"] = sio::string_message::create(aircraft.systemId);
+
+	return response;
+}
+
+sio::message::ptr TrafficGenerator::BuildFlightPlanMessage(const Aircraft& aircraft)
+{
+	sio::message::ptr response = sio::object_message::create();
+
+	response->get_map()["callsign"] = sio::string_message::create(aircraft.callsign);
+	response->get_map()["flight_plan_state"] = sio::int_message::create(aircraft.tracked ? EuroScopePlugIn::FLIGHT_PLAN_STATE_ASSUMED : EuroScopePlugIn::FLIGHT_PLAN_STATE_NON_CONCERNED);
+
+	response->get_map()["aircraft"] = sio::object_message::create();
+	response->get_map()["aircraft"]->get_map()["icao"] = sio::string_message::create(aircraft.ifr ? "A320" : "C172");
+	response->get_map()["aircraft"]->get_map()["wtcat"] = sio::string_message::create(aircraft.ifr ? "M" : "L");
+
+	response->get_map()["altitude"] = sio::object_message::create();
+	response->get_map()["altitude"]->get_map()["final"] = sio::int_message::create(aircraft.cruiseAltitude);
+
+	// Laid out as MessageHandler::PrepareFlightPlanDataResponse does, so the traffic index can read it
+	response->get_map()["route"] = sio::object_message::create();
+	response->get_map()["route"]->get_map()["departure"] = sio::object_message::create();
+	response->get_map()["route"]->get_map()["departure"]->get_map()["code"] = sio::string_message::create(aircraft.origin);
+	response->get_map()["route"]->get_map()["destination"] = sio::object_message::create();
+	response->get_map()["route"]->get_map()["destination"]->get_map()["code"] = sio::string_message::create(aircraft.destination);
+	response->get_map()["route"]->get_map()["text"] = sio::string_message::create("DCT");
+
+	response->get_map()["controllerData"] = sio::object_message::create();
+	response->get_map()["controllerData"]->get_map()["squawk"] = sio::string_message::create(aircraft.squawk);
+	response->get_map()["controllerData"]->get_map()["tracking_controller"] = sio::string_message::create(aircraft.tracked ? "SYN" : "");
+	response->get_map()["controllerData"]->get_map()["ground_status"] = sio::string_message::create("");
+
+	response->get_map()["fpdata"] = sio::object_message::create();
+	response->get_map()["fpdata"]->get_map()["ifr"] = sio::bool_message::create(aircraft.ifr);
+
+	response->get_map()["speeds"] = sio::object_message::create();
+	response->get_map()["speeds"]->get_map()["abbr"] = sio::int_message::create(aircraft.cruiseSpeed);
+
+	response->get_map()["success"] = sio::bool_message::create(true);
+
+	return response;
+}
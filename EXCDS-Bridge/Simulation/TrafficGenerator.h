@@ -0,0 +1,132 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sio_client.h>
+
+#include "../Surveillance/RadarSample.h"
+
+/**
+* What the traffic generator should create. Distances are in nautical miles, altitudes in feet.
+*/
+struct TrafficProfile
+{
+    /**
+    * Larger requests are cut down to this, every aircraft is a radar update per sweep and its own callsign
+    */
+    static const int MAX_AIRCRAFT = 5000;
+
+    int aircraft = 500;
+
+    double minRouteLength = 50;
+    double maxRouteLength = 800;
+
+    double ifrFraction = 0.8;
+    double trackedFraction = 0.5;
+    double handoffFraction = 0.1;
+
+    int minCruiseAltitude = 18000;
+    int maxCruiseAltitude = 41000;
+
+    // Aircraft start anywhere within this distance of the centre
+    double centerLatitude = 45.47;
+    double centerLongitude = -73.74;
+    double radius = 250;
+
+    /**
+    * Simulated seconds per real second. 0 runs as fast as the bridge can take it.
+    */
+    double speed = 1;
+
+    /**
+    * Simulated seconds between radar sweeps
+    */
+    int sweepSeconds = 5;
+
+    /**
+    * Simulated seconds to run for, 0 runs until stopped
+    */
+    int duration = 0;
+
+    unsigned int seed = 1;
+
+    /**
+    * Reads a profile from a START_SYNTHETIC_TRAFFIC payload. Anything not given keeps its default.
+    */
+    static TrafficProfile FromMessage(const sio::message::ptr& message);
+};
+
+/**
+* Generates synthetic traffic and feeds it through the same path as the live radar, to load the bridge beyond what
+* a real session can.
+*
+* Aircraft climb out, cruise and descend along a straight route and are replaced by a new aircraft when they arrive.
+* The simulation runs on its own thread and every sweep publishes a radar target update per aircraft. Flight plans
+* go through the same path as live ones when an aircraft appears, and every aircraft is disconnected when the run
+* ends.
+*/
+class TrafficGenerator
+{
+public:
+    static TrafficGenerator* GetInstance();
+
+    ~TrafficGenerator();
+
+    bool Start(const TrafficProfile& profile);
+    void Stop();
+    bool IsRunning() const { return _running.load(); }
+
+    /**
+    * Simulated seconds, radar updates published and real seconds taken by the current or last run.
+    */
+    sio::message::ptr GetSummary();
+private:
+    enum Phase { PHASE_CLIMB, PHASE_CRUISE, PHASE_DESCENT };
+
+    struct Aircraft
+    {
+        std::string callsign;
+        std::string systemId;
+        std::string squawk;
+        std::string origin;
+        std::string destination;
+
+        bool ifr = true;
+        bool tracked = false;
+        bool handoff = false;
+
+        Phase phase = PHASE_CLIMB;
+        double latitude = 0;
+        double longitude = 0;
+        double track = 0;
+        double altitude = 0;
+        int cruiseAltitude = 0;
+        int cruiseSpeed = 0;
+        int groundSpeed = 0;
+        int verticalSpeed = 0;
+
+        double routeLength = 0;
+        double remaining = 0;
+    };
+
+    void Run(TrafficProfile profile);
+    void Spawn(Aircraft& aircraft, int index, const TrafficProfile& profile, std::mt19937& random);
+    void Advance(Aircraft& aircraft, double seconds);
+
+    static RadarSample ToSample(const Aircraft& aircraft, double time);
+    static sio::message::ptr BuildRadarMessage(const Aircraft& aircraft);
+    static sio::message::ptr BuildFlightPlanMessage(const Aircraft& aircraft);
+
+    std::mutex _lock;
+    std::thread _thread;
+    std::atomic<bool> _running{ false };
+    std::atomic<bool> _stopRequested{ false };
+
+    std::atomic<long long> _simulatedSeconds{ 0 };
+    std::atomic<unsigned long long> _updates{ 0 };
+    std::atomic<long long> _elapsedMs{ 0 };
+};
@@ -0,0 +1,189 @@
+#include "RadarStream.h"
+#include "../ApiHelper.h"
+#include "../CEXCDSBridge.h"
+
+// Backpressure thresholds for SEND_RT_DATA
+const size_t MAX_OUTSTANDING_FRAMES = 64;
+const size_t MAX_OUTSTANDING_BYTES = 512 * 1024;
+
+// A frame that has not been acknowledged after this long is counted as late
+const std::chrono::seconds FRAME_TIMEOUT(5);
+
+RadarStream* RadarStream::GetInstance()
+{
+	static RadarStream stream;
+	return &stream;
+}
+
+void RadarStream::Push(const std::string& targetId, sio::message::ptr message)
+{
+	std::deque<Frame> ready;
+
+	{
+		std::lock_guard<std::mutex> guard(_lock);
+
+		Frame frame;
+		frame.targetId = targetId;
+		frame.message = message;
+		frame.bytes = ApiHelper::EstimateMessageSize(message);
+
+		auto parked = _parked.find(targetId);
+		if (parked != _parked.end())
+		{
+			// A stale update for this target is still waiting, the new one takes its place in the queue
+			parked->second = std::move(frame);
+			_dropped.Increment();
+			return;
+		}
+
+		if (_parkedOrder.empty() && CanSend())
+		{
+			ready.push_back(std::move(frame));
+		}
+		else
+		{
+			// Wait behind the targets that are already parked
+			_parked[targetId] = std::move(frame);
+			_parkedOrder.push_back(targetId);
+
+			CollectParked(ready);
+		}
+	}
+
+	Send(ready);
+}
+
+void RadarStream::Tick()
+{
+	std::deque<Frame> ready;
+
+	{
+		std::lock_guard<std::mutex> guard(_lock);
+
+		// A late frame still holds its place, it may be sitting in the socket's queue behind a stall
+		auto now = std::chrono::steady_clock::now();
+		for (auto& inFlight : _inFlight)
+		{
+			if (!inFlight.second.late && now - inFlight.second.sentAt > FRAME_TIMEOUT)
+			{
+				inFlight.second.late = true;
+				_late.Increment();
+			}
+		}
+
+		CollectParked(ready);
+	}
+
+	Send(ready);
+}
+
+void RadarStream::Reset()
+{
+	std::lock_guard<std::mutex> guard(_lock);
+
+	_inFlight.clear();
+	_outstandingBytes = 0;
+	_parked.clear();
+	_parkedOrder.clear();
+}
+
+/**
+* Must be called with the lock held.
+*/
+bool RadarStream::CanSend()
+{
+	return _inFlight.size() < MAX_OUTSTANDING_FRAMES && _outstandingBytes < MAX_OUTSTANDING_BYTES;
+}
+
+/**
+* Must be called with the lock held. Moves as many parked frames as the thresholds allow into `out`.
+*/
+void RadarStream::CollectParked(std::deque<Frame>& out)
+{
+	size_t frames = _inFlight.size();
+	size_t bytes = _outstandingBytes;
+
+	while (!_parkedOrder.empty())
+	{
+		if (frames >= MAX_OUTSTANDING_FRAMES || bytes >= MAX_OUTSTANDING_BYTES)
+			break;
+
+		auto parked = _parked.find(_parkedOrder.front());
+		_parkedOrder.pop_front();
+
+		if (parked == _parked.end()) continue;
+
+		frames++;
+		bytes += parked->second.bytes;
+
+		out.push_back(std::move(parked->second));
+		_parked.erase(parked);
+	}
+}
+
+void RadarStream::Send(std::deque<Frame>& frames)
+{
+	for (Frame& frame : frames)
+	{
+		unsigned long long sequence;
+
+		{
+			std::lock_guard<std::mutex> guard(_lock);
+
+			sequence = _nextSequence++;
+
+			InFlight inFlight;
+			inFlight.bytes = frame.bytes;
+			inFlight.sentAt = std::chrono::steady_clock::now();
+
+			_inFlight[sequence] = inFlight;
+			_outstandingBytes += frame.bytes;
+		}
+
+		_bytes.Increment(frame.bytes);
+
+		CEXCDSBridge::Emit("SEND_RT_DATA", frame.message, [this, sequence](sio::message::list const&)
+		{
+			OnAck(sequence);
+		}, frame.bytes);
+	}
+}
+
+void RadarStream::OnAck(unsigned long long sequence)
+{
+	std::deque<Frame> ready;
+
+	{
+		std::lock_guard<std::mutex> guard(_lock);
+
+		auto it = _inFlight.find(sequence);
+		if (it != _inFlight.end())
+		{
+			_outstandingBytes -= it->second.bytes;
+			_inFlight.erase(it);
+		}
+
+		CollectParked(ready);
+	}
+
+	Send(ready);
+}
+
+size_t RadarStream::GetOutstandingFrames()
+{
+	std::lock_guard<std::mutex> guard(_lock);
+	return _inFlight.size();
+}
+
+size_t RadarStream::GetOutstandingBytes()
+{
+	std::lock_guard<std::mutex> guard(_lock);
+	return _outstandingBytes;
+}
+
+size_t RadarStream::GetParkedFrames()
+{
+	std::lock_guard<std::mutex> guard(_lock);
+	return _parked.size();
+}
+
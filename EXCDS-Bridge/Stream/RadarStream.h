@@ -0,0 +1,80 @@
+#pragma once
+
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <sio_client.h>
+
+#include "../Diagnostics/Metrics.h"
+
+/**
+* Flow controlled delivery of SEND_RT_DATA frames.
+*
+* Every frame is emitted with an ack callback and counted as outstanding until EXCDS acknowledges it.
+* While too many frames (or bytes) are outstanding, new updates are parked per target instead of being
+* handed to the socket. A newer update for a parked target replaces the older one, so intermediate sweeps
+* are skipped and the backlog can never grow past one frame per target.
+*
+* The limits hold from the first frame sent, so EXCDS must acknowledge every SEND_RT_DATA frame. A frame that is
+* not acknowledged in time is only counted as late, it stays outstanding as it may still be queued in the socket.
+* Outstanding frames are only forgotten when the socket reconnects.
+*/
+class RadarStream
+{
+public:
+    static RadarStream* GetInstance();
+
+    /**
+    * Queue a radar target update. It is sent straight away unless the socket is backed up.
+    */
+    void Push(const std::string& targetId, sio::message::ptr message);
+
+    /**
+    * Called once a second. Counts frames that are late being acknowledged, then sends parked updates if there is room.
+    */
+    void Tick();
+
+    /**
+    * Forget all in-flight and parked frames, i.e. after the socket reconnected.
+    */
+    void Reset();
+
+    size_t GetOutstandingFrames();
+    size_t GetOutstandingBytes();
+    size_t GetParkedFrames();
+private:
+    struct Frame
+    {
+        std::string targetId;
+        sio::message::ptr message;
+        size_t bytes = 0;
+    };
+
+    struct InFlight
+    {
+        size_t bytes = 0;
+        std::chrono::steady_clock::time_point sentAt;
+        bool late = false;
+    };
+
+    bool CanSend();
+    void Send(std::deque<Frame>& frames);
+    void OnAck(unsigned long long sequence);
+    void CollectParked(std::deque<Frame>& out);
+
+    std::mutex _lock;
+    unsigned long long _nextSequence = 0;
+    size_t _outstandingBytes = 0;
+    std::unordered_map<unsigned long long, InFlight> _inFlight;
+
+    // Latest parked update per target, and the order targets were parked in
+    std::unordered_map<std::string, Frame> _parked;
+    std::deque<std::string> _parkedOrder;
+
+    // Totals for the session, exported as counters
+    MetricCounter& _dropped = Metrics::GetInstance()->Counter("radar.dropped_frames");
+    MetricCounter& _late = Metrics::GetInstance()->Counter("radar.late_frames");
+    MetricCounter& _bytes = Metrics::GetInstance()->Counter("radar.bytes");
+};
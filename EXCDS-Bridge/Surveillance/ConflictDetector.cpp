@@ -0,0 +1,370 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "ConflictDetector.h"
+#include "../CEXCDSBridge.h"
+#include "../Diagnostics/Metrics.h"
+#include "../Diagnostics/Profiler.h"
+
+static const double PI = 3.14159265358979323846;
+static const double NM_PER_DEGREE = 60;
+
+// Targets whose last sample is this many seconds old have gone, even without a disconnect
+static const double STALE_AFTER = 20;
+
+// Emergency symbols are not replaced by the conflict symbol
+static const int PPS_CONFLICT = 5;
+static const int PPS_EMERGENCY = 6;
+static const int PPS_ADSB_EMERGENCY = 18;
+
+/**
+* The key of a grid cell. The row is cast before it is shifted, as it is negative south of the equator.
+*/
+static uint64_t CellKey(long long row, long long column)
+{
+	return (static_cast<uint64_t>(row) << 32) ^ static_cast<uint32_t>(column);
+}
+
+/**
+* Lateral offset of b from a in nautical miles, east and north, on a flat earth around the two.
+*/
+static void Offset(const RadarSample& a, const RadarSample& b, double& east, double& north)
+{
+	double longitude = b.longitude - a.longitude;
+	if (longitude > 180) longitude -= 360;
+	if (longitude < -180) longitude += 360;
+
+	double latitude = (a.latitude + b.latitude) / 2 * PI / 180;
+
+	east = longitude * NM_PER_DEGREE * std::cos(latitude);
+	north = (b.latitude - a.latitude) * NM_PER_DEGREE;
+}
+
+/**
+* Velocity in nautical miles per second, east and north.
+*/
+static void Velocity(const RadarSample& sample, double& east, double& north)
+{
+	double heading = sample.heading * PI / 180;
+
+	east = sample.groundSpeed * std::sin(heading) / 3600;
+	north = sample.groundSpeed * std::cos(heading) / 3600;
+}
+
+/**
+* Moves the sample along its track and vertical speed.
+*/
+static RadarSample Extrapolate(const RadarSample& sample, double seconds)
+{
+	RadarSample moved = sample;
+	double east, north;
+	Velocity(sample, east, north);
+
+	double latitude = sample.latitude * PI / 180;
+	moved.latitude += north * seconds / NM_PER_DEGREE;
+	moved.longitude += east * seconds / (NM_PER_DEGREE * std::max(std::cos(latitude), 0.01));
+	moved.altitude += static_cast<int>(sample.verticalSpeed * seconds / 60);
+
+	return moved;
+}
+
+ConflictDetector* ConflictDetector::GetInstance()
+{
+	static ConflictDetector detector;
+	return &detector;
+}
+
+void ConflictDetector::Update(const RadarSample& sample)
+{
+	if (sample.callsign.empty()) return;
+
+	std::lock_guard<std::mutex> guard(_lock);
+
+	Track& track = _tracks[sample.callsign];
+	track.sample = sample;
+
+	SampleClock& clock = sample.synthetic ? _syntheticClock : _liveClock;
+	if (sample.time >= clock.time)
+	{
+		clock.time = sample.time;
+		clock.seenAt = std::chrono::steady_clock::now();
+	}
+}
+
+/**
+* The newest sample time, moved on by the wall clock since, so tracks still go stale once their source stops.
+*/
+double ConflictDetector::SampleClock::Now(std::chrono::steady_clock::time_point now) const
+{
+	return time + std::chrono::duration<double>(now - seenAt).count();
+}
+
+void ConflictDetector::Remove(const std::string& callsign)
+{
+	std::lock_guard<std::mutex> guard(_lock);
+	_tracks.erase(callsign);
+}
+
+bool ConflictDetector::Predict(const RadarSample& first, const RadarSample& second, const ConflictParameters& parameters, ConflictPrediction& prediction)
+{
+	double dx, dy, ax, ay, bx, by;
+	Offset(first, second, dx, dy);
+	Velocity(first, ax, ay);
+	Velocity(second, bx, by);
+
+	double vx = bx - ax;
+	double vy = by - ay;
+	double dz = second.altitude - first.altitude;
+	double vz = (second.verticalSpeed - first.verticalSpeed) / 60.0;
+
+	double start = 0;
+	double end = parameters.lookAhead;
+
+	// When the lateral distance is inside the minimum: |d + vt|^2 < L^2
+	double a = vx * vx + vy * vy;
+	double b = 2 * (dx * vx + dy * vy);
+	double c = dx * dx + dy * dy - parameters.lateralMinimum * parameters.lateralMinimum;
+
+	if (a < 1e-12)
+	{
+		if (c >= 0) return false;
+	}
+	else
+	{
+		double discriminant = b * b - 4 * a * c;
+		if (discriminant < 0) return false;
+
+		double root = std::sqrt(discriminant);
+		start = std::max(start, (-b - root) / (2 * a));
+		end = std::min(end, (-b + root) / (2 * a));
+	}
+
+	// When the vertical distance is inside the minimum: |dz + vz t| < V
+	if (std::fabs(vz) < 1e-9)
+	{
+		if (std::fabs(dz) >= parameters.verticalMinimum) return false;
+	}
+	else
+	{
+		double t1 = (-parameters.verticalMinimum - dz) / vz;
+		double t2 = (parameters.verticalMinimum - dz) / vz;
+
+		start = std::max(start, std::min(t1, t2));
+		end = std::min(end, std::max(t1, t2));
+	}
+
+	if (start > end) return false;
+
+	// Closest approach within the time both minima are lost
+	double closest = a < 1e-12 ? start : std::min(std::max(-b / (2 * a), start), end);
+
+	prediction.first = first.callsign;
+	prediction.second = second.callsign;
+	prediction.timeToConflict = start;
+	prediction.lateralSeparation = std::sqrt(std::pow(dx + vx * closest, 2) + std::pow(dy + vy * closest, 2));
+	prediction.verticalSeparation = static_cast<int>(std::fabs(dz + vz * start));
+
+	return true;
+}
+
+void ConflictDetector::Tick()
+{
+	PROFILE_ZONE("ConflictDetector.Tick");
+	static MetricHistogram& tickTime = Metrics::GetInstance()->Histogram("stca.tick_us");
+	static MetricCounter& pairsTested = Metrics::GetInstance()->Counter("stca.pairs_tested");
+	MetricTimer timer(tickTime);
+
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	std::vector<RadarSample> targets;
+	ConflictParameters parameters;
+
+	{
+		std::lock_guard<std::mutex> guard(_lock);
+		parameters = _parameters;
+
+		double liveNow = _liveClock.Now(now);
+		double syntheticNow = _syntheticClock.Now(now);
+
+		for (auto track = _tracks.begin(); track != _tracks.end();)
+		{
+			double age = (track->second.sample.synthetic ? syntheticNow : liveNow) - track->second.sample.time;
+			if (age > STALE_AFTER)
+			{
+				track = _tracks.erase(track);
+				continue;
+			}
+
+			if (track->second.sample.groundSpeed >= parameters.minimumGroundSpeed)
+			{
+				targets.push_back(Extrapolate(track->second.sample, std::max(age, 0.0)));
+			}
+
+			++track;
+		}
+	}
+
+	// Cells are as wide as the most two targets can close in the look-ahead, plus the minimum, so a pair that can
+	// conflict is always in the same or neighbouring cells
+	int fastest = 0;
+	double highestLatitude = 0;
+	for (const RadarSample& target : targets)
+	{
+		fastest = std::max(fastest, target.groundSpeed);
+		highestLatitude = std::max(highestLatitude, std::fabs(target.latitude));
+	}
+
+	double cellSize = parameters.lateralMinimum + 2.0 * fastest * parameters.lookAhead / 3600;
+
+	// Longitude is scaled for the highest latitude, where a degree is shortest, so cells are never narrower than that.
+	// Columns go once round the earth, so targets either side of 180 degrees are in neighbouring columns.
+	double longitudeScale = NM_PER_DEGREE * std::cos(std::min(highestLatitude, 89.0) * PI / 180);
+	long long columns = std::max(1LL, static_cast<long long>(std::floor(360 * longitudeScale / cellSize)));
+
+	std::unordered_map<uint64_t, std::vector<size_t>> cells;
+	std::vector<std::pair<long long, long long>> cellOf(targets.size());
+
+	for (size_t i = 0; i < targets.size(); i++)
+	{
+		double longitude = std::fmod(targets[i].longitude + 180, 360);
+		if (longitude < 0) longitude += 360;
+
+		long long row = static_cast<long long>(std::floor(targets[i].latitude * NM_PER_DEGREE / cellSize));
+		long long column = std::min(columns - 1, static_cast<long long>(std::floor(longitude / 360 * columns)));
+
+		cellOf[i] = std::make_pair(row, column);
+		cells[CellKey(row, column)].push_back(i);
+	}
+
+	std::map<std::pair<std::string, std::string>, ConflictPrediction> conflicts;
+	unsigned long long tested = 0;
+
+	for (size_t i = 0; i < targets.size(); i++)
+	{
+		for (long long row = cellOf[i].first - 1; row <= cellOf[i].first + 1; row++)
+		{
+			for (long long offset = -1; offset <= 1; offset++)
+			{
+				// With fewer than three columns the neighbours wrap onto each other, and are only visited once
+				if (offset != 0 && (columns < 2 || (columns == 2 && offset > 0))) continue;
+
+				long long column = (cellOf[i].second + offset + columns) % columns;
+
+				auto cell = cells.find(CellKey(row, column));
+				if (cell == cells.end()) continue;
+
+				for (size_t j : cell->second)
+				{
+					// Each pair once
+					if (j <= i) continue;
+
+					tested++;
+
+					const RadarSample& first = targets[i].callsign < targets[j].callsign ? targets[i] : targets[j];
+					const RadarSample& second = targets[i].callsign < targets[j].callsign ? targets[j] : targets[i];
+
+					ConflictPrediction prediction;
+					if (Predict(first, second, parameters, prediction))
+						conflicts[std::make_pair(first.callsign, second.callsign)] = prediction;
+				}
+			}
+		}
+	}
+
+	pairsTested.Increment(tested);
+
+	std::vector<sio::message::ptr> changes;
+
+	{
+		std::lock_guard<std::mutex> guard(_lock);
+
+		for (const auto& conflict : conflicts)
+		{
+			if (_conflicts.find(conflict.first) == _conflicts.end())
+				changes.push_back(ToMessage(conflict.second, true));
+		}
+
+		for (const auto& conflict : _conflicts)
+		{
+			if (conflicts.find(conflict.first) == conflicts.end())
+				changes.push_back(ToMessage(conflict.second, false));
+		}
+
+		_conflicts.swap(conflicts);
+
+		_partners.clear();
+		for (const auto& conflict : _conflicts)
+		{
+			_partners[conflict.first.first].insert(conflict.first.second);
+			_partners[conflict.first.second].insert(conflict.first.first);
+		}
+	}
+
+	for (const sio::message::ptr& change : changes)
+		CEXCDSBridge::Emit("CONFLICT_ALERT", change);
+}
+
+void ConflictDetector::Annotate(const std::string& callsign, sio::message::ptr message)
+{
+	if (!message || message->get_flag() != sio::message::flag_object) return;
+
+	auto radar = message->get_map().find("radar");
+	if (radar == message->get_map().end() || radar->second->get_flag() != sio::message::flag_object) return;
+
+	sio::message::ptr conflicts = sio::array_message::create();
+
+	{
+		std::lock_guard<std::mutex> guard(_lock);
+
+		auto partners = _partners.find(callsign);
+		if (partners == _partners.end()) return;
+
+		for (const std::string& partner : partners->second)
+			conflicts->get_vector().push_back(sio::string_message::create(partner));
+	}
+
+	std::map<std::string, sio::message::ptr>& fields = radar->second->get_map();
+	fields["conflicts"] = conflicts;
+
+	auto pps = fields.find("pps");
+	bool emergency = pps != fields.end() && pps->second->get_flag() == sio::message::flag_integer
+		&& (pps->second->get_int() == PPS_EMERGENCY || pps->second->get_int() == PPS_ADSB_EMERGENCY);
+
+	if (!emergency)
+		fields["pps"] = sio::int_message::create(PPS_CONFLICT);
+}
+
+void ConflictDetector::SetParameters(const ConflictParameters& parameters)
+{
+	std::lock_guard<std::mutex> guard(_lock);
+	_parameters = parameters;
+}
+
+ConflictParameters ConflictDetector::GetParameters()
+{
+	std::lock_guard<std::mutex> guard(_lock);
+	return _parameters;
+}
+
+size_t ConflictDetector::GetConflictCount()
+{
+	std::lock_guard<std::mutex> guard(_lock);
+	return _conflicts.size();
+}
+
+sio::message::ptr ConflictDetector::ToMessage(const ConflictPrediction& prediction, bool active)
+{
+	sio::message::ptr msg = sio::object_message::create();
+	sio::message::ptr callsigns = sio::array_message::create();
+
+	callsigns->get_vector().push_back(sio::string_message::create(prediction.first));
+	callsigns->get_vector().push_back(sio::string_message::create(prediction.second));
+
+	msg->get_map()["callsigns"] = callsigns;
+	msg->get_map()["active"] = sio::bool_message::create(active);
+	msg->get_map()["time_to_conflict"] = sio::int_message::create(static_cast<int>(std::ceil(prediction.timeToConflict)));
+	msg->get_map()["lateral_separation"] = sio::double_message::create(prediction.lateralSeparation);
+	msg->get_map()["vertical_separation"] = sio::int_message::create(prediction.verticalSeparation);
+
+	return msg;
+}
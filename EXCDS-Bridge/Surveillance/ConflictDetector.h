@@ -0,0 +1,117 @@
+#pragma once
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <sio_client.h>
+
+#include "RadarSample.h"
+
+struct ConflictParameters
+{
+    /**
+    * Separation that has to be lost both laterally, in nautical miles, and vertically, in feet, for a conflict
+    */
+    double lateralMinimum = 5;
+    int verticalMinimum = 1000;
+
+    /**
+    * How far ahead tracks are predicted, in seconds
+    */
+    int lookAhead = 120;
+
+    /**
+    * Slower targets are taken to be on the ground, in knots
+    */
+    int minimumGroundSpeed = 50;
+};
+
+/**
+* One pair of targets predicted to lose separation within the look-ahead.
+*/
+struct ConflictPrediction
+{
+    std::string first;
+    std::string second;
+
+    // Seconds until separation is lost, 0 if it already is
+    double timeToConflict = 0;
+
+    // Closest lateral distance while vertical separation is lost, in nautical miles
+    double lateralSeparation = 0;
+    int verticalSeparation = 0;
+};
+
+/**
+* Short term conflict alert. Every target's last radar sample is projected along its track at its ground speed and
+* vertical speed, and each pair that would be inside both minima within the look-ahead is a conflict.
+*
+* Targets are bucketed in a uniform grid with cells as wide as two targets can close in the look-ahead plus the
+* lateral minimum, so only targets in neighbouring cells are compared and the cost grows with the traffic rather than
+* its square. New and cleared conflicts are sent to EXCDS as CONFLICT_ALERT:
+*   { "callsigns": ["AAL123", "ACA456"], "active": true, "time_to_conflict": 45, "lateral_separation": 2.1,
+*     "vertical_separation": 500 }
+* and radar frames of targets in conflict carry "conflicts" with the other callsigns, and PPS 5.
+*/
+class ConflictDetector
+{
+public:
+    static ConflictDetector* GetInstance();
+
+    void Update(const RadarSample& sample);
+    void Remove(const std::string& callsign);
+
+    /**
+    * Predicts every pair again and sends what changed. Called once a second.
+    */
+    void Tick();
+
+    /**
+    * Marks a SEND_RT_DATA frame with the conflicts its target is in.
+    */
+    void Annotate(const std::string& callsign, sio::message::ptr message);
+
+    void SetParameters(const ConflictParameters& parameters);
+    ConflictParameters GetParameters();
+
+    size_t GetConflictCount();
+
+    /**
+    * Whether two targets, already moved to the same moment, lose separation within the look-ahead.
+    */
+    static bool Predict(const RadarSample& first, const RadarSample& second, const ConflictParameters& parameters, ConflictPrediction& prediction);
+private:
+    struct Track
+    {
+        RadarSample sample;
+    };
+
+    /**
+    * The newest sample time seen and when it arrived. Samples are aged against this rather than the wall clock, so
+    * replays and generated traffic faster than real time keep their own time. Live and synthetic samples each have
+    * one, as both can run at once in playback.
+    */
+    struct SampleClock
+    {
+        double time = 0;
+        std::chrono::steady_clock::time_point seenAt;
+
+        double Now(std::chrono::steady_clock::time_point now) const;
+    };
+
+    std::mutex _lock;
+    ConflictParameters _parameters;
+    std::unordered_map<std::string, Track> _tracks;
+    SampleClock _liveClock;
+    SampleClock _syntheticClock;
+
+    // Keyed by the two callsigns in order
+    std::map<std::pair<std::string, std::string>, ConflictPrediction> _conflicts;
+    std::unordered_map<std::string, std::set<std::string>> _partners;
+
+    static sio::message::ptr ToMessage(const ConflictPrediction& prediction, bool active);
+};
@@ -0,0 +1,200 @@
+#include <algorithm>
+#include <cmath>
+
+#include "KinematicsFilter.h"
+
+static const double PI = 3.14159265358979323846;
+static const double NM_PER_DEGREE = 60;
+
+// Gains for a sweep of about five seconds. Higher alphas follow the returns more closely, higher betas change the
+// rates more quickly.
+static const double POSITION_ALPHA = 0.5;
+static const double POSITION_BETA = 0.2;
+static const double TRACK_ALPHA = 0.5;
+static const double TRACK_BETA = 0.15;
+static const double ALTITUDE_ALPHA = 0.5;
+static const double ALTITUDE_BETA = 0.2;
+
+// A target not seen for this long starts again from its next return
+static const double RESTART_AFTER = 60;
+
+// Returns closer than this are taken to be this far apart
+static const double MINIMUM_INTERVAL = 0.5;
+
+// The track of a target this slow is mostly noise, so it does not turn
+static const double MINIMUM_TURN_SPEED = 30;
+
+// Within this of an altitude, a target is at it, in feet and feet a minute
+static const int LEVEL_TOLERANCE = 200;
+static const int LEVEL_RATE = 200;
+
+static double WrapDegrees(double degrees)
+{
+	degrees = std::fmod(degrees + 180, 360);
+	if (degrees < 0) degrees += 360;
+	return degrees - 180;
+}
+
+int TrackKinematics::TimeToLevel(int targetAltitude) const
+{
+	double remaining = targetAltitude - altitude;
+	if (std::fabs(remaining) <= LEVEL_TOLERANCE) return 0;
+
+	// Level, or moving away
+	if (std::fabs(verticalRate) < LEVEL_RATE || remaining * verticalRate < 0) return -1;
+
+	return static_cast<int>(std::ceil(remaining / verticalRate * 60));
+}
+
+KinematicsFilter* KinematicsFilter::GetInstance()
+{
+	static KinematicsFilter filter;
+	return &filter;
+}
+
+TrackKinematics KinematicsFilter::Update(const RadarSample& sample)
+{
+	if (sample.callsign.empty()) return TrackKinematics();
+
+	std::lock_guard<std::mutex> guard(_lock);
+
+	auto found = _states.find(sample.callsign);
+	bool restart = found == _states.end();
+
+	if (!restart)
+	{
+		const RadarSample& measured = found->second.measured;
+		if (measured.latitude == sample.latitude && measured.longitude == sample.longitude && measured.altitude == sample.altitude)
+			return ToKinematics(found->second);
+
+		// Not seen for a while, or a replay that started again
+		double since = sample.time - measured.time;
+		restart = since > RESTART_AFTER || since < 0;
+	}
+
+	FilterState& state = _states[sample.callsign];
+
+	if (restart)
+	{
+		// Start from what the target reports of itself
+		double heading = sample.heading * PI / 180;
+
+		state = FilterState();
+		state.latitude = sample.latitude;
+		state.longitude = sample.longitude;
+		state.velocityEast = sample.groundSpeed * std::sin(heading) / 3600;
+		state.velocityNorth = sample.groundSpeed * std::cos(heading) / 3600;
+		state.track = sample.heading;
+		state.altitude = sample.altitude;
+		state.altitudeRate = sample.verticalSpeed / 60.0;
+		state.measured = sample;
+
+		return ToKinematics(state);
+	}
+
+	double interval = std::max(sample.time - state.measured.time, MINIMUM_INTERVAL);
+	double scale = NM_PER_DEGREE * std::max(std::cos(state.latitude * PI / 180), 0.01);
+
+	// Position, in nautical miles from where the target was predicted to be
+	double predictedLatitude = state.latitude + state.velocityNorth * interval / NM_PER_DEGREE;
+	double predictedLongitude = state.longitude + state.velocityEast * interval / scale;
+
+	double residualNorth = (sample.latitude - predictedLatitude) * NM_PER_DEGREE;
+	double residualEast = WrapDegrees(sample.longitude - predictedLongitude) * scale;
+
+	state.latitude = predictedLatitude + POSITION_ALPHA * residualNorth / NM_PER_DEGREE;
+	state.longitude = predictedLongitude + POSITION_ALPHA * residualEast / scale;
+	state.velocityNorth += POSITION_BETA * residualNorth / interval;
+	state.velocityEast += POSITION_BETA * residualEast / interval;
+
+	// Track, against the direction of the smoothed velocity
+	double groundSpeed = std::sqrt(state.velocityEast * state.velocityEast + state.velocityNorth * state.velocityNorth) * 3600;
+	if (groundSpeed >= MINIMUM_TURN_SPEED)
+	{
+		double predictedTrack = state.track + state.turnRate * interval;
+		double residualTrack = WrapDegrees(std::atan2(state.velocityEast, state.velocityNorth) * 180 / PI - predictedTrack);
+
+		state.track = predictedTrack + TRACK_ALPHA * residualTrack;
+		state.turnRate += TRACK_BETA * residualTrack / interval;
+	}
+	else
+	{
+		state.turnRate = 0;
+	}
+
+	state.track = std::fmod(state.track + 360, 360);
+
+	// Altitude
+	double predictedAltitude = state.altitude + state.altitudeRate * interval;
+	double residualAltitude = sample.altitude - predictedAltitude;
+
+	state.altitude = predictedAltitude + ALTITUDE_ALPHA * residualAltitude;
+	state.altitudeRate += ALTITUDE_BETA * residualAltitude / interval;
+
+	state.measured = sample;
+
+	return ToKinematics(state);
+}
+
+void KinematicsFilter::Remove(const std::string& callsign)
+{
+	std::lock_guard<std::mutex> guard(_lock);
+	_states.erase(callsign);
+}
+
+void KinematicsFilter::Annotate(const TrackKinematics& kinematics, sio::message::ptr message)
+{
+	if (!kinematics.valid || !message || message->get_flag() != sio::message::flag_object) return;
+
+	auto radar = message->get_map().find("radar");
+	if (radar == message->get_map().end() || radar->second->get_flag() != sio::message::flag_object) return;
+
+	sio::message::ptr msg = sio::object_message::create();
+	msg->get_map()["track"] = sio::double_message::create(std::round(kinematics.track * 10) / 10);
+	msg->get_map()["ground_speed"] = sio::int_message::create(std::lround(kinematics.groundSpeed));
+	msg->get_map()["turn_rate"] = sio::double_message::create(std::round(kinematics.turnRate * 10) / 10);
+	msg->get_map()["vertical_rate"] = sio::int_message::create(std::lround(kinematics.verticalRate));
+
+	radar->second->get_map()["kinematics"] = msg;
+}
+
+void KinematicsFilter::AnnotateLevelOff(const TrackKinematics& kinematics, const RadarSample& sample, sio::message::ptr message)
+{
+	if (!kinematics.valid || sample.targetAltitude <= 0 || !message || message->get_flag() != sio::message::flag_object) return;
+
+	auto mods = message->get_map().find("mods");
+	if (mods == message->get_map().end() || mods->second->get_flag() != sio::message::flag_object) return;
+
+	// Judged on the smoothed vertical rate, so one jumpy return does not flash the error
+	int levelOff = kinematics.TimeToLevel(sample.targetAltitude);
+	mods->second->get_map()["level_off"] = sio::int_message::create(levelOff);
+
+	auto altitudeError = mods->second->get_map().find("altitude_error");
+	if (levelOff >= 0 && altitudeError != mods->second->get_map().end())
+		altitudeError->second = sio::bool_message::create(false);
+}
+
+RadarSample KinematicsFilter::Smooth(const RadarSample& sample, const TrackKinematics& kinematics)
+{
+	if (!kinematics.valid) return sample;
+
+	RadarSample smoothed = sample;
+	smoothed.heading = static_cast<int>(std::lround(kinematics.track)) % 360;
+	smoothed.groundSpeed = static_cast<int>(std::lround(kinematics.groundSpeed));
+	smoothed.verticalSpeed = static_cast<int>(std::lround(kinematics.verticalRate));
+
+	return smoothed;
+}
+
+TrackKinematics KinematicsFilter::ToKinematics(const FilterState& state)
+{
+	TrackKinematics kinematics;
+	kinematics.valid = true;
+	kinematics.track = state.track;
+	kinematics.groundSpeed = std::sqrt(state.velocityEast * state.velocityEast + state.velocityNorth * state.velocityNorth) * 3600;
+	kinematics.turnRate = state.turnRate;
+	kinematics.altitude = state.altitude;
+	kinematics.verticalRate = state.altitudeRate * 60;
+
+	return kinematics;
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <sio_client.h>
+
+#include "RadarSample.h"
+
+/**
+* What the filter makes of a target's radar returns so far.
+*/
+struct TrackKinematics
+{
+    bool valid = false;
+
+    // Degrees from true north, and knots
+    double track = 0;
+    double groundSpeed = 0;
+
+    // Degrees a second, right turns positive
+    double turnRate = 0;
+
+    double altitude = 0;
+
+    // Feet a minute
+    double verticalRate = 0;
+
+    /**
+    * Seconds until the target levels at an altitude, 0 if it is there, or -1 if it is not climbing or descending to it.
+    */
+    int TimeToLevel(int targetAltitude) const;
+};
+
+/**
+* Smooths each radar target's position and altitude with an alpha-beta filter, once a sweep, for the ground track,
+* turn rate and vertical rate that EXCDS and the alerts use. Radar frames carry the result as
+*   "kinematics": { "track": 271.5, "ground_speed": 452, "turn_rate": -1.2, "vertical_rate": -1500 }
+*
+* Flight plan updates send a target again without a new return, so a sample that has not moved is not a measurement.
+* Returns are filtered on the time they were received, which for replays and generated traffic is their own clock.
+* Updated only from PublishRadarTarget, once per return.
+*/
+class KinematicsFilter
+{
+public:
+    static KinematicsFilter* GetInstance();
+
+    /**
+    * Takes in a radar return, if it is a new one, and gives back the target's kinematics.
+    */
+    TrackKinematics Update(const RadarSample& sample);
+    void Remove(const std::string& callsign);
+
+    static void Annotate(const TrackKinematics& kinematics, sio::message::ptr message);
+
+    /**
+    * Sets mods.level_off to the time to level at the sample's target altitude, and clears mods.altitude_error while
+    * the target is on its way to it. Messages without mods, or samples without a target altitude, are left alone.
+    */
+    static void AnnotateLevelOff(const TrackKinematics& kinematics, const RadarSample& sample, sio::message::ptr message);
+
+    /**
+    * The sample with the smoothed track, ground speed and vertical rate in place of the reported ones.
+    */
+    static RadarSample Smooth(const RadarSample& sample, const TrackKinematics& kinematics);
+private:
+    struct FilterState
+    {
+        double latitude = 0;
+        double longitude = 0;
+
+        // Nautical miles a second
+        double velocityEast = 0;
+        double velocityNorth = 0;
+
+        double track = 0;
+        double turnRate = 0;
+
+        double altitude = 0;
+
+        // Feet a second
+        double altitudeRate = 0;
+
+        // The last return, to tell a new one from the same one sent again, and measure the time since
+        RadarSample measured;
+    };
+
+    std::mutex _lock;
+    std::unordered_map<std::string, FilterState> _states;
+
+    static TrackKinematics ToKinematics(const FilterState& state);
+};
@@ -0,0 +1,190 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <Windows.h>
+
+#include "MinimumAltitudeWarning.h"
+#include "../Diagnostics/Metrics.h"
+
+static const char GRID_MAGIC[8] = { 'E', 'X', 'C', 'D', 'S', 'M', 'S', 'A' };
+static const uint32_t GRID_VERSION = 1;
+
+static const double PI = 3.14159265358979323846;
+
+// How far ahead descents are followed, and how often along the way the grid is read, in seconds
+static const int LOOK_AHEAD = 60;
+static const int LOOK_AHEAD_STEP = 10;
+
+// Slower targets are taken to be on the ground
+static const int MINIMUM_GROUND_SPEED = 50;
+
+// Emergency symbols are not replaced by the warning symbol
+static const int PPS_MSAW = 5;
+static const int PPS_EMERGENCY = 6;
+static const int PPS_ADSB_EMERGENCY = 18;
+
+const char* MinimumAltitudeWarning::DEFAULT_FILE = "EXCDS-Bridge-msaw.bin";
+
+MinimumAltitudeGrid::~MinimumAltitudeGrid()
+{
+	if (_mappedView) UnmapViewOfFile(_mappedView);
+	if (_mappingHandle) CloseHandle(_mappingHandle);
+}
+
+std::shared_ptr<MinimumAltitudeGrid> MinimumAltitudeGrid::Open(const std::string& path)
+{
+	HANDLE file = CreateFile(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE) return nullptr;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart < static_cast<LONGLONG>(sizeof(MinimumAltitudeGridHeader)))
+	{
+		CloseHandle(file);
+		return nullptr;
+	}
+
+	HANDLE mapping = CreateFileMapping(file, NULL, PAGE_READONLY, 0, 0, NULL);
+
+	// The mapping keeps the file open
+	CloseHandle(file);
+	if (!mapping) return nullptr;
+
+	std::shared_ptr<MinimumAltitudeGrid> grid(new MinimumAltitudeGrid());
+	grid->_mappingHandle = mapping;
+	grid->_mappedView = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!grid->_mappedView) return nullptr;
+
+	const MinimumAltitudeGridHeader* header = static_cast<const MinimumAltitudeGridHeader*>(grid->_mappedView);
+	bool valid = memcmp(header->magic, GRID_MAGIC, sizeof(GRID_MAGIC)) == 0
+		&& header->version == GRID_VERSION
+		&& header->rows >= 2 && header->columns >= 2
+		&& header->spacing > 0
+		&& size.QuadPart == static_cast<LONGLONG>(sizeof(MinimumAltitudeGridHeader) + static_cast<uint64_t>(header->rows) * header->columns * sizeof(int16_t));
+
+	if (!valid) return nullptr;
+
+	grid->_header = header;
+	grid->_altitudes = reinterpret_cast<const int16_t*>(header + 1);
+	return grid;
+}
+
+bool MinimumAltitudeGrid::Sample(double latitude, double longitude, int& altitude) const
+{
+	double row = (latitude - _header->south) / _header->spacing;
+	double column = (longitude - _header->west) / _header->spacing;
+
+	if (row < 0 || column < 0 || row > _header->rows - 1 || column > _header->columns - 1) return false;
+
+	uint32_t r0 = std::min(static_cast<uint32_t>(row), _header->rows - 2);
+	uint32_t c0 = std::min(static_cast<uint32_t>(column), _header->columns - 2);
+	double fr = row - r0;
+	double fc = column - c0;
+
+	const int16_t* south = _altitudes + static_cast<size_t>(r0) * _header->columns + c0;
+	const int16_t* north = south + _header->columns;
+	int16_t corners[4] = { south[0], south[1], north[0], north[1] };
+
+	// Where part of the cell has no data, the highest of the rest is the safe answer
+	int highest = MINIMUM_ALTITUDE_NO_DATA;
+	bool complete = true;
+	for (int16_t corner : corners)
+	{
+		if (corner == MINIMUM_ALTITUDE_NO_DATA)
+			complete = false;
+		else
+			highest = std::max<int>(highest, corner);
+	}
+
+	if (highest == MINIMUM_ALTITUDE_NO_DATA) return false;
+
+	if (!complete)
+	{
+		altitude = highest;
+		return true;
+	}
+
+	double southEdge = corners[0] + (corners[1] - corners[0]) * fc;
+	double northEdge = corners[2] + (corners[3] - corners[2]) * fc;
+	altitude = static_cast<int>(std::ceil(southEdge + (northEdge - southEdge) * fr));
+	return true;
+}
+
+MinimumAltitudeWarning* MinimumAltitudeWarning::GetInstance()
+{
+	static MinimumAltitudeWarning warning;
+	return &warning;
+}
+
+bool MinimumAltitudeWarning::Load(const std::string& path)
+{
+	std::shared_ptr<MinimumAltitudeGrid> grid = MinimumAltitudeGrid::Open(path);
+	if (!grid) return false;
+
+	// Checks still holding the old grid finish with it before it is unmapped
+	std::lock_guard<std::mutex> guard(_lock);
+	_grid = grid;
+	return true;
+}
+
+bool MinimumAltitudeWarning::IsLoaded()
+{
+	std::lock_guard<std::mutex> guard(_lock);
+	return _grid != nullptr;
+}
+
+int MinimumAltitudeWarning::Check(const RadarSample& sample)
+{
+	std::shared_ptr<MinimumAltitudeGrid> grid;
+	{
+		std::lock_guard<std::mutex> guard(_lock);
+		grid = _grid;
+	}
+
+	if (!grid || sample.groundSpeed < MINIMUM_GROUND_SPEED) return -1;
+
+	double heading = sample.heading * PI / 180;
+	double north = sample.groundSpeed * std::cos(heading) / 3600 / 60;
+	double east = sample.groundSpeed * std::sin(heading) / 3600 / (60 * std::max(std::cos(sample.latitude * PI / 180), 0.01));
+
+	// Level and climbing targets are only checked where they are, as they will not get any lower
+	int lookAhead = sample.verticalSpeed < 0 ? LOOK_AHEAD : 0;
+
+	for (int seconds = 0; seconds <= lookAhead; seconds += LOOK_AHEAD_STEP)
+	{
+		int minimum;
+		if (!grid->Sample(sample.latitude + north * seconds, sample.longitude + east * seconds, minimum)) continue;
+
+		int altitude = sample.altitude + sample.verticalSpeed * seconds / 60;
+		if (altitude < minimum) return seconds;
+	}
+
+	return -1;
+}
+
+void MinimumAltitudeWarning::Annotate(const RadarSample& sample, sio::message::ptr message)
+{
+	static MetricCounter& warnings = Metrics::GetInstance()->Counter("msaw.warnings");
+
+	// Shared by every flagged frame, so a warning does not allocate
+	static const sio::message::ptr flag = sio::bool_message::create(true);
+	static const sio::message::ptr pps = sio::int_message::create(PPS_MSAW);
+
+	if (!message || message->get_flag() != sio::message::flag_object) return;
+
+	auto radar = message->get_map().find("radar");
+	if (radar == message->get_map().end() || radar->second->get_flag() != sio::message::flag_object) return;
+
+	if (Check(sample) < 0) return;
+
+	warnings.Increment();
+
+	std::map<std::string, sio::message::ptr>& fields = radar->second->get_map();
+	fields["msaw"] = flag;
+
+	auto current = fields.find("pps");
+	bool emergency = current != fields.end() && current->second->get_flag() == sio::message::flag_integer
+		&& (current->second->get_int() == PPS_EMERGENCY || current->second->get_int() == PPS_ADSB_EMERGENCY);
+
+	if (!emergency)
+		fields["pps"] = pps;
+}
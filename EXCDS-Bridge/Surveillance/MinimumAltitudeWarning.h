@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <sio_client.h>
+
+#include "RadarSample.h"
+
+/**
+* The layout of a minimum altitude grid file. The header is followed by rows * columns altitudes in feet, as int16,
+* a row at a time from the south-west corner. Cells without data hold MINIMUM_ALTITUDE_NO_DATA.
+*/
+struct MinimumAltitudeGridHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t rows;
+    uint32_t columns;
+    uint32_t reserved;
+    double south;
+    double west;
+
+    // Degrees between rows and between columns
+    double spacing;
+};
+
+static const int16_t MINIMUM_ALTITUDE_NO_DATA = INT16_MIN;
+
+/**
+* A minimum altitude grid file, mapped into memory for as long as it is in use.
+*/
+class MinimumAltitudeGrid
+{
+public:
+    ~MinimumAltitudeGrid();
+
+    /**
+    * Maps the file, or returns nothing if it cannot be opened or is not a grid.
+    */
+    static std::shared_ptr<MinimumAltitudeGrid> Open(const std::string& path);
+
+    /**
+    * The minimum altitude at a point, between the four grid points around it. False outside the grid.
+    */
+    bool Sample(double latitude, double longitude, int& altitude) const;
+
+    uint32_t GetRows() const { return _header->rows; }
+    uint32_t GetColumns() const { return _header->columns; }
+private:
+    MinimumAltitudeGrid() {};
+
+    void* _mappingHandle = nullptr;
+    const void* _mappedView = nullptr;
+
+    const MinimumAltitudeGridHeader* _header = nullptr;
+    const int16_t* _altitudes = nullptr;
+};
+
+/**
+* Minimum safe altitude warning. Each radar target is checked against the minimum altitude grid where it is, and
+* where its track and vertical speed put it over the next minute. Targets below it are flagged in their radar frame
+* with "msaw" and PPS 5.
+*
+* The grid is EXCDS-Bridge-msaw.bin in the plugin folder, or another file loaded with LOAD_MSAW_GRID. Checks run for
+* every frame, so they are a few grid reads and do not allocate.
+*/
+class MinimumAltitudeWarning
+{
+public:
+    static MinimumAltitudeWarning* GetInstance();
+
+    bool Load(const std::string& path);
+    bool IsLoaded();
+
+    /**
+    * The first second the target is predicted below the minimum altitude, or -1 if it stays above it.
+    */
+    int Check(const RadarSample& sample);
+
+    /**
+    * Flags a SEND_RT_DATA frame if its target is below, or about to be below, the minimum altitude.
+    */
+    void Annotate(const RadarSample& sample, sio::message::ptr message);
+
+    static const char* DEFAULT_FILE;
+private:
+    std::mutex _lock;
+    std::shared_ptr<MinimumAltitudeGrid> _grid;
+};
@@ -0,0 +1,44 @@
+#include <chrono>
+
+#include "RadarSample.h"
+
+RadarSample RadarSample::FromRadarTarget(EuroScopePlugIn::CRadarTarget rt)
+{
+	RadarSample sample;
+
+	sample.callsign = rt.GetCallsign();
+	sample.systemId = rt.GetSystemID();
+	sample.verticalSpeed = rt.GetVerticalSpeed();
+	sample.correlated = rt.GetCorrelatedFlightPlan().IsValid();
+
+	if (sample.correlated)
+	{
+		EuroScopePlugIn::CFlightPlan fp = rt.GetCorrelatedFlightPlan();
+		int cleared = fp.GetControllerAssignedData().GetClearedAltitude();
+
+		// 1 and 2 are cleared for an ILS or visual approach, which have no altitude to level off at
+		if (cleared == 0)
+			sample.targetAltitude = fp.GetFinalAltitude();
+		else if (cleared > 2)
+			sample.targetAltitude = cleared;
+	}
+
+	EuroScopePlugIn::CRadarTargetPositionData position = rt.GetPosition();
+	if (!position.IsValid()) return sample;
+
+	sample.time = Now() - position.GetReceivedTime();
+
+	sample.squawk = position.GetSquawk();
+	sample.latitude = position.GetPosition().m_Latitude;
+	sample.longitude = position.GetPosition().m_Longitude;
+	sample.altitude = position.GetFlightLevel() >= 18000 ? position.GetFlightLevel() : position.GetPressureAltitude();
+	sample.groundSpeed = position.GetReportedGS();
+	sample.heading = position.GetReportedHeadingTrueNorth();
+
+	return sample;
+}
+
+double RadarSample::Now()
+{
+	return std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
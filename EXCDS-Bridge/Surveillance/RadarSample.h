@@ -0,0 +1,59 @@
+#pragma once
+
+#include <string>
+#include "EuroScopePlugIn.h"
+
+/**
+* The position of one radar target at one moment, copied out of EuroScope.
+*
+* Everything downstream of the radar callback that does not need to talk to EuroScope works on these, so it can be
+* fed from a recording or generated traffic as well as from the live radar.
+*/
+struct RadarSample
+{
+    std::string callsign;
+    std::string systemId;
+    std::string squawk;
+
+    double latitude = 0;
+    double longitude = 0;
+
+    /**
+    * Flight level above the transition altitude, pressure altitude below it, in feet
+    */
+    int altitude = 0;
+    int groundSpeed = 0;
+    int verticalSpeed = 0;
+
+    /**
+    * Reported heading, from true north so it can be projected on the coordinates. The track over the ground differs
+    * from it by the wind drift.
+    */
+    int heading = 0;
+
+    bool correlated = false;
+
+    /**
+    * Seconds since the epoch when the return was received. Replays and generated traffic keep to their own clock,
+    * so returns are as far apart as they were recorded or simulated, however fast they are played.
+    */
+    double time = 0;
+
+    /**
+    * The cleared altitude of the correlated flight plan, or its final altitude when none is cleared, in feet. 0 when
+    * not known, or when the aircraft is cleared for an approach.
+    */
+    int targetAltitude = 0;
+
+    /**
+    * Set on samples that come from a replay or generated traffic rather than the live radar
+    */
+    bool synthetic = false;
+
+    static RadarSample FromRadarTarget(EuroScopePlugIn::CRadarTarget rt);
+
+    /**
+    * The current time, in the same seconds as time
+    */
+    static double Now();
+};
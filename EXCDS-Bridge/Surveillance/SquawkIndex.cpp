@@ -0,0 +1,148 @@
+#include "SquawkIndex.h"
+#include "../CEXCDSBridge.h"
+#include "../Diagnostics/Metrics.h"
+
+static const char* NON_DISCRETE_CODES[] = { "0000", "1000", "1200", "2000", "2200", "7000", "7500", "7600", "7700" };
+
+SquawkIndex* SquawkIndex::GetInstance()
+{
+	static SquawkIndex index;
+	return &index;
+}
+
+bool SquawkIndex::IsDiscrete(const std::string& code)
+{
+	if (code.size() != 4) return false;
+
+	for (char digit : code)
+	{
+		if (digit < '0' || digit > '7') return false;
+	}
+
+	for (const char* nonDiscrete : NON_DISCRETE_CODES)
+	{
+		if (code == nonDiscrete) return false;
+	}
+
+	return true;
+}
+
+void SquawkIndex::UpdateTransponder(const std::string& callsign, const std::string& code)
+{
+	Update(callsign, &AircraftCodes::transponder, code, false);
+}
+
+void SquawkIndex::UpdateAssigned(const std::string& callsign, const std::string& code)
+{
+	Update(callsign, &AircraftCodes::assigned, code, false);
+}
+
+void SquawkIndex::Remove(const std::string& callsign)
+{
+	Update(callsign, nullptr, "", true);
+}
+
+bool SquawkIndex::IsInUse(const std::string& code)
+{
+	std::lock_guard<std::mutex> guard(_lock);
+	return _byCode.find(code) != _byCode.end();
+}
+
+size_t SquawkIndex::GetConflictCount()
+{
+	std::lock_guard<std::mutex> guard(_lock);
+	return _conflicts;
+}
+
+void SquawkIndex::Update(const std::string& callsign, std::string AircraftCodes::* field, const std::string& code, bool remove)
+{
+	std::vector<sio::message::ptr> changes;
+
+	{
+		std::lock_guard<std::mutex> guard(_lock);
+
+		AircraftCodes previous;
+		auto existing = _aircraft.find(callsign);
+		if (existing != _aircraft.end())
+			previous = existing->second;
+		else if (remove)
+			return;
+
+		AircraftCodes codes = previous;
+		if (field)
+		{
+			// Radar updates almost always land here
+			if (existing != _aircraft.end() && previous.*field == code) return;
+			codes.*field = code;
+		}
+
+		std::set<std::string> before = { previous.transponder, previous.assigned };
+		std::set<std::string> after;
+		if (!remove)
+			after = { codes.transponder, codes.assigned };
+
+		for (const std::string& oldCode : before)
+		{
+			if (after.count(oldCode) == 0)
+				Move(callsign, oldCode, false, changes);
+		}
+
+		for (const std::string& newCode : after)
+		{
+			if (before.count(newCode) == 0)
+				Move(callsign, newCode, true, changes);
+		}
+
+		if (remove)
+			_aircraft.erase(callsign);
+		else
+			_aircraft[callsign] = codes;
+	}
+
+	for (const sio::message::ptr& change : changes)
+		CEXCDSBridge::Emit("SQUAWK_CONFLICT", change);
+}
+
+/**
+* Adds the aircraft to, or takes it off, the code. Called with the lock held.
+*/
+void SquawkIndex::Move(const std::string& callsign, const std::string& code, bool add, std::vector<sio::message::ptr>& changes)
+{
+	if (code.empty()) return;
+
+	std::set<std::string>& callsigns = _byCode[code];
+	bool wasConflict = callsigns.size() > 1;
+
+	if (add)
+		callsigns.insert(callsign);
+	else
+		callsigns.erase(callsign);
+
+	bool isConflict = callsigns.size() > 1;
+
+	if (IsDiscrete(code) && (wasConflict || isConflict))
+	{
+		if (isConflict && !wasConflict)
+		{
+			_conflicts++;
+			Metrics::GetInstance()->Counter("squawks.conflicts").Increment();
+		}
+		else if (wasConflict && !isConflict)
+		{
+			_conflicts--;
+		}
+
+		sio::message::ptr change = sio::object_message::create();
+		sio::message::ptr members = sio::array_message::create();
+		for (const std::string& member : callsigns)
+			members->get_vector().push_back(sio::string_message::create(member));
+
+		change->get_map()["code"] = sio::string_message::create(code);
+		change->get_map()["conflict"] = sio::bool_message::create(isConflict);
+		change->get_map()["callsigns"] = members;
+		changes.push_back(change);
+	}
+
+	if (callsigns.empty())
+		_byCode.erase(code);
+}
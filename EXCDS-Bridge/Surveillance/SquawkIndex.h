@@ -0,0 +1,56 @@
+#pragma once
+
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <sio_client.h>
+
+/**
+* Which aircraft are squawking, or have been assigned, each transponder code.
+*
+* An aircraft is listed under the code its transponder sends and the code it was assigned, which are usually the same.
+* When two aircraft end up under one discrete code, EXCDS is sent a SQUAWK_CONFLICT:
+*   { "code": "4521", "conflict": true, "callsigns": ["AAL123", "ACA456"] }
+* It is sent again when the aircraft under a conflicting code change, and with "conflict" false once only one is left.
+* Updates that do not change an aircraft's codes cost a lookup and nothing else.
+*/
+class SquawkIndex
+{
+public:
+    static SquawkIndex* GetInstance();
+
+    void UpdateTransponder(const std::string& callsign, const std::string& code);
+    void UpdateAssigned(const std::string& callsign, const std::string& code);
+    void Remove(const std::string& callsign);
+
+    /**
+    * Whether any aircraft sends or has been assigned the code.
+    */
+    bool IsInUse(const std::string& code);
+
+    size_t GetConflictCount();
+
+    /**
+    * Codes such as 1200, 2000, 7000 and the emergency codes are shared by design and never conflict.
+    */
+    static bool IsDiscrete(const std::string& code);
+private:
+    struct AircraftCodes
+    {
+        std::string transponder;
+        std::string assigned;
+    };
+
+    std::mutex _lock;
+    std::unordered_map<std::string, AircraftCodes> _aircraft;
+    std::unordered_map<std::string, std::set<std::string>> _byCode;
+    size_t _conflicts = 0;
+
+    /**
+    * Sets one of the aircraft's codes, or with remove, takes the aircraft off both.
+    */
+    void Update(const std::string& callsign, std::string AircraftCodes::* field, const std::string& code, bool remove);
+    void Move(const std::string& callsign, const std::string& code, bool add, std::vector<sio::message::ptr>& changes);
+};
@@ -0,0 +1,353 @@
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+#include "TrackArchive.h"
+#include "../Diagnostics/Metrics.h"
+#include "../Diagnostics/Profiler.h"
+
+static const double COORDINATE_SCALE = 10000;
+
+// Bits in each size of value, after its prefix of 10, 110, 1110 or 1111. A value of 0 is a single 0.
+static const int VALUE_BITS[] = { 7, 12, 20, 64 };
+
+static uint64_t ZigZag(int64_t value)
+{
+	return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+static int64_t UnZigZag(uint64_t value)
+{
+	return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+static void WriteBits(std::vector<uint64_t>& words, uint64_t& bits, uint64_t value, int count)
+{
+	while (count > 0)
+	{
+		size_t word = static_cast<size_t>(bits / 64);
+		int offset = static_cast<int>(bits % 64);
+		if (word == words.size()) words.push_back(0);
+
+		int written = std::min(count, 64 - offset);
+		uint64_t part = written == 64 ? value : value & ((1ULL << written) - 1);
+
+		words[word] |= part << offset;
+		value = written == 64 ? 0 : value >> written;
+		bits += written;
+		count -= written;
+	}
+}
+
+static uint64_t ReadBits(const std::vector<uint64_t>& words, uint64_t& bits, int count)
+{
+	uint64_t value = 0;
+	int read = 0;
+
+	while (read < count)
+	{
+		size_t word = static_cast<size_t>(bits / 64);
+		int offset = static_cast<int>(bits % 64);
+
+		int taken = std::min(count - read, 64 - offset);
+		uint64_t part = words[word] >> offset;
+		if (taken < 64) part &= (1ULL << taken) - 1;
+
+		value |= part << read;
+		bits += taken;
+		read += taken;
+	}
+
+	return value;
+}
+
+static void WriteValue(std::vector<uint64_t>& words, uint64_t& bits, int64_t value)
+{
+	uint64_t encoded = ZigZag(value);
+	if (encoded == 0)
+	{
+		WriteBits(words, bits, 0, 1);
+		return;
+	}
+
+	for (int size = 0; size < 4; size++)
+	{
+		if (VALUE_BITS[size] < 64 && encoded >= (1ULL << VALUE_BITS[size])) continue;
+
+		// size + 1 ones, then a zero unless it is the largest size
+		WriteBits(words, bits, (1ULL << (size + 1)) - 1, size + 1);
+		if (size < 3) WriteBits(words, bits, 0, 1);
+
+		WriteBits(words, bits, encoded, VALUE_BITS[size]);
+		return;
+	}
+}
+
+static int64_t ReadValue(const std::vector<uint64_t>& words, uint64_t& bits)
+{
+	int size = 0;
+	while (size < 4 && ReadBits(words, bits, 1) == 1)
+		size++;
+
+	if (size == 0) return 0;
+
+	return UnZigZag(ReadBits(words, bits, VALUE_BITS[size - 1]));
+}
+
+static void ToFields(const ArchivePoint& point, int64_t* fields)
+{
+	fields[0] = point.time;
+	fields[1] = point.latitude;
+	fields[2] = point.longitude;
+	fields[3] = point.altitude;
+}
+
+static ArchivePoint FromFields(const int64_t* fields)
+{
+	ArchivePoint point;
+	point.time = fields[0];
+	point.latitude = static_cast<int32_t>(fields[1]);
+	point.longitude = static_cast<int32_t>(fields[2]);
+	point.altitude = static_cast<int32_t>(fields[3]);
+	return point;
+}
+
+TrackArchive* TrackArchive::GetInstance()
+{
+	static TrackArchive archive;
+	return &archive;
+}
+
+void TrackArchive::Record(const RadarSample& sample)
+{
+	if (sample.callsign.empty()) return;
+
+	ArchivePoint point;
+	point.time = static_cast<int64_t>(sample.time);
+	point.latitude = static_cast<int32_t>(std::lround(sample.latitude * COORDINATE_SCALE));
+	point.longitude = static_cast<int32_t>(std::lround(sample.longitude * COORDINATE_SCALE));
+	point.altitude = sample.altitude;
+
+	std::lock_guard<std::mutex> guard(_lock);
+
+	std::vector<Block>& series = _series[sample.callsign];
+
+	if (!series.empty())
+	{
+		const Block& last = series.back();
+
+		// Flight plan updates send the radar target again, without it having moved
+		if (last.values[1] == point.latitude && last.values[2] == point.longitude && last.values[3] == point.altitude)
+			return;
+	}
+
+	if (series.empty() || series.back().count == BLOCK_POINTS)
+	{
+		if (!series.empty())
+		{
+			// A full block does not grow again
+			_bytes -= BlockBytes(series.back());
+			series.back().words.shrink_to_fit();
+			_bytes += BlockBytes(series.back());
+		}
+
+		series.push_back(Block());
+		_bytes += BlockBytes(series.back());
+	}
+
+	Block& block = series.back();
+	_bytes -= BlockBytes(block);
+	Append(block, point);
+	_bytes += BlockBytes(block);
+	_points++;
+}
+
+void TrackArchive::Append(Block& block, const ArchivePoint& point)
+{
+	int64_t fields[FIELDS];
+	ToFields(point, fields);
+
+	for (int i = 0; i < FIELDS; i++)
+	{
+		int64_t delta = fields[i] - block.values[i];
+		WriteValue(block.words, block.bits, delta - block.deltas[i]);
+
+		// The first point is written whole, so the second starts from no change
+		block.deltas[i] = block.count == 0 ? 0 : delta;
+		block.values[i] = fields[i];
+	}
+
+	if (block.count == 0) block.firstTime = point.time;
+	block.lastTime = point.time;
+	block.count++;
+}
+
+void TrackArchive::Decode(const Block& block, int64_t from, int64_t to, std::vector<ArchivePoint>& points)
+{
+	int64_t values[FIELDS] = {};
+	int64_t deltas[FIELDS] = {};
+	uint64_t bits = 0;
+
+	for (uint32_t n = 0; n < block.count; n++)
+	{
+		for (int i = 0; i < FIELDS; i++)
+		{
+			int64_t delta = deltas[i] + ReadValue(block.words, bits);
+			values[i] += delta;
+			deltas[i] = n == 0 ? 0 : delta;
+		}
+
+		if (values[0] >= from && values[0] <= to)
+			points.push_back(FromFields(values));
+	}
+}
+
+std::vector<ArchivePoint> TrackArchive::Query(const std::string& callsign, int64_t from, int64_t to, size_t maxPoints, bool* truncated)
+{
+	PROFILE_ZONE("TrackArchive.Query");
+	std::vector<ArchivePoint> points;
+
+	std::lock_guard<std::mutex> guard(_lock);
+
+	auto series = _series.find(callsign);
+	if (series == _series.end()) return points;
+
+	for (const Block& block : series->second)
+	{
+		if (block.lastTime < from || block.firstTime > to) continue;
+
+		// The blocks after this one are left encoded
+		if (points.size() >= maxPoints)
+		{
+			if (truncated) *truncated = true;
+			break;
+		}
+
+		Decode(block, from, to, points);
+	}
+
+	if (points.size() > maxPoints)
+	{
+		points.resize(maxPoints);
+		if (truncated) *truncated = true;
+	}
+
+	return points;
+}
+
+sio::message::ptr TrackArchive::ToMessage(const std::string& callsign, int64_t from, int64_t to, size_t maxPoints, bool& truncated)
+{
+	std::vector<ArchivePoint> points = Query(callsign, from, to, maxPoints, &truncated);
+	if (points.empty()) return nullptr;
+
+	sio::message::ptr latitudes = sio::array_message::create();
+	sio::message::ptr longitudes = sio::array_message::create();
+	sio::message::ptr altitudes = sio::array_message::create();
+	sio::message::ptr times = sio::array_message::create();
+
+	for (const ArchivePoint& point : points)
+	{
+		latitudes->get_vector().push_back(sio::double_message::create(point.latitude / COORDINATE_SCALE));
+		longitudes->get_vector().push_back(sio::double_message::create(point.longitude / COORDINATE_SCALE));
+		altitudes->get_vector().push_back(sio::int_message::create(point.altitude));
+		times->get_vector().push_back(sio::int_message::create(point.time));
+	}
+
+	sio::message::ptr msg = sio::object_message::create();
+	msg->get_map()["callsign"] = sio::string_message::create(callsign);
+	msg->get_map()["lat"] = latitudes;
+	msg->get_map()["lon"] = longitudes;
+	msg->get_map()["altitude"] = altitudes;
+	msg->get_map()["time"] = times;
+
+	return msg;
+}
+
+bool TrackArchive::Export(const std::string& path, int64_t from, int64_t to, size_t& exported)
+{
+	PROFILE_ZONE("TrackArchive.Export");
+
+	std::ofstream file(path, std::ios::trunc);
+	if (!file.is_open())
+	{
+		Metrics::CountException("TrackArchive", "EXCDS Error: Could not write the track archive");
+		return false;
+	}
+
+	file << "time,callsign,lat,lon,altitude\n";
+	file.precision(4);
+	file.setf(std::ios::fixed);
+
+	// Each target is decoded and written on its own, so the export does not hold the lock for the whole file
+	exported = 0;
+	for (const std::string& callsign : GetCallsigns())
+	{
+		for (const ArchivePoint& point : Query(callsign, from, to))
+		{
+			file << point.time << ',' << callsign << ','
+				<< point.latitude / COORDINATE_SCALE << ',' << point.longitude / COORDINATE_SCALE << ','
+				<< point.altitude << '\n';
+			exported++;
+		}
+	}
+
+	return true;
+}
+
+void TrackArchive::Trim()
+{
+	std::lock_guard<std::mutex> guard(_lock);
+
+	while (_bytes > MEMORY_BUDGET)
+	{
+		// The series whose first block is the oldest gives it up
+		auto oldest = _series.end();
+		for (auto series = _series.begin(); series != _series.end(); ++series)
+		{
+			if (series->second.empty()) continue;
+			if (oldest == _series.end() || series->second.front().firstTime < oldest->second.front().firstTime)
+				oldest = series;
+		}
+
+		if (oldest == _series.end()) return;
+
+		Metrics::GetInstance()->Counter("archive.dropped_blocks").Increment();
+
+		_bytes -= BlockBytes(oldest->second.front());
+		_points -= oldest->second.front().count;
+		oldest->second.erase(oldest->second.begin());
+
+		if (oldest->second.empty())
+			_series.erase(oldest);
+	}
+}
+
+std::vector<std::string> TrackArchive::GetCallsigns()
+{
+	std::lock_guard<std::mutex> guard(_lock);
+
+	std::vector<std::string> callsigns;
+	callsigns.reserve(_series.size());
+
+	for (const auto& series : _series)
+		callsigns.push_back(series.first);
+
+	return callsigns;
+}
+
+size_t TrackArchive::GetPointCount()
+{
+	std::lock_guard<std::mutex> guard(_lock);
+	return _points;
+}
+
+size_t TrackArchive::GetBytes()
+{
+	std::lock_guard<std::mutex> guard(_lock);
+	return _bytes;
+}
+
+size_t TrackArchive::BlockBytes(const Block& block)
+{
+	return sizeof(Block) + block.words.capacity() * sizeof(uint64_t);
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <sio_client.h>
+
+#include "RadarSample.h"
+
+/**
+* One archived point, with the coordinates as they are stored.
+*/
+struct ArchivePoint
+{
+    // Seconds since the epoch
+    int64_t time = 0;
+
+    // Ten thousandths of a degree, about 10 m
+    int32_t latitude = 0;
+    int32_t longitude = 0;
+
+    int32_t altitude = 0;
+};
+
+/**
+* Every radar target position of the session, compressed in memory so a whole event can be looked back on.
+*
+* Each target has a series of blocks of up to BLOCK_POINTS points. In a block, each field is stored as the change in
+* its change from the point before, which for a target on a steady track and sweep is 0 and takes one bit, and
+* otherwise as a zigzag number in 7, 12, 20 or 64 bits behind a short prefix. Coordinates are quantized first, so
+* whole numbers are compressed rather than the bits of doubles. Blocks know their first and last time, so a query
+* for a time range only decodes the blocks it needs. When the archive outgrows MEMORY_BUDGET the oldest blocks are
+* dropped.
+*/
+class TrackArchive
+{
+public:
+    static const size_t BLOCK_POINTS = 1024;
+    static const size_t MEMORY_BUDGET = 64 * 1024 * 1024;
+
+    static TrackArchive* GetInstance();
+
+    void Record(const RadarSample& sample);
+
+    /**
+    * The points of a target between two times, inclusive, oldest first. Decoding stops once maxPoints are found,
+    * and truncated is set if there may be more.
+    */
+    std::vector<ArchivePoint> Query(const std::string& callsign, int64_t from, int64_t to, size_t maxPoints = SIZE_MAX, bool* truncated = nullptr);
+
+    /**
+    * The same as a message, in the columns REQUEST_TRACK_HISTORY uses, with at most maxPoints of the oldest points.
+    * truncated is set if any were left out. Nothing if there are no points.
+    */
+    sio::message::ptr ToMessage(const std::string& callsign, int64_t from, int64_t to, size_t maxPoints, bool& truncated);
+
+    /**
+    * Writes the points between two times as CSV: time,callsign,lat,lon,altitude. False if the file cannot be written.
+    */
+    bool Export(const std::string& path, int64_t from, int64_t to, size_t& exported);
+
+    /**
+    * Drops the oldest blocks while the archive is over budget. Called once a second.
+    */
+    void Trim();
+
+    std::vector<std::string> GetCallsigns();
+    size_t GetPointCount();
+    size_t GetBytes();
+private:
+    static const int FIELDS = 4;
+
+    struct Block
+    {
+        int64_t firstTime = 0;
+        int64_t lastTime = 0;
+        uint32_t count = 0;
+
+        std::vector<uint64_t> words;
+        uint64_t bits = 0;
+
+        // The last value of each field, and its last change, to encode the next point against
+        int64_t values[FIELDS] = {};
+        int64_t deltas[FIELDS] = {};
+    };
+
+    std::mutex _lock;
+    std::unordered_map<std::string, std::vector<Block>> _series;
+    size_t _points = 0;
+    size_t _bytes = 0;
+
+    static void Append(Block& block, const ArchivePoint& point);
+    static void Decode(const Block& block, int64_t from, int64_t to, std::vector<ArchivePoint>& points);
+    static size_t BlockBytes(const Block& block);
+};
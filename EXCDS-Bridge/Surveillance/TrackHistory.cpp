@@ -0,0 +1,132 @@
+#include <algorithm>
+
+#include "TrackHistory.h"
+
+TrackHistory* TrackHistory::GetInstance()
+{
+	static TrackHistory history;
+	return &history;
+}
+
+void TrackHistory::Record(const RadarSample& sample)
+{
+	if (sample.callsign.empty()) return;
+
+	int64_t time = static_cast<int64_t>(sample.time * 1000);
+
+	std::lock_guard<std::mutex> guard(_lock);
+
+	auto slot = _slots.find(sample.callsign);
+	if (slot == _slots.end())
+		slot = _slots.emplace(sample.callsign, AllocateSlot()).first;
+
+	size_t base = slot->second * LENGTH;
+	uint32_t& head = _heads[slot->second];
+	uint32_t& count = _counts[slot->second];
+
+	// Flight plan updates send the radar target again, without it having moved
+	if (count > 0)
+	{
+		size_t newest = base + (head + LENGTH - 1) % LENGTH;
+		if (_latitudes[newest] == sample.latitude && _longitudes[newest] == sample.longitude && _altitudes[newest] == sample.altitude)
+			return;
+	}
+
+	_latitudes[base + head] = sample.latitude;
+	_longitudes[base + head] = sample.longitude;
+	_altitudes[base + head] = sample.altitude;
+	_times[base + head] = time;
+
+	head = (head + 1) % LENGTH;
+	count = std::min<uint32_t>(count + 1, LENGTH);
+}
+
+void TrackHistory::Remove(const std::string& callsign)
+{
+	std::lock_guard<std::mutex> guard(_lock);
+
+	auto slot = _slots.find(callsign);
+	if (slot == _slots.end()) return;
+
+	_heads[slot->second] = 0;
+	_counts[slot->second] = 0;
+	_freeSlots.push_back(slot->second);
+	_slots.erase(slot);
+}
+
+sio::message::ptr TrackHistory::ToMessage(const std::string& callsign, size_t count)
+{
+	sio::message::ptr latitudes = sio::array_message::create();
+	sio::message::ptr longitudes = sio::array_message::create();
+	sio::message::ptr altitudes = sio::array_message::create();
+	sio::message::ptr times = sio::array_message::create();
+
+	{
+		std::lock_guard<std::mutex> guard(_lock);
+
+		auto slot = _slots.find(callsign);
+		if (slot == _slots.end() || _counts[slot->second] == 0) return nullptr;
+
+		size_t base = slot->second * LENGTH;
+		size_t points = std::min<size_t>(count, _counts[slot->second]);
+		size_t oldest = (_heads[slot->second] + LENGTH - points) % LENGTH;
+
+		for (size_t i = 0; i < points; i++)
+			latitudes->get_vector().push_back(sio::double_message::create(_latitudes[base + (oldest + i) % LENGTH]));
+		for (size_t i = 0; i < points; i++)
+			longitudes->get_vector().push_back(sio::double_message::create(_longitudes[base + (oldest + i) % LENGTH]));
+		for (size_t i = 0; i < points; i++)
+			altitudes->get_vector().push_back(sio::int_message::create(_altitudes[base + (oldest + i) % LENGTH]));
+		for (size_t i = 0; i < points; i++)
+			times->get_vector().push_back(sio::int_message::create(_times[base + (oldest + i) % LENGTH]));
+	}
+
+	sio::message::ptr msg = sio::object_message::create();
+	msg->get_map()["callsign"] = sio::string_message::create(callsign);
+	msg->get_map()["lat"] = latitudes;
+	msg->get_map()["lon"] = longitudes;
+	msg->get_map()["altitude"] = altitudes;
+	msg->get_map()["time"] = times;
+
+	return msg;
+}
+
+std::vector<std::string> TrackHistory::GetCallsigns()
+{
+	std::lock_guard<std::mutex> guard(_lock);
+
+	std::vector<std::string> callsigns;
+	callsigns.reserve(_slots.size());
+
+	for (const auto& slot : _slots)
+		callsigns.push_back(slot.first);
+
+	return callsigns;
+}
+
+size_t TrackHistory::GetSize()
+{
+	std::lock_guard<std::mutex> guard(_lock);
+	return _slots.size();
+}
+
+size_t TrackHistory::AllocateSlot()
+{
+	if (!_freeSlots.empty())
+	{
+		size_t slot = _freeSlots.back();
+		_freeSlots.pop_back();
+		return slot;
+	}
+
+	size_t slot = _heads.size();
+	_heads.push_back(0);
+	_counts.push_back(0);
+
+	_latitudes.resize(_latitudes.size() + LENGTH);
+	_longitudes.resize(_longitudes.size() + LENGTH);
+	_altitudes.resize(_altitudes.size() + LENGTH);
+	_times.resize(_times.size() + LENGTH);
+
+	return slot;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <sio_client.h>
+
+#include "RadarSample.h"
+
+/**
+* The last LENGTH positions of every radar target, for history dots and trails. A client that connects gets the
+* trails with REQUEST_TRACK_HISTORY instead of building them up again from SEND_RT_DATA.
+*
+* Each target has a slot: a ring of LENGTH points in each of the coordinate, altitude and time arrays. The arrays are
+* kept apart so a trail is copied out a column at a time, and slots of targets that have gone are given to new ones.
+*/
+class TrackHistory
+{
+public:
+    static const size_t LENGTH = 64;
+
+    static TrackHistory* GetInstance();
+
+    void Record(const RadarSample& sample);
+    void Remove(const std::string& callsign);
+
+    /**
+    * The newest `count` points of a target, oldest first, as
+    *   { "callsign": "AAL123", "lat": [...], "lon": [...], "altitude": [...], "time": [...] }
+    * with times in milliseconds since the epoch. Nothing if the target has no history.
+    */
+    sio::message::ptr ToMessage(const std::string& callsign, size_t count);
+
+    std::vector<std::string> GetCallsigns();
+    size_t GetSize();
+private:
+    std::mutex _lock;
+    std::unordered_map<std::string, size_t> _slots;
+    std::vector<size_t> _freeSlots;
+
+    // LENGTH entries per slot
+    std::vector<double> _latitudes;
+    std::vector<double> _longitudes;
+    std::vector<int32_t> _altitudes;
+    std::vector<int64_t> _times;
+
+    // One entry per slot: where the next point goes, and how many there are
+    std::vector<uint32_t> _heads;
+    std::vector<uint32_t> _counts;
+
+    size_t AllocateSlot();
+};
@@ -0,0 +1,214 @@
+#include <algorithm>
+
+#include "TrafficIndex.h"
+#include "../ApiHelper.h"
+#include "../Diagnostics/Profiler.h"
+
+static void AddKey(std::unordered_map<std::string, std::unordered_set<std::string>>& index, const std::string& key, const std::string& callsign)
+{
+	if (!key.empty())
+		index[key].insert(callsign);
+}
+
+static void RemoveKey(std::unordered_map<std::string, std::unordered_set<std::string>>& index, const std::string& key, const std::string& callsign)
+{
+	auto entry = index.find(key);
+	if (entry == index.end()) return;
+
+	entry->second.erase(callsign);
+	if (entry->second.empty())
+		index.erase(entry);
+}
+
+TrafficIndex* TrafficIndex::GetInstance()
+{
+	static TrafficIndex index;
+	return &index;
+}
+
+void TrafficIndex::Update(const sio::message::ptr& flightPlanData)
+{
+	PROFILE_ZONE("TrafficIndex.Update");
+
+	std::string callsign = ApiHelper::GetString(flightPlanData, { "callsign" });
+	if (callsign.empty()) return;
+
+	TrafficRecord record;
+	record.origin = ApiHelper::GetString(flightPlanData, { "route", "departure", "code" });
+	record.destination = ApiHelper::GetString(flightPlanData, { "route", "destination", "code" });
+	record.trackingController = ApiHelper::GetString(flightPlanData, { "controllerData", "tracking_controller" });
+	record.groundStatus = ApiHelper::GetString(flightPlanData, { "controllerData", "ground_status" });
+	record.squawk = ApiHelper::GetString(flightPlanData, { "controllerData", "squawk" });
+	record.flightPlanData = flightPlanData;
+
+	auto route = flightPlanData->get_map().find("route");
+	if (route != flightPlanData->get_map().end() && route->second->get_flag() == sio::message::flag_object)
+	{
+		auto sectorEntry = route->second->get_map().find("sector_entry_time");
+		if (sectorEntry != route->second->get_map().end() && sectorEntry->second->get_flag() == sio::message::flag_integer)
+			record.sectorEntry = static_cast<int>(sectorEntry->second->get_int());
+	}
+
+	std::lock_guard<std::mutex> guard(_lock);
+
+	auto existing = _records.find(callsign);
+	if (existing != _records.end())
+	{
+		Unindex(callsign, existing->second);
+		existing->second = record;
+	}
+	else
+	{
+		_records[callsign] = record;
+	}
+
+	Index(callsign, record);
+}
+
+void TrafficIndex::Remove(const std::string& callsign)
+{
+	std::lock_guard<std::mutex> guard(_lock);
+
+	auto existing = _records.find(callsign);
+	if (existing == _records.end()) return;
+
+	Unindex(callsign, existing->second);
+	_records.erase(existing);
+}
+
+std::vector<std::string> TrafficIndex::Query(const TrafficFilter& filter)
+{
+	PROFILE_ZONE("TrafficIndex.Query");
+
+	std::lock_guard<std::mutex> guard(_lock);
+
+	// Start from the smallest index the filter uses, and check the rest of the filter against each record
+	const std::unordered_set<std::string>* candidates = nullptr;
+	std::unordered_set<std::string> groundStatusCandidates;
+	bool narrowed = false;
+
+	auto narrow = [&](KeyIndex& index, const std::string& key)
+	{
+		if (key.empty()) return;
+
+		static const std::unordered_set<std::string> none;
+		auto entry = index.find(key);
+		const std::unordered_set<std::string>* matches = entry == index.end() ? &none : &entry->second;
+
+		if (!narrowed || matches->size() < candidates->size())
+			candidates = matches;
+		narrowed = true;
+	};
+
+	narrow(_byOrigin, filter.origin);
+	narrow(_byDestination, filter.destination);
+	narrow(_byTrackingController, filter.trackingController);
+	narrow(_bySquawk, filter.squawk);
+
+	if (!filter.groundStatuses.empty())
+	{
+		for (const std::string& status : filter.groundStatuses)
+		{
+			auto entry = _byGroundStatus.find(status);
+			if (entry != _byGroundStatus.end())
+				groundStatusCandidates.insert(entry->second.begin(), entry->second.end());
+		}
+
+		if (!narrowed || groundStatusCandidates.size() < candidates->size())
+			candidates = &groundStatusCandidates;
+		narrowed = true;
+	}
+
+	std::vector<std::string> callsigns;
+
+	if (narrowed)
+	{
+		for (const std::string& callsign : *candidates)
+		{
+			if (Matches(_records[callsign], filter))
+				callsigns.push_back(callsign);
+		}
+	}
+	else
+	{
+		bool ranged = filter.sectorEntryMin != INT_MIN || filter.sectorEntryMax != INT_MAX;
+
+		if (ranged)
+		{
+			auto end = _bySectorEntry.upper_bound(filter.sectorEntryMax);
+			for (auto entry = _bySectorEntry.lower_bound(filter.sectorEntryMin); entry != end; ++entry)
+				callsigns.push_back(entry->second);
+		}
+		else
+		{
+			for (const auto& record : _records)
+				callsigns.push_back(record.first);
+		}
+	}
+
+	std::sort(callsigns.begin(), callsigns.end());
+	return callsigns;
+}
+
+sio::message::ptr TrafficIndex::GetFlightPlanData(const std::string& callsign)
+{
+	std::lock_guard<std::mutex> guard(_lock);
+
+	auto existing = _records.find(callsign);
+	return existing == _records.end() ? nullptr : existing->second.flightPlanData;
+}
+
+size_t TrafficIndex::GetSize()
+{
+	std::lock_guard<std::mutex> guard(_lock);
+	return _records.size();
+}
+
+void TrafficIndex::Unindex(const std::string& callsign, const TrafficRecord& record)
+{
+	RemoveKey(_byOrigin, record.origin, callsign);
+	RemoveKey(_byDestination, record.destination, callsign);
+	RemoveKey(_byTrackingController, record.trackingController, callsign);
+	RemoveKey(_byGroundStatus, record.groundStatus, callsign);
+	RemoveKey(_bySquawk, record.squawk, callsign);
+
+	auto range = _bySectorEntry.equal_range(record.sectorEntry);
+	for (auto entry = range.first; entry != range.second; ++entry)
+	{
+		if (entry->second == callsign)
+		{
+			_bySectorEntry.erase(entry);
+			break;
+		}
+	}
+}
+
+void TrafficIndex::Index(const std::string& callsign, const TrafficRecord& record)
+{
+	AddKey(_byOrigin, record.origin, callsign);
+	AddKey(_byDestination, record.destination, callsign);
+	AddKey(_byTrackingController, record.trackingController, callsign);
+	AddKey(_byGroundStatus, record.groundStatus, callsign);
+	AddKey(_bySquawk, record.squawk, callsign);
+
+	// Aircraft without a route have no sector entry time, and only turn up in a query without a range
+	if (record.sectorEntry != INT_MIN)
+		_bySectorEntry.insert(std::make_pair(record.sectorEntry, callsign));
+}
+
+bool TrafficIndex::Matches(const TrafficRecord& record, const TrafficFilter& filter)
+{
+	if (!filter.origin.empty() && record.origin != filter.origin) return false;
+	if (!filter.destination.empty() && record.destination != filter.destination) return false;
+	if (!filter.trackingController.empty() && record.trackingController != filter.trackingController) return false;
+	if (!filter.squawk.empty() && record.squawk != filter.squawk) return false;
+	if (!filter.groundStatuses.empty() && filter.groundStatuses.count(record.groundStatus) == 0) return false;
+
+	if (filter.sectorEntryMin != INT_MIN || filter.sectorEntryMax != INT_MAX)
+	{
+		if (record.sectorEntry == INT_MIN) return false;
+		if (record.sectorEntry < filter.sectorEntryMin || record.sectorEntry > filter.sectorEntryMax) return false;
+	}
+
+	return true;
+}
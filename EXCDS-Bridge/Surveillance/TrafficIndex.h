@@ -0,0 +1,84 @@
+#pragma once
+
+#include <climits>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <sio_client.h>
+
+/**
+* What QUERY_FP asks for. Empty strings and sets, and the widest sector entry range, match everything.
+*/
+struct TrafficFilter
+{
+    std::string origin;
+    std::string destination;
+    std::string trackingController;
+    std::set<std::string> groundStatuses;
+    std::string squawk;
+    int sectorEntryMin = INT_MIN;
+    int sectorEntryMax = INT_MAX;
+};
+
+/**
+* The latest flight plan data sent to EXCDS for each aircraft, indexed by origin, destination, tracking controller,
+* ground status, squawk and sector entry time.
+*
+* The index is fed the same messages that are sent as SEND_FP_DATA, so a query sees what EXCDS has been told. Each
+* update only moves the aircraft between the index entries that changed.
+*/
+class TrafficIndex
+{
+public:
+    static TrafficIndex* GetInstance();
+
+    /**
+    * Indexes a message made by MessageHandler::PrepareFlightPlanDataResponse.
+    */
+    void Update(const sio::message::ptr& flightPlanData);
+    void Remove(const std::string& callsign);
+
+    /**
+    * Callsigns matching the filter, in callsign order.
+    */
+    std::vector<std::string> Query(const TrafficFilter& filter);
+
+    /**
+    * The message last indexed for the aircraft, or nullptr.
+    */
+    sio::message::ptr GetFlightPlanData(const std::string& callsign);
+
+    size_t GetSize();
+private:
+    struct TrafficRecord
+    {
+        std::string origin;
+        std::string destination;
+        std::string trackingController;
+        std::string groundStatus;
+        std::string squawk;
+        int sectorEntry = INT_MIN;
+        sio::message::ptr flightPlanData;
+    };
+
+    typedef std::unordered_map<std::string, std::unordered_set<std::string>> KeyIndex;
+
+    std::mutex _lock;
+    std::unordered_map<std::string, TrafficRecord> _records;
+
+    KeyIndex _byOrigin;
+    KeyIndex _byDestination;
+    KeyIndex _byTrackingController;
+    KeyIndex _byGroundStatus;
+    KeyIndex _bySquawk;
+    std::multimap<int, std::string> _bySectorEntry;
+
+    void Unindex(const std::string& callsign, const TrafficRecord& record);
+    void Index(const std::string& callsign, const TrafficRecord& record);
+
+    static bool Matches(const TrafficRecord& record, const TrafficFilter& filter);
+};